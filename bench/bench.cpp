@@ -0,0 +1,655 @@
+///
+/// @file   bench.cpp
+/// @brief  End-to-end benchmarks of libprimesieve. Each benchmark
+///         is run multiple times, the results (best, median and
+///         mean time) are written to a JSON file together with
+///         information about the host. Two result files can be
+///         compared to find performance regressions.
+///
+///         Usage:
+///         primesieve_bench [--output=FILE] [--repeat=N]
+///                          [--threads=N] [--filter=NAME]
+///         primesieve_bench --compare OLD.json NEW.json
+///                          [--threshold=PERCENT]
+///         primesieve_bench --scaling [--threads=N]
+///                          [--imbalance=PERCENT]
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/CpuInfo.hpp>
+#include <primesieve/ParallelSieve.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+  #include <unistd.h>
+#endif
+
+using namespace std;
+using namespace primesieve;
+
+namespace {
+
+struct Benchmark
+{
+  string name;
+  function<uint64_t()> run;
+};
+
+struct Result
+{
+  string name;
+  uint64_t result;
+  double min;
+  double median;
+  double mean;
+};
+
+struct Options
+{
+  string output = "bench.json";
+  string filter;
+  string compareOld;
+  string compareNew;
+  double threshold = 5;
+  double imbalance = 10;
+  int repeat = 3;
+  int threads = 0;
+  bool scaling = false;
+};
+
+struct ScalingWindow
+{
+  string name;
+  uint64_t start;
+  uint64_t stop;
+  int flags;
+};
+
+/// Discards all output, used to benchmark printing
+/// without measuring the speed of the terminal.
+///
+class NullBuffer : public streambuf
+{
+protected:
+  int overflow(int c) override { return c; }
+  streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+uint64_t ipow10(int n)
+{
+  uint64_t x = 1;
+  for (int i = 0; i < n; i++)
+    x *= 10;
+  return x;
+}
+
+vector<Benchmark> getBenchmarks()
+{
+  vector<Benchmark> benchmarks;
+
+  // Count the primes inside [10^i, 10^i + 10^9]
+  for (int i = 9; i <= 19; i += 2)
+  {
+    uint64_t start = ipow10(i);
+    benchmarks.push_back({ "count_primes(1e" + to_string(i) + ", +1e9)",
+                           [=]() { return count_primes(start, start + ipow10(9)); } });
+  }
+
+  benchmarks.push_back({ "count_twins(1e12, +1e9)",
+                         []() { return count_twins(ipow10(12), ipow10(12) + ipow10(9)); } });
+
+  benchmarks.push_back({ "count_sextuplets(1e12, +1e9)",
+                         []() { return count_sextuplets(ipow10(12), ipow10(12) + ipow10(9)); } });
+
+  benchmarks.push_back({ "iterator::next_prime(0, 1e9)", []()
+  {
+    primesieve::iterator it;
+    uint64_t sum = 0;
+    for (uint64_t prime = it.next_prime(); prime <= ipow10(9); prime = it.next_prime())
+      sum += prime;
+    return sum;
+  }});
+
+  benchmarks.push_back({ "iterator::prev_prime(1e9, 0)", []()
+  {
+    primesieve::iterator it(ipow10(9));
+    uint64_t sum = 0;
+    for (uint64_t prime = it.prev_prime(); prime > 0; prime = it.prev_prime())
+      sum += prime;
+    return sum;
+  }});
+
+  // primes_range and segments() vs. next_prime(), the
+  // primes are summed the same way as above.
+  benchmarks.push_back({ "iterator::next_primes(0, 1e9)", []()
+  {
+    primesieve::iterator it;
+    uint64_t sum = 0;
+    size_t size;
+    for (bool done = false; !done;)
+    {
+      const uint64_t* primes = it.next_primes(&size);
+      for (size_t i = 0; i < size; i++)
+      {
+        if (primes[i] > ipow10(9))
+        {
+          done = true;
+          break;
+        }
+        sum += primes[i];
+      }
+    }
+    return sum;
+  }});
+
+  benchmarks.push_back({ "primes_range(0, 1e9)", []()
+  {
+    uint64_t sum = 0;
+    for (uint64_t prime : primesieve::primes(0, ipow10(9)))
+      sum += prime;
+    return sum;
+  }});
+
+#if defined(PRIMESIEVE_COROUTINES)
+  benchmarks.push_back({ "segments(0, 1e9)", []()
+  {
+    uint64_t sum = 0;
+    for (auto segment : primesieve::segments(0, ipow10(9)))
+      for (uint64_t prime : segment)
+        sum += prime;
+    return sum;
+  }});
+#endif
+
+  benchmarks.push_back({ "nth_prime(1e8)",
+                         []() { return nth_prime(ipow10(8)); } });
+
+  benchmarks.push_back({ "nth_prime(1e7, 1e15)",
+                         []() { return nth_prime(ipow10(7), ipow10(15)); } });
+
+  benchmarks.push_back({ "generate_primes(1e12, +1e8)", []()
+  {
+    vector<uint64_t> primes;
+    generate_primes(ipow10(12), ipow10(12) + ipow10(8), &primes);
+    return (uint64_t) primes.size();
+  }});
+
+  benchmarks.push_back({ "print_primes(1e12, +1e8)", []()
+  {
+    NullBuffer null;
+    streambuf* old = cout.rdbuf(&null);
+    print_primes(ipow10(12), ipow10(12) + ipow10(8));
+    cout.rdbuf(old);
+    return (uint64_t) 0;
+  }});
+
+  return benchmarks;
+}
+
+Result runBenchmark(const Benchmark& benchmark, int repeat)
+{
+  Result res;
+  res.name = benchmark.name;
+  vector<double> seconds;
+
+  for (int i = 0; i < repeat; i++)
+  {
+    auto t1 = chrono::steady_clock::now();
+    res.result = benchmark.run();
+    auto t2 = chrono::steady_clock::now();
+    chrono::duration<double> sec = t2 - t1;
+    seconds.push_back(sec.count());
+  }
+
+  sort(seconds.begin(), seconds.end());
+  res.min = seconds.front();
+  res.median = seconds[seconds.size() / 2];
+  if (seconds.size() % 2 == 0)
+    res.median = (res.median + seconds[seconds.size() / 2 - 1]) / 2;
+
+  res.mean = 0;
+  for (double sec : seconds)
+    res.mean += sec;
+  res.mean /= seconds.size();
+
+  return res;
+}
+
+string getHostName()
+{
+#if !defined(_WIN32)
+  char name[256];
+  if (gethostname(name, sizeof(name)) == 0)
+  {
+    name[sizeof(name) - 1] = 0;
+    return name;
+  }
+#endif
+  return "unknown";
+}
+
+string getDate()
+{
+  time_t now = time(nullptr);
+  char date[32];
+  strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+  return date;
+}
+
+string getCompiler()
+{
+#if defined(__clang__)
+  return "clang " __clang_version__;
+#elif defined(__GNUC__)
+  return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+  return "msvc " + to_string(_MSC_VER);
+#else
+  return "unknown";
+#endif
+}
+
+string escape(const string& str)
+{
+  string res;
+  for (char c : str)
+  {
+    if (c == '"' || c == '\\')
+      res += '\\';
+    if ((unsigned char) c >= 0x20)
+      res += c;
+  }
+  return res;
+}
+
+/// Each benchmark result is written on a separate line,
+/// compare() relies on this format.
+///
+void writeJson(ostream& out, const Options& opts, const vector<Result>& results)
+{
+  out << "{\n";
+  out << "  \"host\": {\n";
+  out << "    \"hostname\": \"" << escape(getHostName()) << "\",\n";
+  out << "    \"date\": \"" << getDate() << "\",\n";
+  out << "    \"primesieve_version\": \"" << primesieve_version() << "\",\n";
+  out << "    \"compiler\": \"" << escape(getCompiler()) << "\",\n";
+  out << "    \"cpu_name\": \"" << escape(cpuInfo.cpuName()) << "\",\n";
+  out << "    \"cpu_cores\": " << cpuInfo.cpuCores() << ",\n";
+  out << "    \"cpu_threads\": " << cpuInfo.cpuThreads() << ",\n";
+  out << "    \"l1_cache_size\": " << cpuInfo.l1CacheSize() << ",\n";
+  out << "    \"l2_cache_size\": " << cpuInfo.l2CacheSize() << ",\n";
+  out << "    \"l3_cache_size\": " << cpuInfo.l3CacheSize() << ",\n";
+  out << "    \"sieve_size\": " << get_sieve_size() << ",\n";
+  out << "    \"threads\": " << get_num_threads() << ",\n";
+  out << "    \"repeat\": " << opts.repeat << "\n";
+  out << "  },\n";
+  out << "  \"benchmarks\": [\n";
+
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    auto& r = results[i];
+    out << "    { \"name\": \"" << escape(r.name) << "\", "
+        << "\"result\": " << r.result << ", "
+        << setprecision(6) << fixed
+        << "\"min\": " << r.min << ", "
+        << "\"median\": " << r.median << ", "
+        << "\"mean\": " << r.mean << " }"
+        << ((i + 1 < results.size()) ? ",\n" : "\n");
+  }
+
+  out << "  ]\n";
+  out << "}\n";
+}
+
+/// Read the value of "key": ... from a line
+/// written by writeJson().
+///
+bool readValue(const string& line, const string& key, string& value)
+{
+  string pattern = "\"" + key + "\": ";
+  size_t pos = line.find(pattern);
+  if (pos == string::npos)
+    return false;
+
+  pos += pattern.size();
+  if (line[pos] == '"')
+  {
+    size_t end = pos + 1;
+    for (; end < line.size() && line[end] != '"'; end++)
+      if (line[end] == '\\')
+        end++;
+    value = line.substr(pos + 1, end - pos - 1);
+  }
+  else
+  {
+    size_t end = line.find_first_of(",}", pos);
+    value = line.substr(pos, end - pos);
+  }
+
+  return true;
+}
+
+/// Best time of each benchmark
+vector<pair<string, double>> readResults(const string& filename)
+{
+  ifstream file(filename);
+  if (!file)
+    throw runtime_error("failed to open " + filename);
+
+  vector<pair<string, double>> results;
+  string line;
+
+  while (getline(file, line))
+  {
+    string name, min;
+    if (readValue(line, "name", name) &&
+        readValue(line, "min", min))
+      results.emplace_back(name, stod(min));
+  }
+
+  return results;
+}
+
+/// Compare the best time of each benchmark, a benchmark
+/// regressed if it is more than threshold percent slower.
+/// @return Number of regressions
+///
+int compare(const Options& opts)
+{
+  auto oldVector = readResults(opts.compareOld);
+  auto newResults = readResults(opts.compareNew);
+  map<string, double> oldResults(oldVector.begin(), oldVector.end());
+  int regressions = 0;
+
+  cout << left << setw(36) << "Benchmark"
+       << right << setw(12) << "Old (sec)"
+       << setw(12) << "New (sec)"
+       << setw(10) << "Change" << endl;
+
+  for (auto& r : newResults)
+  {
+    auto iter = oldResults.find(r.first);
+    if (iter == oldResults.end())
+      continue;
+
+    double oldSec = iter->second;
+    double newSec = r.second;
+    double change = 0;
+    if (oldSec > 0)
+      change = (newSec - oldSec) * 100 / oldSec;
+
+    bool isRegression = change > opts.threshold;
+    regressions += isRegression;
+
+    cout << left << setw(36) << r.first << right << fixed
+         << setprecision(3) << setw(12) << oldSec
+         << setw(12) << newSec
+         << setprecision(1) << setw(9) << showpos << change << "%"
+         << noshowpos << (isRegression ? "  REGRESSION" : "") << endl;
+  }
+
+  cout << endl;
+  cout << "Regressions (> " << opts.threshold << "%): " << regressions << endl;
+
+  return regressions;
+}
+
+vector<ScalingWindow> getScalingWindows()
+{
+  vector<ScalingWindow> windows;
+  vector<pair<string, int>> flags =
+  {
+    { "count_primes", COUNT_PRIMES },
+    { "count_twins", COUNT_TWINS }
+  };
+
+  for (int i : { 10, 14, 19 })
+  {
+    for (auto& f : flags)
+    {
+      uint64_t start = ipow10(i);
+      uint64_t stop = start + ipow10(10);
+      windows.push_back({ f.first + "(1e" + to_string(i) + ", +1e10)", start, stop, f.second });
+    }
+  }
+
+  return windows;
+}
+
+/// Sieve the window using the given number of threads, the
+/// fastest of repeat runs (and its thread statistics) is kept.
+///
+double runScaling(const ScalingWindow& window,
+                  int threads,
+                  int repeat,
+                  uint64_t& count,
+                  vector<ParallelSieve::ThreadStats>& threadStats)
+{
+  double best = 0;
+
+  for (int i = 0; i < repeat; i++)
+  {
+    ParallelSieve ps;
+    ps.setSieveSize(get_sieve_size());
+    ps.setNumThreads(threads);
+    ps.setFlags(window.flags);
+
+    auto t1 = chrono::steady_clock::now();
+    ps.sieve(window.start, window.stop);
+    auto t2 = chrono::steady_clock::now();
+    chrono::duration<double> sec = t2 - t1;
+
+    if (i == 0 || sec.count() < best)
+    {
+      best = sec.count();
+      count = ps.getCount(0) + ps.getCount(1);
+      threadStats = ps.getThreadStats();
+    }
+  }
+
+  return best;
+}
+
+/// Sweep the number of threads 1, 2, 4, ... and report the
+/// speedup, parallel efficiency and the busy time, idle time
+/// and number of chunks of each thread. The tail imbalance
+/// is the time between the first and the last thread
+/// finishing relative to the total time, i.e. the
+/// fraction of the run during which some threads idle.
+/// @return Scaling results in bench.json format
+///
+vector<Result> scaling(const Options& opts)
+{
+  vector<Result> results;
+  int maxThreads = ParallelSieve::getMaxThreads();
+  if (opts.threads)
+    maxThreads = min(maxThreads, opts.threads);
+
+  vector<int> sweep;
+  for (int t = 1; t < maxThreads; t *= 2)
+    sweep.push_back(t);
+  sweep.push_back(maxThreads);
+
+  // The counts cache would make repeated runs faster
+  set_counts_cache(0);
+
+  for (auto& window : getScalingWindows())
+  {
+    if (window.name.find(opts.filter) == string::npos)
+      continue;
+
+    cout << window.name << endl;
+    cout << right << setw(8) << "Threads"
+         << setw(10) << "Seconds"
+         << setw(10) << "Speedup"
+         << setw(12) << "Efficiency"
+         << setw(8) << "Tail" << endl;
+
+    double baseline = 0;
+
+    for (int threads : sweep)
+    {
+      uint64_t count = 0;
+      vector<ParallelSieve::ThreadStats> threadStats;
+      double seconds = runScaling(window, threads, opts.repeat, count, threadStats);
+      if (threads == 1)
+        baseline = seconds;
+
+      double speedup = (seconds > 0) ? baseline / seconds : 0;
+      double efficiency = speedup * 100 / threads;
+      double firstFinish = seconds;
+      double lastFinish = 0;
+
+      for (auto& ts : threadStats)
+      {
+        firstFinish = min(firstFinish, ts.finishSeconds);
+        lastFinish = max(lastFinish, ts.finishSeconds);
+      }
+
+      double tail = 0;
+      if (seconds > 0 && !threadStats.empty())
+        tail = (lastFinish - firstFinish) * 100 / seconds;
+
+      cout << setw(8) << threads << fixed
+           << setprecision(3) << setw(10) << seconds
+           << setprecision(2) << setw(10) << speedup
+           << setprecision(1) << setw(11) << efficiency << "%"
+           << setw(7) << tail << "%"
+           << ((tail > opts.imbalance) ? "  IMBALANCE" : "") << endl;
+
+      for (size_t t = 0; t < threadStats.size(); t++)
+      {
+        auto& ts = threadStats[t];
+        double idle = max(0.0, seconds - ts.busySeconds);
+        cout << "          thread " << left << setw(4) << t << right
+             << " chunks: " << setw(5) << ts.chunks
+             << setprecision(3)
+             << ", busy: " << setw(7) << ts.busySeconds << " sec"
+             << ", idle: " << setw(7) << idle << " sec" << endl;
+      }
+
+      Result res;
+      res.name = window.name + " threads=" + to_string(threads);
+      res.result = count;
+      res.min = seconds;
+      res.median = seconds;
+      res.mean = seconds;
+      results.push_back(res);
+    }
+
+    cout << endl;
+  }
+
+  return results;
+}
+
+string getValue(const string& arg)
+{
+  size_t pos = arg.find('=');
+  if (pos == string::npos)
+    throw runtime_error("missing value: " + arg);
+  return arg.substr(pos + 1);
+}
+
+Options parseOptions(int argc, char* argv[])
+{
+  Options opts;
+
+  for (int i = 1; i < argc; i++)
+  {
+    string arg = argv[i];
+
+    if (arg.find("--output=") == 0)
+      opts.output = getValue(arg);
+    else if (arg.find("--filter=") == 0)
+      opts.filter = getValue(arg);
+    else if (arg.find("--repeat=") == 0)
+      opts.repeat = max(1, stoi(getValue(arg)));
+    else if (arg.find("--threads=") == 0)
+      opts.threads = stoi(getValue(arg));
+    else if (arg.find("--threshold=") == 0)
+      opts.threshold = stod(getValue(arg));
+    else if (arg.find("--imbalance=") == 0)
+      opts.imbalance = stod(getValue(arg));
+    else if (arg == "--scaling")
+      opts.scaling = true;
+    else if (arg == "--compare" && i + 2 < argc)
+    {
+      opts.compareOld = argv[++i];
+      opts.compareNew = argv[++i];
+    }
+    else
+      throw runtime_error("invalid option: " + arg);
+  }
+
+  return opts;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    Options opts = parseOptions(argc, argv);
+
+    if (!opts.compareOld.empty())
+      return (compare(opts) > 0) ? 1 : 0;
+
+    vector<Result> results;
+
+    if (opts.scaling)
+      results = scaling(opts);
+    else
+    {
+      if (opts.threads)
+        set_num_threads(opts.threads);
+
+      for (auto& benchmark : getBenchmarks())
+      {
+        if (benchmark.name.find(opts.filter) == string::npos)
+          continue;
+
+        cout << left << setw(36) << benchmark.name << flush;
+        Result res = runBenchmark(benchmark, opts.repeat);
+        results.push_back(res);
+        cout << right << fixed << setprecision(3)
+             << setw(10) << res.min << " sec" << endl;
+      }
+    }
+
+    ofstream file(opts.output);
+    if (!file)
+      throw runtime_error("failed to create " + opts.output);
+
+    writeJson(file, opts, results);
+    cout << endl;
+    cout << "Results: " << opts.output << endl;
+  }
+  catch (exception& e)
+  {
+    cerr << "primesieve_bench: " << e.what() << endl;
+    return 1;
+  }
+
+  return 0;
+}
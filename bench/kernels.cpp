@@ -0,0 +1,430 @@
+///
+/// @file   kernels.cpp
+/// @brief  Microbenchmarks of the sieving kernels: EratSmall,
+///         EratMedium and EratBig crossOff(), PreSieve::copy()
+///         and popcount(). Each kernel is initialized with a
+///         synthetic set of sieving primes (a prime range and
+///         a density i.e. the fraction of its primes that are
+///         used) and then sieves consecutive segments of the
+///         given sieve size. The number of crossed-off multiples
+///         is calculated exactly, hence we can report the time
+///         per crossed-off multiple.
+///
+///         The kernels are compiled into this program from the
+///         library sources, see bench/CMakeLists.txt for how to
+///         build variants with different compiler flags.
+///
+///         Usage:
+///         primesieve_kernels [--output=FILE] [--repeat=N]
+///                            [--bytes=N] [--filter=NAME]
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/config.hpp>
+#include <primesieve/EratBig.hpp>
+#include <primesieve/EratMedium.hpp>
+#include <primesieve/EratSmall.hpp>
+#include <primesieve/pmath.hpp>
+#include <primesieve/PreSieve.hpp>
+#include <primesieve/types.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if !defined(KERNEL_BENCH_VARIANT)
+  #define KERNEL_BENCH_VARIANT "default"
+#endif
+
+using namespace std;
+using namespace primesieve;
+
+namespace {
+
+/// Start of the first segment, large enough so that
+/// all sieving primes are used in all segments.
+///
+const uint64_t SEGMENT_LOW = (uint64_t) 1e15;
+
+struct Options
+{
+  string output;
+  string filter;
+  uint64_t bytes = 1 << 24;
+  int repeat = 3;
+};
+
+struct Kernel
+{
+  string name;
+  /// Sieve size in bytes
+  uint64_t sieveSize;
+  /// Number of sieving primes
+  uint64_t primes;
+  /// Sieves the segments, returns the number of crossed-off
+  /// multiples. Only the segment passes are timed, not
+  /// the initialization of the kernel.
+  function<uint64_t(byte_t* sieve, uint64_t segments, double* seconds)> run;
+};
+
+/// Stores the elapsed seconds in stop()
+/// or in its destructor.
+///
+class Timer
+{
+public:
+  Timer(double* seconds) :
+    seconds_(seconds),
+    start_(chrono::steady_clock::now())
+  { }
+  ~Timer() { stop(); }
+  void stop()
+  {
+    if (!seconds_)
+      return;
+    chrono::duration<double> sec = chrono::steady_clock::now() - start_;
+    *seconds_ = sec.count();
+    seconds_ = nullptr;
+  }
+private:
+  double* seconds_;
+  chrono::steady_clock::time_point start_;
+};
+
+struct Result
+{
+  string name;
+  uint64_t bytes;
+  uint64_t crossOffs;
+  double seconds;
+};
+
+/// Number of integers in [1, n] coprime to the wheel
+/// modulo (30 or 210)
+///
+uint64_t coprimes(uint64_t n, uint64_t modulo)
+{
+  uint64_t count = (n / modulo) * ((modulo == 30) ? 8 : 48);
+
+  for (uint64_t r = 1; r <= n % modulo; r++)
+    if (r % 2 && r % 3 && r % 5 && (modulo == 30 || r % 7))
+      count++;
+
+  return count;
+}
+
+/// Number of multiples prime * q inside [low, high] with
+/// q >= prime and q coprime to the wheel modulo. These
+/// are the multiples crossed-off by the Erat* kernels.
+///
+uint64_t countCrossOffs(const vector<uint64_t>& primes,
+                        uint64_t low,
+                        uint64_t high,
+                        uint64_t modulo)
+{
+  uint64_t count = 0;
+
+  for (uint64_t prime : primes)
+  {
+    uint64_t first = max(prime, ceilDiv(low, prime));
+    uint64_t last = high / prime;
+    if (first <= last)
+      count += coprimes(last, modulo) - coprimes(first - 1, modulo);
+  }
+
+  return count;
+}
+
+/// The primes inside ]low, high], density = 0.1
+/// keeps every 10th prime.
+///
+vector<uint64_t> getPrimes(uint64_t low, uint64_t high, double density)
+{
+  vector<uint64_t> primes;
+  if (low < high)
+    generate_primes(low + 1, high, &primes);
+
+  uint64_t step = max<uint64_t>(1, (uint64_t) (1 / density + 0.5));
+  vector<uint64_t> res;
+
+  for (size_t i = 0; i < primes.size(); i += step)
+    res.push_back(primes[i]);
+
+  return res;
+}
+
+string densityName(double density)
+{
+  return (density >= 1) ? "" : ", 1/" + to_string((int) (1 / density + 0.5));
+}
+
+string sizeName(uint64_t sieveSize)
+{
+  return to_string(sieveSize >> 10) + " KiB";
+}
+
+/// Sieves segments of size sieveSize starting at SEGMENT_LOW
+/// using the given sieving primes. Erat is EratSmall,
+/// EratMedium or EratBig.
+///
+template <typename Erat>
+Kernel eratKernel(const string& name,
+                  uint64_t sieveSize,
+                  uint64_t initSize,
+                  uint64_t maxPrime,
+                  uint64_t modulo,
+                  const vector<uint64_t>& primes,
+                  double density)
+{
+  Kernel kernel;
+  kernel.name = name + "(" + sizeName(sieveSize) + densityName(density) + ")";
+  kernel.sieveSize = sieveSize;
+  kernel.primes = primes.size();
+  kernel.run = [=](byte_t* sieve, uint64_t segments, double* seconds)
+  {
+    uint64_t dist = segments * sieveSize * 30;
+    uint64_t stop = SEGMENT_LOW + dist + 6;
+
+    unique_ptr<Erat> erat(new Erat);
+    erat->init(stop, initSize, maxPrime);
+    for (uint64_t prime : primes)
+      erat->addSievingPrime(prime, SEGMENT_LOW);
+
+    Timer timer(seconds);
+    for (uint64_t i = 0; i < segments; i++)
+    {
+      fill_n(sieve, sieveSize, (byte_t) 0xff);
+      erat->crossOff(sieve, sieveSize);
+    }
+    timer.stop();
+
+    return countCrossOffs(primes, SEGMENT_LOW + 7, stop, modulo);
+  };
+
+  return kernel;
+}
+
+/// EratBig::crossOff() has no size parameter
+class EratBigKernel : public EratBig
+{
+public:
+  void crossOff(byte_t* sieve, uint64_t) { EratBig::crossOff(sieve); }
+};
+
+vector<Kernel> getKernels()
+{
+  vector<Kernel> kernels;
+  const uint64_t maxPreSieve = 19;
+
+  for (uint64_t kib : { 32, 256, 1024 })
+  {
+    uint64_t sieveSize = kib << 10;
+    uint64_t l1CacheSize = EratSmall::getL1CacheSize(sieveSize);
+    uint64_t maxSmall = (uint64_t) (l1CacheSize * config::FACTOR_ERATSMALL);
+    uint64_t maxMedium = (uint64_t) (sieveSize * config::FACTOR_ERATMEDIUM);
+    uint64_t maxBig = maxMedium * 20;
+
+    for (double density : { 1.0, 0.1 })
+    {
+      auto small = getPrimes(maxPreSieve, maxSmall, density);
+      auto medium = getPrimes(maxSmall, maxMedium, density);
+      auto big = getPrimes(maxMedium, maxBig, density);
+
+      kernels.push_back(eratKernel<EratSmall>("EratSmall", sieveSize, l1CacheSize, maxSmall, 30, small, density));
+      kernels.push_back(eratKernel<EratMedium>("EratMedium", sieveSize, sieveSize, maxMedium, 30, medium, density));
+      kernels.push_back(eratKernel<EratBigKernel>("EratBig", sieveSize, sieveSize, maxBig, 210, big, density));
+    }
+
+    Kernel preSieve;
+    preSieve.name = "PreSieve::copy(" + sizeName(sieveSize) + ")";
+    preSieve.sieveSize = sieveSize;
+    preSieve.primes = 0;
+    preSieve.run = [=](byte_t* sieve, uint64_t segments, double* seconds)
+    {
+      // Large intervals pre-sieve the primes <= 19
+      uint64_t dist = max<uint64_t>(segments * sieveSize * 30, (uint64_t) 1e10);
+      PreSieve preSieve;
+      preSieve.init(SEGMENT_LOW, SEGMENT_LOW + dist);
+
+      Timer timer(seconds);
+      for (uint64_t i = 0; i < segments; i++)
+        preSieve.copy(sieve, sieveSize, SEGMENT_LOW + i * sieveSize * 30);
+
+      return (uint64_t) 0;
+    };
+    kernels.push_back(preSieve);
+
+    Kernel popcnt;
+    popcnt.name = "popcount(" + sizeName(sieveSize) + ")";
+    popcnt.sieveSize = sieveSize;
+    popcnt.primes = 0;
+    popcnt.run = [=](byte_t* sieve, uint64_t segments, double* seconds)
+    {
+      fill_n(sieve, sieveSize, (byte_t) 0x5a);
+      const uint64_t* words = (const uint64_t*) sieve;
+      uint64_t sum = 0;
+
+      Timer timer(seconds);
+      for (uint64_t i = 0; i < segments; i++)
+      {
+        sieve[i % sieveSize] ^= 1;
+        sum += popcount(words, sieveSize / 8);
+      }
+      timer.stop();
+
+      if (sum == 0)
+        throw runtime_error("popcount failed");
+
+      return (uint64_t) 0;
+    };
+    kernels.push_back(popcnt);
+  }
+
+  return kernels;
+}
+
+Result runKernel(const Kernel& kernel, const Options& opts)
+{
+  uint64_t segments = max<uint64_t>(1, opts.bytes / kernel.sieveSize);
+  unique_ptr<uint64_t[]> buffer(new uint64_t[kernel.sieveSize / 8]);
+  byte_t* sieve = (byte_t*) buffer.get();
+
+  Result res;
+  res.name = kernel.name;
+  res.bytes = segments * kernel.sieveSize;
+  res.seconds = 0;
+
+  for (int i = 0; i < opts.repeat; i++)
+  {
+    double seconds = 0;
+    res.crossOffs = kernel.run(sieve, segments, &seconds);
+    if (i == 0 || seconds < res.seconds)
+      res.seconds = seconds;
+  }
+
+  return res;
+}
+
+/// Same format as the results of primesieve_bench, hence
+/// primesieve_bench --compare can be used to compare
+/// two variants.
+///
+void writeJson(ostream& out, const Options& opts, const vector<Result>& results)
+{
+  out << "{\n";
+  out << "  \"host\": {\n";
+  out << "    \"variant\": \"" << KERNEL_BENCH_VARIANT << "\",\n";
+  out << "    \"primesieve_version\": \"" << primesieve_version() << "\",\n";
+  out << "    \"bytes\": " << opts.bytes << ",\n";
+  out << "    \"repeat\": " << opts.repeat << "\n";
+  out << "  },\n";
+  out << "  \"benchmarks\": [\n";
+
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    auto& r = results[i];
+    out << "    { \"name\": \"" << r.name << "\", "
+        << "\"bytes\": " << r.bytes << ", "
+        << "\"cross_offs\": " << r.crossOffs << ", "
+        << setprecision(6) << fixed
+        << "\"min\": " << r.seconds << " }"
+        << ((i + 1 < results.size()) ? ",\n" : "\n");
+  }
+
+  out << "  ]\n";
+  out << "}\n";
+}
+
+Options parseOptions(int argc, char* argv[])
+{
+  Options opts;
+
+  for (int i = 1; i < argc; i++)
+  {
+    string arg = argv[i];
+    size_t pos = arg.find('=');
+    string value = (pos != string::npos) ? arg.substr(pos + 1) : "";
+
+    if (arg.find("--output=") == 0)
+      opts.output = value;
+    else if (arg.find("--filter=") == 0)
+      opts.filter = value;
+    else if (arg.find("--repeat=") == 0)
+      opts.repeat = max(1, stoi(value));
+    else if (arg.find("--bytes=") == 0)
+      opts.bytes = max<uint64_t>(1, (uint64_t) stod(value));
+    else
+      throw runtime_error("invalid option: " + arg);
+  }
+
+  return opts;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    Options opts = parseOptions(argc, argv);
+    vector<Result> results;
+
+    cout << "Variant: " << KERNEL_BENCH_VARIANT << endl;
+    cout << left << setw(30) << "Kernel"
+         << right << setw(10) << "Primes"
+         << setw(14) << "Cross-offs"
+         << setw(10) << "Seconds"
+         << setw(14) << "ns/cross-off"
+         << setw(8) << "GB/s" << endl;
+
+    for (auto& kernel : getKernels())
+    {
+      if (kernel.name.find(opts.filter) == string::npos)
+        continue;
+
+      Result res = runKernel(kernel, opts);
+      results.push_back(res);
+
+      cout << left << setw(30) << res.name << right
+           << setw(10) << kernel.primes
+           << setw(14) << res.crossOffs
+           << fixed << setprecision(3)
+           << setw(10) << res.seconds;
+
+      if (res.crossOffs)
+        cout << setw(14) << res.seconds * 1e9 / res.crossOffs;
+      else
+        cout << setw(14) << "-";
+
+      cout << setw(8) << setprecision(2) << res.bytes / res.seconds / 1e9 << endl;
+    }
+
+    if (!opts.output.empty())
+    {
+      ofstream file(opts.output);
+      if (!file)
+        throw runtime_error("failed to create " + opts.output);
+      writeJson(file, opts, results);
+    }
+  }
+  catch (exception& e)
+  {
+    cerr << "primesieve_kernels: " << e.what() << endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -17,6 +17,7 @@
 #define PRIMESIEVE_VERSION_MINOR 5
 
 #include <primesieve/iterator.h>
+#include <primesieve/tuplet_iterator.h>
 
 #include <stdint.h>
 #include <stddef.h>
@@ -86,6 +87,12 @@ void* primesieve_generate_n_primes(uint64_t n, uint64_t start, int type);
  */
 uint64_t primesieve_nth_prime(int64_t n, uint64_t start);
 
+/**
+ * Returns 1 if n is prime and 0 otherwise. The numbers < 2^20
+ * are looked up in a table, larger numbers are sieved.
+ */
+int primesieve_is_prime(uint64_t n);
+
 /**
  * Count the primes within the interval [start, stop]. 
  * By default all CPU cores are used, use
@@ -134,6 +141,82 @@ uint64_t primesieve_count_quintuplets(uint64_t start, uint64_t stop);
  */
 uint64_t primesieve_count_sextuplets(uint64_t start, uint64_t stop);
 
+/**
+ * Count the Sophie Germain primes p (p and 2p + 1 are
+ * prime) within the interval [start, stop].
+ * By default all CPU cores are used, use
+ * primesieve_set_num_threads(int threads) to change the
+ * number of threads.
+ */
+uint64_t primesieve_count_sophie_germain_primes(uint64_t start, uint64_t stop);
+
+/**
+ * Count the safe primes q (q and (q - 1) / 2 are
+ * prime) within the interval [start, stop].
+ * By default all CPU cores are used, use
+ * primesieve_set_num_threads(int threads) to change the
+ * number of threads.
+ */
+uint64_t primesieve_count_safe_primes(uint64_t start, uint64_t stop);
+
+/**
+ * Count the primes p within the interval [start, stop]
+ * for which a * p + b is also prime.
+ * By default all CPU cores are used, use
+ * primesieve_set_num_threads(int threads) to change the
+ * number of threads.
+ * @pre a > 0 && a * stop + b < 2^64.
+ */
+uint64_t primesieve_count_linear_primes(uint64_t a, int64_t b, uint64_t start, uint64_t stop);
+
+/**
+ * Count the primes within the interval [start, x] for each
+ * multiple x of step inside [start, stop]. The returned array
+ * must be deallocated using primesieve_free().
+ * @param size  The size of the returned counts array.
+ */
+uint64_t* primesieve_count_primes_table(uint64_t start, uint64_t stop, uint64_t step, size_t* size);
+
+/**
+ * Count the twin primes within the interval [start, x] for each
+ * multiple x of step inside [start, stop]. The returned array
+ * must be deallocated using primesieve_free().
+ * @param size  The size of the returned counts array.
+ */
+uint64_t* primesieve_count_twins_table(uint64_t start, uint64_t stop, uint64_t step, size_t* size);
+
+/**
+ * Count the prime triplets within the interval [start, x] for each
+ * multiple x of step inside [start, stop]. The returned array
+ * must be deallocated using primesieve_free().
+ * @param size  The size of the returned counts array.
+ */
+uint64_t* primesieve_count_triplets_table(uint64_t start, uint64_t stop, uint64_t step, size_t* size);
+
+/**
+ * Count the prime quadruplets within the interval [start, x] for each
+ * multiple x of step inside [start, stop]. The returned array
+ * must be deallocated using primesieve_free().
+ * @param size  The size of the returned counts array.
+ */
+uint64_t* primesieve_count_quadruplets_table(uint64_t start, uint64_t stop, uint64_t step, size_t* size);
+
+/**
+ * Count the prime quintuplets within the interval [start, x] for each
+ * multiple x of step inside [start, stop]. The returned array
+ * must be deallocated using primesieve_free().
+ * @param size  The size of the returned counts array.
+ */
+uint64_t* primesieve_count_quintuplets_table(uint64_t start, uint64_t stop, uint64_t step, size_t* size);
+
+/**
+ * Count the prime sextuplets within the interval [start, x] for each
+ * multiple x of step inside [start, stop]. The returned array
+ * must be deallocated using primesieve_free().
+ * @param size  The size of the returned counts array.
+ */
+uint64_t* primesieve_count_sextuplets_table(uint64_t start, uint64_t stop, uint64_t step, size_t* size);
+
 /**
  * Print the primes within the interval [start, stop]
  * to the standard output.
@@ -170,6 +253,19 @@ void primesieve_print_quintuplets(uint64_t start, uint64_t stop);
  */
 void primesieve_print_sextuplets(uint64_t start, uint64_t stop);
 
+/**
+ * Print the Sophie Germain prime pairs (p, 2p + 1) with
+ * p within the interval [start, stop] to the standard output.
+ */
+void primesieve_print_sophie_germain_primes(uint64_t start, uint64_t stop);
+
+/**
+ * Print the pairs (p, a * p + b) of primes with p within
+ * the interval [start, stop] to the standard output.
+ * @pre a > 0 && a * stop + b < 2^64.
+ */
+void primesieve_print_linear_primes(uint64_t a, int64_t b, uint64_t start, uint64_t stop);
+
 /**
  * Returns the largest valid stop number for primesieve.
  * @return 2^64-1 (UINT64_MAX).
@@ -182,6 +278,9 @@ int primesieve_get_sieve_size();
 /** Get the current set number of threads */
 int primesieve_get_num_threads();
 
+/** Get the current set memory limit in bytes, 0 means no limit. */
+uint64_t primesieve_get_max_memory();
+
 /**
  * Set the sieve size in KiB (kibibyte).
  * The best sieving performance is achieved with a sieve size
@@ -190,6 +289,15 @@ int primesieve_get_num_threads();
  */
 void primesieve_set_sieve_size(int sieve_size);
 
+/**
+ * If exact is 1, primesieve_generate_primes() first counts the
+ * primes inside [start, stop] and then allocates exactly as much
+ * memory as needed. This is slower, by default (0) a tight upper
+ * bound based on the logarithmic integral is allocated and the
+ * unused memory is released after generating the primes.
+ */
+void primesieve_set_exact_reserve(int exact);
+
 /**
  * Set the number of threads for use in
  * primesieve_count_*() and primesieve_nth_prime().
@@ -197,6 +305,137 @@ void primesieve_set_sieve_size(int sieve_size);
  */
 void primesieve_set_num_threads(int num_threads);
 
+/**
+ * Limit the memory (in bytes) that primesieve_count_*() and
+ * primesieve_nth_prime() use for sieving. If needed fewer
+ * threads and a different sieve size are used, if the
+ * sieving primes <= sqrt(stop) alone exceed the limit the
+ * functions return PRIMESIEVE_ERROR before sieving.
+ * 0 means no limit (default).
+ */
+void primesieve_set_max_memory(uint64_t max_memory);
+
+/**
+ * Store the primes <= max_prime in a sieving primes cache file,
+ * 1 byte per prime. The cache file of the primes < 2^32 uses
+ * about 203 MB.
+ * @pre max_prime <= 2^32.
+ * @return 0 on success, -1 if an error occurred.
+ */
+int primesieve_build_sieving_primes_cache(const char* filename, uint64_t max_prime);
+
+/**
+ * Read the sieving primes from the cache file instead of
+ * generating them, this speeds up sieving small intervals
+ * near 2^64. The file is memory mapped and shared by all
+ * threads. NULL or an empty filename disables the cache.
+ * @return 0 on success, -1 if the file is invalid.
+ */
+int primesieve_set_sieving_primes_cache(const char* filename);
+
+/**
+ * Read the tuning profile (sieve size, number of threads, ...)
+ * from the file instead of the default per-host profile
+ * written by primesieve --tune. NULL or an empty filename
+ * disables the profile. primesieve_set_sieve_size() and
+ * primesieve_set_num_threads() take precedence over the profile.
+ * primesieve_set_profile() is not thread safe, it must not be
+ * called while other threads are sieving.
+ * @return 0 on success, -1 if the file is invalid.
+ */
+int primesieve_set_profile(const char* filename);
+
+/**
+ * Store the sieving primes and the pre-sieve buffers in POSIX
+ * shared memory. The first process creates them, all other
+ * processes map them read-only. This reduces the startup time
+ * and memory usage if many primesieve processes run at the
+ * same time. If shared memory is not available private
+ * memory is used. Disabled by default.
+ */
+void primesieve_set_shared_memory(int enabled);
+
+/**
+ * Delete the shared memory of all primesieve processes,
+ * processes that currently use it are not affected.
+ */
+void primesieve_remove_shared_memory();
+
+/** Statistics of the counts cache */
+typedef struct
+{
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  uint64_t blocks;
+  uint64_t memory_usage;
+} primesieve_counts_cache_stats;
+
+/**
+ * Cache the prime and prime k-tuplet counts of blocks of about
+ * 10^9 numbers, primesieve_count_*() and primesieve_nth_prime()
+ * then only sieve the blocks that are not cached yet. The least
+ * recently used blocks are evicted once the cache uses more than
+ * max_memory bytes. 0 disables the cache (default).
+ */
+void primesieve_set_counts_cache(uint64_t max_memory);
+
+/** Get the hits, misses, evictions and memory usage of the counts cache */
+primesieve_counts_cache_stats primesieve_get_counts_cache_stats();
+
+/** Remove all blocks from the counts cache and reset its statistics */
+void primesieve_clear_counts_cache();
+
+/** Statistics of the memory pools that store the sieving primes */
+typedef struct
+{
+  uint64_t buckets_in_use;
+  /** Upper bound, the peaks of the memory
+      pools alive at the same time are summed. */
+  uint64_t peak_buckets_in_use;
+  uint64_t allocations;
+  uint64_t bytes;
+  uint64_t peak_bytes;
+} primesieve_memory_pool_stats;
+
+/**
+ * Get the buckets in use, the number of allocations and the
+ * allocated bytes of all memory pools of the current process.
+ */
+primesieve_memory_pool_stats primesieve_get_memory_pool_stats();
+
+/**
+ * Time spent in each phase of the segmented sieve of
+ * Eratosthenes (in seconds), summed over all threads.
+ */
+typedef struct
+{
+  double pre_sieve;
+  double erat_small;
+  double erat_medium;
+  double erat_big;
+  double sieving_primes;
+  double count;
+  double print;
+  uint64_t segments;
+} primesieve_sieve_stats;
+
+/**
+ * Returns 1 if primesieve has been built with per-phase
+ * timing statistics i.e. cmake -DENABLE_STATS=ON.
+ */
+int primesieve_is_sieve_stats_enabled();
+
+/**
+ * Get the per-phase timing statistics of all count, print and
+ * nth prime calls of the current process. All fields are 0
+ * if primesieve_is_sieve_stats_enabled() returns 0.
+ */
+primesieve_sieve_stats primesieve_get_sieve_stats();
+
+/** Reset the per-phase timing statistics */
+void primesieve_reset_sieve_stats();
+
 /**
  * Deallocate a primes array created using the
  * primesieve_generate_primes() or primesieve_generate_n_primes()
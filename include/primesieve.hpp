@@ -18,6 +18,8 @@
 #define PRIMESIEVE_VERSION_MINOR 5
 
 #include <primesieve/iterator.hpp>
+#include <primesieve/primes_range.hpp>
+#include <primesieve/tuplet_iterator.hpp>
 #include <primesieve/primesieve_error.hpp>
 #include <primesieve/StorePrimes.hpp>
 
@@ -72,6 +74,11 @@ inline void generate_n_primes(uint64_t n, uint64_t start, std::vector<T>* primes
 ///
 uint64_t nth_prime(int64_t n, uint64_t start = 0);
 
+/// Returns true if n is prime. The numbers < 2^20 are
+/// looked up in a table, larger numbers are sieved.
+///
+bool is_prime(uint64_t n);
+
 /// Count the primes within the interval [start, stop].
 /// By default all CPU cores are used, use
 /// primesieve::set_num_threads(int threads) to change the
@@ -114,6 +121,67 @@ uint64_t count_quintuplets(uint64_t start, uint64_t stop);
 ///
 uint64_t count_sextuplets(uint64_t start, uint64_t stop);
 
+/// Count the Sophie Germain primes p (p and 2p + 1 are
+/// prime) within the interval [start, stop].
+/// By default all CPU cores are used, use
+/// primesieve::set_num_threads(int threads) to change the
+/// number of threads.
+///
+uint64_t count_sophie_germain_primes(uint64_t start, uint64_t stop);
+
+/// Count the safe primes q (q and (q - 1) / 2 are
+/// prime) within the interval [start, stop].
+/// By default all CPU cores are used, use
+/// primesieve::set_num_threads(int threads) to change the
+/// number of threads.
+///
+uint64_t count_safe_primes(uint64_t start, uint64_t stop);
+
+/// Count the primes p within the interval [start, stop]
+/// for which a * p + b is also prime.
+/// By default all CPU cores are used, use
+/// primesieve::set_num_threads(int threads) to change the
+/// number of threads.
+/// @pre a > 0 && a * stop + b < 2^64.
+///
+uint64_t count_linear_primes(uint64_t a, int64_t b, uint64_t start, uint64_t stop);
+
+/// Count the primes within the interval [start, x]
+/// for each multiple x of step inside [start, stop].
+/// All counts are computed in a single parallel sweep.
+///
+std::vector<uint64_t> count_primes_table(uint64_t start, uint64_t stop, uint64_t step);
+
+/// Count the twin primes within the interval [start, x]
+/// for each multiple x of step inside [start, stop].
+/// All counts are computed in a single parallel sweep.
+///
+std::vector<uint64_t> count_twins_table(uint64_t start, uint64_t stop, uint64_t step);
+
+/// Count the prime triplets within the interval [start, x]
+/// for each multiple x of step inside [start, stop].
+/// All counts are computed in a single parallel sweep.
+///
+std::vector<uint64_t> count_triplets_table(uint64_t start, uint64_t stop, uint64_t step);
+
+/// Count the prime quadruplets within the interval [start, x]
+/// for each multiple x of step inside [start, stop].
+/// All counts are computed in a single parallel sweep.
+///
+std::vector<uint64_t> count_quadruplets_table(uint64_t start, uint64_t stop, uint64_t step);
+
+/// Count the prime quintuplets within the interval [start, x]
+/// for each multiple x of step inside [start, stop].
+/// All counts are computed in a single parallel sweep.
+///
+std::vector<uint64_t> count_quintuplets_table(uint64_t start, uint64_t stop, uint64_t step);
+
+/// Count the prime sextuplets within the interval [start, x]
+/// for each multiple x of step inside [start, stop].
+/// All counts are computed in a single parallel sweep.
+///
+std::vector<uint64_t> count_sextuplets_table(uint64_t start, uint64_t stop, uint64_t step);
+
 /// Print the primes within the interval [start, stop]
 /// to the standard output.
 ///
@@ -144,6 +212,17 @@ void print_quintuplets(uint64_t start, uint64_t stop);
 ///
 void print_sextuplets(uint64_t start, uint64_t stop);
 
+/// Print the Sophie Germain prime pairs (p, 2p + 1) with
+/// p within the interval [start, stop] to the standard output.
+///
+void print_sophie_germain_primes(uint64_t start, uint64_t stop);
+
+/// Print the pairs (p, a * p + b) of primes with p within
+/// the interval [start, stop] to the standard output.
+/// @pre a > 0 && a * stop + b < 2^64.
+///
+void print_linear_primes(uint64_t a, int64_t b, uint64_t start, uint64_t stop);
+
 /// Returns the largest valid stop number for primesieve.
 /// @return 2^64-1 (UINT64_MAX).
 ///
@@ -155,6 +234,9 @@ int get_sieve_size();
 /// Get the current set number of threads.
 int get_num_threads();
 
+/// Get the current set memory limit in bytes, 0 means no limit.
+uint64_t get_max_memory();
+
 /// Set the sieve size in KiB (kibibyte).
 /// The best sieving performance is achieved with a sieve size
 /// of your CPU's L1 or L2 cache size (per core).
@@ -162,12 +244,141 @@ int get_num_threads();
 ///
 void set_sieve_size(int sieve_size);
 
+/// If exact is true, generate_primes() first counts the primes
+/// inside [start, stop] and then reserves exactly as much memory
+/// as needed. This is slower, by default (false) a tight
+/// upper bound based on the logarithmic integral is reserved.
+///
+void set_exact_reserve(bool exact);
+
+/// Get the setting of set_exact_reserve()
+bool is_exact_reserve();
+
 /// Set the number of threads for use in
 /// primesieve::count_*() and primesieve::nth_prime().
 /// By default all CPU cores are used.
 ///
 void set_num_threads(int num_threads);
 
+/// Limit the memory (in bytes) that primesieve::count_*() and
+/// primesieve::nth_prime() use for sieving. If needed fewer
+/// threads and a different sieve size are used, if the
+/// sieving primes <= sqrt(stop) alone exceed the limit a
+/// primesieve_error is thrown before sieving.
+/// 0 means no limit (default).
+///
+void set_max_memory(uint64_t max_memory);
+
+/// Store the primes <= max_prime in a sieving primes cache file,
+/// 1 byte per prime. The cache file of the primes < 2^32 uses
+/// about 203 MB.
+/// @pre max_prime <= 2^32.
+///
+void build_sieving_primes_cache(const std::string& filename,
+                                uint64_t max_prime = 1ull << 32);
+
+/// Read the sieving primes from the cache file instead of
+/// generating them, this speeds up sieving small intervals
+/// near 2^64. The file is memory mapped and shared by all
+/// threads. An empty filename disables the cache.
+///
+void set_sieving_primes_cache(const std::string& filename);
+
+/// Read the tuning profile (sieve size, number of threads, ...)
+/// from the file instead of the default per-host profile
+/// written by primesieve --tune. An empty filename disables
+/// the profile. set_sieve_size() and set_num_threads()
+/// take precedence over the profile.
+/// set_profile() is not thread safe, it must not be called
+/// while other threads are sieving. Throws primesieve_error
+/// if the file is missing or invalid.
+///
+void set_profile(const std::string& filename);
+
+/// Store the sieving primes and the pre-sieve buffers in POSIX
+/// shared memory. The first process creates them, all other
+/// processes map them read-only. This reduces the startup time
+/// and memory usage if many primesieve processes run at the
+/// same time. If shared memory is not available private
+/// memory is used. Disabled by default.
+///
+void set_shared_memory(bool enabled);
+
+/// Delete the shared memory of all primesieve processes,
+/// processes that currently use it are not affected.
+///
+void remove_shared_memory();
+
+/// Statistics of the counts cache
+struct counts_cache_stats
+{
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  uint64_t blocks;
+  uint64_t memory_usage;
+};
+
+/// Cache the prime and prime k-tuplet counts of blocks of about
+/// 10^9 numbers, primesieve::count_*() and nth_prime() then only
+/// sieve the blocks that are not cached yet. The least recently
+/// used blocks are evicted once the cache uses more than
+/// max_memory bytes. 0 disables the cache (default).
+///
+void set_counts_cache(uint64_t max_memory);
+
+/// Get the hits, misses, evictions and memory usage of the counts cache
+counts_cache_stats get_counts_cache_stats();
+
+/// Remove all blocks from the counts cache and reset its statistics
+void clear_counts_cache();
+
+/// Statistics of the memory pools that store the sieving primes
+struct memory_pool_stats
+{
+  uint64_t buckets_in_use;
+  /// Upper bound, the peaks of the memory
+  /// pools alive at the same time are summed.
+  uint64_t peak_buckets_in_use;
+  uint64_t allocations;
+  uint64_t bytes;
+  uint64_t peak_bytes;
+};
+
+/// Get the buckets in use, the number of allocations and the
+/// allocated bytes of all memory pools of the current process.
+///
+memory_pool_stats get_memory_pool_stats();
+
+/// Time spent in each phase of the segmented sieve of
+/// Eratosthenes (in seconds), summed over all threads
+///
+struct sieve_stats
+{
+  double pre_sieve;
+  double erat_small;
+  double erat_medium;
+  double erat_big;
+  double sieving_primes;
+  double count;
+  double print;
+  uint64_t segments;
+};
+
+/// Returns true if primesieve has been built with per-phase
+/// timing statistics i.e. cmake -DENABLE_STATS=ON.
+///
+bool is_sieve_stats_enabled();
+
+/// Get the per-phase timing statistics of all count_*(),
+/// print_*() and nth_prime() calls of the current process.
+/// All fields are 0 if is_sieve_stats_enabled() is false.
+///
+sieve_stats get_sieve_stats();
+
+/// Reset the per-phase timing statistics
+void reset_sieve_stats();
+
 /// Get the primesieve version number, in the form “i.j”.
 std::string primesieve_version();
 
@@ -19,6 +19,7 @@
 
 #include <stdint.h>
 #include <cassert>
+#include <cstddef>
 
 namespace primesieve {
 
@@ -101,11 +102,18 @@ private:
 /// @see http://www.ieeta.pt/~tos/software/prime_sieve.html
 /// The Bucket class is designed as a singly linked list, once
 /// there is no more space in the current Bucket a new Bucket
-/// is allocated.
+/// is allocated. Buckets of the smaller size classes of the
+/// MemoryPool only use the first bucketBytes of the Bucket.
 ///
 class Bucket
 {
 public:
+  /// Number of sieving primes that fit into a bucket
+  static constexpr std::size_t getCapacity(std::size_t bucketBytes)
+  {
+    return (bucketBytes - SIEVING_PRIMES_OFFSET) / sizeof(SievingPrime);
+  }
+
   SievingPrime* begin() { return &sievingPrimes_[0]; }
   SievingPrime* end()   { return end_; }
   Bucket* next()        { return next_; }
@@ -0,0 +1,96 @@
+///
+/// @file  CountsCache.hpp
+///        LRU cache of the prime and prime k-tuplet counts of
+///        fixed size blocks. ParallelSieve looks up the blocks
+///        that are fully inside [start, stop] and only sieves
+///        the missing blocks and the edges. Block boundaries
+///        are congruent to 2 (mod 30) so that prime k-tuplets
+///        cannot be split, like the thread boundaries of
+///        ParallelSieve.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef COUNTSCACHE_HPP
+#define COUNTSCACHE_HPP
+
+#include "PrimeSieve.hpp"
+
+#include <stdint.h>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace primesieve {
+
+class CountsCache
+{
+public:
+  /// About 10^9 numbers per block
+  static constexpr uint64_t BLOCK_SIZE = 30ull << 25;
+
+  struct Stats
+  {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t blocks;
+    uint64_t memoryUsage;
+  };
+
+  /// 0 disables the cache (default)
+  void setMaxMemory(uint64_t maxMemory);
+  bool isEnabled() const;
+  void clear();
+  Stats getStats() const;
+
+  /// Returns true if the counts of all flags
+  /// (COUNT_PRIMES, ...) of the block are cached.
+  ///
+  bool find(uint64_t block, int flags, counts_t& counts);
+  void insert(uint64_t block, int flags, const counts_t& counts);
+
+  /// The block contains the numbers
+  /// [blockStart(block), blockStop(block)]
+  static uint64_t blockStart(uint64_t block);
+  static uint64_t blockStop(uint64_t block);
+
+  /// Blocks fully inside [start, stop] are
+  /// [firstBlock(start), lastBlock(stop)].
+  /// @return false if there is no such block.
+  ///
+  static bool getBlocks(uint64_t start,
+                        uint64_t stop,
+                        uint64_t* firstBlock,
+                        uint64_t* lastBlock);
+
+private:
+  struct Entry
+  {
+    uint64_t block;
+    int flags;
+    counts_t counts;
+  };
+
+  /// Most recently used entry first
+  using lru_t = std::list<Entry>;
+  lru_t lru_;
+  std::unordered_map<uint64_t, lru_t::iterator> map_;
+  uint64_t maxEntries_ = 0;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t evictions_ = 0;
+  mutable std::mutex mutex_;
+  static uint64_t entryBytes();
+  void evict();
+};
+
+/// Shared by all threads
+extern CountsCache countsCache;
+
+} // namespace
+
+#endif
@@ -13,6 +13,8 @@
 #include "EratSmall.hpp"
 #include "EratMedium.hpp"
 #include "EratBig.hpp"
+#include "SieveStats.hpp"
+#include "decodePrimes.hpp"
 #include "types.hpp"
 
 #include <stdint.h>
@@ -34,6 +36,8 @@ class Erat
 public:
   uint64_t getSieveSize() const;
   uint64_t getStop() const;
+  uint64_t getMemoryUsage() const;
+  static uint64_t estimateMemoryUsage(uint64_t, uint64_t, uint64_t);
 
 protected:
   /// Sieve primes >= start_
@@ -48,25 +52,29 @@ protected:
   uint64_t segmentHigh_ = 0;
   /// Sieve of Eratosthenes array
   byte_t* sieve_ = nullptr;
+  /// Per-phase timing statistics, nullptr = disabled
+  SieveStats* stats_ = nullptr;
   Erat();
   Erat(uint64_t, uint64_t);
   void init(uint64_t, uint64_t, uint64_t, PreSieve&);
   void addSievingPrime(uint64_t);
   void sieveSegment();
   bool hasNextSegment() const;
-  static uint64_t nextPrime(uint64_t*, uint64_t);
+  static uint64_t byteRemainder(uint64_t);
+  /// Bitmasks to unset bits > stop
+  static const std::array<byte_t, 37> unsetLarger_;
 
 private:
-  static const std::array<uint64_t, 64> bruijnBitValues_;
   uint64_t maxPreSieve_ = 0;
   uint64_t maxEratSmall_ = 0;
   uint64_t maxEratMedium_ = 0;
+  /// Size of the allocated sieve_ array in bytes
+  uint64_t allocSize_ = 0;
   std::unique_ptr<byte_t[]> deleter_;
   PreSieve* preSieve_ = nullptr;
   EratSmall eratSmall_;
   EratBig eratBig_;
   EratMedium eratMedium_;
-  static uint64_t byteRemainder(uint64_t);
   void initSieve(uint64_t);
   void initErat();
   void preSieve();
@@ -74,21 +82,6 @@ private:
   void sieveLastSegment();
 };
 
-/// Reconstruct the prime number corresponding to
-/// the first set bit and unset that bit
-///
-inline uint64_t Erat::nextPrime(uint64_t* bits, uint64_t low)
-{
-  // calculate bitValues_[bitScanForward(*bits)]
-  // using a custom De Bruijn bitscan
-  uint64_t debruijn = 0x3F08A4C6ACB9DBDull;
-  uint64_t mask = *bits - 1;
-  uint64_t bitValue = bruijnBitValues_[((*bits ^ mask) * debruijn) >> 58];
-  uint64_t prime = low + bitValue;
-  *bits &= mask;
-  return prime;
-}
-
 inline void Erat::addSievingPrime(uint64_t prime)
 {
        if (prime > maxEratMedium_)   eratBig_.addSievingPrime(prime, segmentLow_);
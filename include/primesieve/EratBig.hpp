@@ -28,8 +28,12 @@ class EratBig : public Wheel210_t
 {
 public:
   void init(uint64_t, uint64_t, uint64_t);
+  void clear();
+  void trim() { memoryPool_.trim(); }
   void crossOff(byte_t*);
   bool enabled() const { return enabled_; }
+  uint64_t getMemoryUsage() const;
+  static uint64_t getListCount(uint64_t, uint64_t);
 private:
   uint64_t maxPrime_ = 0;
   uint64_t log2SieveSize_ = 0;
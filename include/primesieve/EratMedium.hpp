@@ -28,7 +28,10 @@ class EratMedium : public Wheel30_t
 {
 public:
   void init(uint64_t, uint64_t, uint64_t);
+  void clear();
+  void trim() { memoryPool_.trim(); }
   bool enabled() const { return enabled_; }
+  uint64_t getMemoryUsage() const { return memoryPool_.getMemoryUsage(); }
   void crossOff(byte_t*, uint64_t);
 private:
   bool enabled_ = false;
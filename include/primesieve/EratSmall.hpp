@@ -28,8 +28,10 @@ class EratSmall : public Wheel30_t
 public:
   static uint64_t getL1CacheSize(uint64_t);
   void init(uint64_t, uint64_t, uint64_t);
+  void clear();
   void crossOff(byte_t*, uint64_t);
   bool enabled() const { return enabled_; }
+  uint64_t getMemoryUsage() const { return primes_.capacity() * sizeof(SievingPrime); }
 private:
   uint64_t maxPrime_ = 0;
   uint64_t l1CacheSize_ = 0;
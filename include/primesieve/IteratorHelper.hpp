@@ -11,21 +11,108 @@
 #define ITERATOR_HELPER_HPP
 
 #include <stdint.h>
+#include <cstddef>
 
 namespace primesieve {
 
+/// State of primesieve::iterator, it is serialized
+/// into a portable (little endian) blob so that long
+/// running scans can be resumed after a restart.
+///
+struct IteratorState
+{
+  enum Mode
+  {
+    /// No primes generated yet
+    FRESH,
+    /// Generating primes > position
+    NEXT,
+    /// Generating primes < position
+    PREV
+  };
+
+  enum { SIZE = 48 };
+
+  int mode;
+  uint64_t start;
+  uint64_t stop;
+  uint64_t stopHint;
+  uint64_t dist;
+  /// Last returned prime (or start)
+  uint64_t position;
+
+  void save(uint8_t* state) const;
+  void load(const uint8_t* state);
+
+  /// Serialize the state of primesieve::iterator or of
+  /// primesieve_iterator into IteratorState::SIZE bytes.
+  /// @mode:   Direction of the iterator, FRESH if no
+  ///          primes have been generated since skipto().
+  /// @skipto: Pending skipto() start number or 0.
+  ///
+  static void save(uint8_t* state,
+                   int mode,
+                   uint64_t start,
+                   uint64_t stop,
+                   uint64_t stopHint,
+                   uint64_t dist,
+                   uint64_t skipto,
+                   const uint64_t* primes,
+                   std::size_t i);
+};
+
+/// Chunk policy of an iterator with a memory limit. The
+/// intervals are shrunk so that their estimated sieving memory
+/// stays below the limit. Larger intervals amortize the
+/// generation of the sieving primes, this only pays off if the
+/// iterator spends most of its time sieving. Hence the growth
+/// factor of the interval distance adapts to the time the
+/// caller spends processing the primes of an interval.
+///
+class ChunkPolicy
+{
+public:
+  ChunkPolicy(uint64_t maxMemory);
+  uint64_t getMaxMemory() const { return maxMemory_; }
+  uint64_t getGrowth() const { return growth_; }
+  /// Measure the time spent generating primes
+  void startSieve();
+  void stopSieve();
+  /// Called before sieving a new interval, updates
+  /// the growth factor using the previous interval
+  void newInterval();
+
+private:
+  uint64_t maxMemory_;
+  uint64_t growth_ = 4;
+  /// Start time of the current interval,
+  /// negative if there is none yet
+  double intervalStart_ = -1;
+  double sieveStart_ = 0;
+  double sieveTime_ = 0;
+};
+
 class IteratorHelper
 {
 public:
   static void next(uint64_t* start,
                    uint64_t* stop,
                    uint64_t stopHint,
-                   uint64_t* dist);
+                   uint64_t* dist,
+                   const ChunkPolicy* policy = nullptr);
 
   static void prev(uint64_t* start,
                    uint64_t* stop,
                    uint64_t stopHint,
-                   uint64_t* dist);
+                   uint64_t* dist,
+                   const ChunkPolicy* policy = nullptr);
+
+  static uint64_t nextMemory(uint64_t start, uint64_t stop);
+  static uint64_t prevMemory(uint64_t start, uint64_t stop);
+
+  static bool isFastForward(uint64_t prime,
+                            uint64_t start,
+                            uint64_t stop);
 };
 
 } // namespace
@@ -0,0 +1,115 @@
+///
+/// @file  LinearSieve.hpp
+///        Sieves the primes p and the numbers a * p + b
+///        simultaneously, e.g. a = 2, b = 1 finds the
+///        Sophie Germain primes.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef LINEARSIEVE_HPP
+#define LINEARSIEVE_HPP
+
+#include "Erat.hpp"
+#include "PrimeSieve.hpp"
+#include "SievingPrimes.hpp"
+#include "types.hpp"
+
+#include <stdint.h>
+#include <array>
+#include <deque>
+
+namespace primesieve {
+
+class PreSieve;
+
+/// The p sieve and the a * p + b sieve of LinearSieve consume
+/// the same stream of sieving primes. SharedPrimes generates
+/// that stream only once and buffers the primes that have
+/// been consumed by one of the two sieves only.
+///
+class SharedPrimes
+{
+public:
+  void init(Erat*, PreSieve&);
+  uint64_t next(int);
+private:
+  SievingPrimes sievingPrimes_;
+  /// Primes not yet consumed by both sieves
+  std::deque<uint64_t> primes_;
+  /// Number of primes consumed by each sieve
+  std::array<uint64_t, 2> count_ = {{ 0, 0 }};
+  /// Number of primes removed from primes_
+  uint64_t removed_ = 0;
+};
+
+/// PrimeLookup sieves the numbers a * p + b segment by
+/// segment and answers primality queries using its sieve
+/// array. The queried numbers must be non-decreasing.
+///
+class PrimeLookup : public Erat
+{
+public:
+  void init(uint64_t, uint64_t, uint64_t, PreSieve&, SharedPrimes*);
+  bool isPrime(uint64_t);
+private:
+  uint64_t low_ = 0;
+  uint64_t high_ = 0;
+  uint64_t prime_ = 0;
+  SharedPrimes* sievingPrimes_ = nullptr;
+  void sieveSegment();
+};
+
+/// LinearSieve sieves the primes p inside [start, stop] and
+/// counts or prints the primes p for which a * p + b is
+/// also prime.
+///
+class LinearSieve : public Erat
+{
+public:
+  LinearSieve(PrimeSieve&);
+  void sieve();
+private:
+  uint64_t a_;
+  int64_t b_;
+  uint64_t low_ = 0;
+  bool isLookup_ = false;
+  PrimeLookup lookup_;
+  SharedPrimes sievingPrimes_;
+  counts_t& counts_;
+  PrimeSieve& ps_;
+  uint64_t linearForm(uint64_t) const;
+  bool isPrime(uint64_t);
+  void processSmallPrimes();
+  void process();
+};
+
+/// Get the next sieving prime of the p sieve (i = 0)
+/// or of the a * p + b sieve (i = 1).
+///
+inline uint64_t SharedPrimes::next(int i)
+{
+  uint64_t prime;
+  uint64_t j = count_[i]++ - removed_;
+
+  if (j < primes_.size())
+    prime = primes_[j];
+  else
+  {
+    prime = sievingPrimes_.next();
+    primes_.push_back(prime);
+  }
+
+  // remove the primes consumed by both sieves
+  for (; removed_ < count_[0] && removed_ < count_[1]; removed_++)
+    primes_.pop_front();
+
+  return prime;
+}
+
+} // namespace
+
+#endif
@@ -11,59 +11,109 @@
 #define MEMORYPOOL_HPP
 
 #include "Bucket.hpp"
-#include <vector>
+#include "config.hpp"
+
+#include <stdint.h>
+#include <atomic>
+#include <cstddef>
 #include <memory>
+#include <vector>
 
 namespace primesieve {
 
 class MemoryPool
 {
 public:
+  /// Statistics of all memory pools
+  struct Stats
+  {
+    uint64_t bucketsInUse;
+    /// Upper bound, the peaks of the memory
+    /// pools alive at the same time are summed.
+    uint64_t peakBucketsInUse;
+    uint64_t allocations;
+    uint64_t bytes;
+    uint64_t peakBytes;
+  };
+
+  MemoryPool();
+  ~MemoryPool();
+  MemoryPool(const MemoryPool&) = delete;
+  MemoryPool& operator=(const MemoryPool&) = delete;
   void reset(SievingPrime*& sievingPrime);
   void addBucket(SievingPrime*& sievingPrime);
   void freeBucket(Bucket* bucket);
+  void freeBuckets(SievingPrime* sievingPrime);
+  void init(uint64_t sievingPrimes, uint64_t lists);
+  void setBucketBytes(std::size_t bytes);
+  void trim();
+  std::size_t getMemoryUsage() const { return bytes_; }
+  std::size_t getBucketBytes() const { return bucketBytes_; }
+  static std::size_t getBucketBytes(uint64_t sievingPrimesPerList);
+  static Stats getStats();
 
   /// Get the sieving prime's bucket.
   /// For performance reasons we don't keep an array with all
   /// buckets. Instead we find the sieving prime's bucket by
   /// doing pointer arithmetic using the sieving prime's
-  /// address. Since all buckets are aligned by sizeof(Bucket)
+  /// address. Since all buckets are aligned by bucketBytes_
   /// we calculate the next address that is smaller than the
   /// sieving prime's address and that is aligned by
-  /// sizeof(Bucket). That's the address of the sieving prime's
+  /// bucketBytes_. That's the address of the sieving prime's
   /// bucket.
   ///
-  static Bucket* getBucket(SievingPrime* sievingPrime)
+  Bucket* getBucket(SievingPrime* sievingPrime) const
   {
     std::size_t address = (std::size_t) sievingPrime;
     // We need to adjust the address
     // in case the bucket is full
     address -= 1;
-    address -= address % sizeof(Bucket);
+    address &= ~(bucketBytes_ - 1);
     return (Bucket*) address;
   }
 
   /// Returns true if the sieving prime's bucket is full.
-  /// Since each bucket's memory is aligned by sizeof(Bucket) we can
-  /// compute the position of the current sieving prime using
-  /// address % sizeof(Bucket).
+  /// Since each bucket's memory is aligned by bucketBytes_ we
+  /// can compute the position of the current sieving prime
+  /// using address % bucketBytes_.
   ///
-  static bool isFullBucket(SievingPrime* sievingPrime)
+  bool isFullBucket(SievingPrime* sievingPrime) const
   {
     std::size_t address = (std::size_t) sievingPrime;
-    return address % sizeof(Bucket) == 0;
+    return (address & (bucketBytes_ - 1)) == 0;
   }
 
 private:
+  struct Chunk
+  {
+    std::unique_ptr<char[]> memory;
+    /// Aligned buckets
+    char* buckets;
+    std::size_t count;
+    std::size_t bytes;
+  };
+
   void allocateBuckets();
-  void initBuckets(void* memory, std::size_t bytes);
+  void initBuckets(Chunk& chunk);
   void increaseAllocCount();
+  void freeAll();
+  Bucket* popBucket();
   /// List of empty buckets
   Bucket* stock_ = nullptr;
+  /// Size class of the buckets
+  std::size_t bucketBytes_ = config::BUCKET_BYTES;
   /// Number of buckets to allocate
   std::size_t count_ = 64;
-  /// Pointers of allocated buckets
-  std::vector<std::unique_ptr<char[]>> memory_;
+  /// Number of allocated bytes
+  std::size_t bytes_ = 0;
+  /// Number of allocated buckets
+  std::size_t buckets_ = 0;
+  /// Number of buckets that are not in the stock. Only this
+  /// pool's thread writes the counters (no atomic RMW),
+  /// getStats() reads them from other threads.
+  std::atomic<std::size_t> bucketsInUse_{0};
+  std::atomic<std::size_t> peakBucketsInUse_{0};
+  std::vector<Chunk> chunks_;
 };
 
 } // namespace
@@ -15,6 +15,7 @@
 #include "PrimeSieve.hpp"
 #include <stdint.h>
 #include <mutex>
+#include <vector>
 
 namespace primesieve {
 
@@ -23,6 +24,17 @@ class ParallelSieve : public PrimeSieve
 public:
   using PrimeSieve::sieve;
 
+  /// Statistics of a thread of the last sieve() call
+  struct ThreadStats
+  {
+    /// Number of chunks (sub-intervals) sieved
+    uint64_t chunks = 0;
+    /// Time spent sieving chunks
+    double busySeconds = 0;
+    /// Time elapsed until the thread finished
+    double finishSeconds = 0;
+  };
+
   ParallelSieve();
   void init(SharedMemory&);
   static int getMaxThreads();
@@ -30,13 +42,18 @@ public:
   int idealNumThreads() const;
   void setNumThreads(int numThreads);
   bool tryUpdateStatus(uint64_t);
+  std::vector<ThreadStats> getThreadStats() const;
   virtual void sieve();
 
 private:
   std::mutex mutex_;
   int numThreads_ = 0;
+  std::vector<ThreadStats> threadStats_;
+  bool useCountsCache_ = true;
   uint64_t getThreadDistance(int) const;
   uint64_t align(uint64_t) const;
+  bool isCountsCache() const;
+  void sieveCountsCache();
 };
 
 } // namespace
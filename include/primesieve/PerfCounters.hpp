@@ -0,0 +1,67 @@
+///
+/// @file  PerfCounters.hpp
+///        Hardware performance counters of the calling thread
+///        using the Linux perf_event_open() system call. Each
+///        event is opened separately so that a single event
+///        which is not supported (e.g. inside a virtual machine)
+///        does not disable the other events. If perf events
+///        are not permitted (see /proc/sys/kernel/
+///        perf_event_paranoid) or not supported by the
+///        operating system all events are unavailable.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef PERFCOUNTERS_HPP
+#define PERFCOUNTERS_HPP
+
+#include <stdint.h>
+#include <array>
+
+namespace primesieve {
+
+class PerfCounters
+{
+public:
+  enum Event
+  {
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,
+    LLC_MISSES,
+    DTLB_MISSES,
+    BRANCH_MISSES,
+    EVENTS
+  };
+
+  struct Values
+  {
+    std::array<uint64_t, EVENTS> counts;
+    std::array<bool, EVENTS> available;
+    Values() { counts.fill(0); available.fill(false); }
+    bool isAvailable() const;
+    Values& operator+=(const Values&);
+  };
+
+  PerfCounters() { fds_.fill(-1); }
+  ~PerfCounters();
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+  void start();
+  void stop();
+  const Values& getValues() const { return values_; }
+  static const char* getName(int event);
+
+private:
+  std::array<int, EVENTS> fds_;
+  bool isOpen_ = false;
+  Values values_;
+  void open();
+};
+
+} // namespace
+
+#endif
@@ -17,6 +17,8 @@
 
 namespace primesieve {
 
+class ShmSegment;
+
 /// PreSieve objects are used to pre-sieve multiples of small primes
 /// e.g. <= 19 to speed up the sieve of Eratosthenes. The idea is to
 /// allocate an array (buffer_) and remove the multiples of small
@@ -36,19 +38,26 @@ namespace primesieve {
 /// - PreSieve multiples of primes <= 19 uses  323.32 kilobytes
 /// - PreSieve multiples of primes <= 23 uses    7.44 megabytes
 ///
+/// If shared memory is enabled the larger buffers are
+/// shared by all primesieve processes.
+///
 class PreSieve
 {
 public:
   void init(uint64_t, uint64_t);
   uint64_t getMaxPrime() const { return maxPrime_; }
+  uint64_t getMemoryUsage() const { return size_; }
   void copy(byte_t*, uint64_t, uint64_t) const;
+  static void removeShared();
 private:
   uint64_t maxPrime_ = 0;
   uint64_t primeProduct_ = 0;
   uint64_t size_ = 0;
-  byte_t* buffer_ = nullptr;
+  const byte_t* buffer_ = nullptr;
   std::unique_ptr<byte_t[]> deleter_;
+  std::shared_ptr<const ShmSegment> shm_;
   void initBuffer(uint64_t, uint64_t);
+  void sieveBuffer(byte_t*) const;
 };
 
 } // namespace
@@ -0,0 +1,84 @@
+///
+/// @file  PrevPrimeGenerator.hpp
+///        Generates the primes below the current position of
+///        primesieve::iterator in descending order of blocks.
+///        The intervals passed to init() are sieved top down
+///        and PrevPrimeGenerator keeps its sieving primes,
+///        pre-sieve buffer, sieve array and bucket memory
+///        between the intervals.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef PREVPRIMEGENERATOR_HPP
+#define PREVPRIMEGENERATOR_HPP
+
+#include "Erat.hpp"
+#include "PreSieve.hpp"
+#include "types.hpp"
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+namespace primesieve {
+
+class PrevPrimeGenerator : public Erat
+{
+public:
+  void init(uint64_t start, uint64_t stop);
+  void fill(std::vector<uint64_t>& primes, std::size_t* size);
+  bool finished() const;
+  uint64_t getMemoryUsage() const;
+private:
+  /// Lower bound of the bitmap_
+  uint64_t low_ = 0;
+  /// Primes inside [smallStart_, smallStop_] are
+  /// not sieved but copied from a lookup table
+  uint64_t smallStart_ = 1;
+  uint64_t smallStop_ = 0;
+  /// Number of 64-bit words of bitmap_ not yet decoded
+  std::size_t words_ = 0;
+  /// Sieve of Eratosthenes bitmap of [start, stop]
+  std::vector<byte_t> bitmap_;
+  /// Next sieving prime to add
+  uint64_t prime_ = 0;
+  /// gaps_ contains the sieving primes <= sqrtStop_
+  uint64_t sqrtStop_ = 0;
+  /// The prime preceding the first sieving prime
+  uint64_t gapsBase_ = 0;
+  uint64_t gapsPrime_ = 0;
+  std::size_t gapsIdx_ = 0;
+  /// The sieving primes are stored compactly as half the
+  /// distance to the previous sieving prime, this fits into
+  /// one byte for all primes < 2^32.
+  std::vector<uint8_t> gaps_;
+  PreSieve preSieve_;
+  void initSievingPrimes();
+  uint64_t nextSievingPrime();
+  void sieve();
+  void fillSmallPrimes(std::vector<uint64_t>&, std::size_t*);
+};
+
+/// All primes of the current interval have been returned
+inline bool PrevPrimeGenerator::finished() const
+{
+  return words_ == 0 &&
+         smallStart_ > smallStop_;
+}
+
+/// Sieving memory in bytes
+inline uint64_t PrevPrimeGenerator::getMemoryUsage() const
+{
+  return Erat::getMemoryUsage() +
+         preSieve_.getMemoryUsage() +
+         bitmap_.capacity() +
+         gaps_.capacity();
+}
+
+} // namespace
+
+#endif
@@ -0,0 +1,46 @@
+///
+/// @file  PrimeBitmap.hpp
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef PRIMEBITMAP_HPP
+#define PRIMEBITMAP_HPP
+
+#include "types.hpp"
+
+#include <stdint.h>
+#include <cstddef>
+
+namespace primesieve {
+
+/// PrimeBitmap contains the primes < 2^20 using the layout of
+/// the sieve array (1 byte per 30 numbers, the first byte
+/// corresponds to [7, 31]) and the number of primes below each
+/// block of 64 bytes. It uses about 35 kilobytes, it is
+/// generated on first use and then answers prime counting,
+/// nth prime and primality queries of small numbers using
+/// table lookups. It is also the source of the sieving
+/// primes of SmallSieve and SievingPrimes.
+///
+class PrimeBitmap
+{
+public:
+  /// The bitmap contains the primes < MAX
+  static constexpr uint64_t MAX = 1 << 20;
+  static bool isPrime(uint64_t n);
+  static uint64_t primePi(uint64_t n);
+  static uint64_t nthPrime(uint64_t n);
+  static std::size_t getPrimes(uint64_t* start,
+                               uint64_t stop,
+                               uint64_t* primes,
+                               std::size_t maxSize);
+  static const byte_t* getSieve();
+};
+
+} // namespace
+
+#endif
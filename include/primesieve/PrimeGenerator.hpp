@@ -16,12 +16,12 @@
 #define PRIMEGENERATOR_HPP
 
 #include "Erat.hpp"
+#include "decodePrimes.hpp"
 #include "PreSieve.hpp"
-#include "littleendian_cast.hpp"
+#include "PrimeBitmap.hpp"
 #include "SievingPrimes.hpp"
 
 #include <stdint.h>
-#include <array>
 #include <vector>
 
 namespace primesieve {
@@ -30,6 +30,8 @@ class PrimeGenerator : public Erat
 {
 public:
   PrimeGenerator(uint64_t start, uint64_t stop);
+  void init(uint64_t start, uint64_t stop);
+  void skipto(uint64_t n);
   void fill(std::vector<uint64_t>&);
 
   bool finished() const
@@ -37,11 +39,23 @@ public:
     return finished_;
   }
 
+  /// Sieving memory in bytes
+  uint64_t getMemoryUsage() const
+  {
+    return Erat::getMemoryUsage() +
+           preSieve_.getMemoryUsage() +
+           sievingPrimes_.getMemoryUsage();
+  }
+
+  /// The primes <= maxCachedPrime() are
+  /// read from PrimeBitmap instead of sieving.
+  ///
   static uint64_t maxCachedPrime()
   {
-    return smallPrimes.back();
+    return PrimeBitmap::MAX - 1;
   }
 
+  /// @pre primes.size() >= 64
   void fill(std::vector<uint64_t>& primes,
             std::size_t* size)
   {
@@ -49,28 +63,24 @@ public:
       if (!sieveSegment(primes, size))
         return;
 
-    std::size_t i = 0;
-    uint64_t bits = littleendian_cast<uint64_t>(&sieve_[sieveIdx_]);
-    sieveIdx_ += 8;
-
-    for (; bits != 0; i++)
-      primes[i] = nextPrime(&bits, low_);
+    // Each 64-bit word of the sieve array contains
+    // at most 64 primes, fill the primes buffer until
+    // it is nearly full or the segment is finished.
+    std::size_t maxSize = primes.size() - 64;
+    std::size_t i = decodePrimes(sieve_, &sieveIdx_, sieveSize_, &low_, &primes[0], maxSize);
 
     *size = i;
-    low_ += 8 * 30;
   }
 private:
   uint64_t low_ = 0;
   uint64_t sieveIdx_ = ~0ull;
   uint64_t prime_ = 0;
+  /// Next number to read from PrimeBitmap
+  uint64_t bitmapStart_ = 0;
   PreSieve preSieve_;
   SievingPrimes sievingPrimes_;
   bool isInit_ = false;
   bool finished_ = false;
-  static const std::array<uint64_t, 64> smallPrimes;
-  static const std::array<uint8_t, 312> primePi;
-  std::size_t getStartIdx() const;
-  std::size_t getStopIdx() const;
   void initErat();
   void init(std::vector<uint64_t>&);
   void init(std::vector<uint64_t>&, std::size_t*);
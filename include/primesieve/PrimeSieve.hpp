@@ -13,9 +13,12 @@
 #ifndef PRIMESIEVE_CLASS_HPP
 #define PRIMESIEVE_CLASS_HPP
 
+#include "PerfCounters.hpp"
 #include "PreSieve.hpp"
+#include "SieveStats.hpp"
 #include <stdint.h>
 #include <array>
+#include <vector>
 
 namespace primesieve {
 
@@ -67,6 +70,11 @@ public:
   int getSieveSize() const;
   double getSeconds() const;
   PreSieve& getPreSieve();
+  uint64_t getTableStep() const;
+  bool getNextCheckpoint(uint64_t*) const;
+  std::vector<counts_t>& getTable();
+  uint64_t getLinearA() const;
+  int64_t getLinearB() const;
   // Setters
   void setStart(uint64_t);
   void setStop(uint64_t);
@@ -74,6 +82,8 @@ public:
   void setSieveSize(int);
   void setFlags(int);
   void addFlags(int);
+  void setTableStep(uint64_t);
+  void setLinearForm(uint64_t, int64_t);
   // Bool is*
   bool isCount(int) const;
   bool isCountPrimes() const;
@@ -85,6 +95,7 @@ public:
   bool isFlag(int) const;
   bool isFlag(int, int) const;
   bool isStatus() const;
+  bool isLinearForm() const;
   // Sieve
   virtual void sieve();
   void sieve(uint64_t, uint64_t);
@@ -96,6 +107,11 @@ public:
   counts_t& getCounts();
   uint64_t getCount(int) const;
   uint64_t countPrimes(uint64_t, uint64_t);
+  // Per-phase timing statistics
+  SieveStats& getStats();
+  // Hardware performance counters
+  void setPerfCounters(bool);
+  const std::vector<PerfCounters::Values>& getPerfValues() const;
 
 protected:
   /// Sieve primes >= start_
@@ -104,14 +120,30 @@ protected:
   uint64_t stop_ = 0;
   /// Time elapsed of sieve()
   double seconds_ = 0;
+  /// Time elapsed of each sieving phase
+  SieveStats stats_;
+  /// Count hardware events of each thread
+  bool isPerf_ = false;
+  /// Hardware events of each thread, summed over all
+  /// sieve() calls since setPerfCounters(true)
+  std::vector<PerfCounters::Values> perfValues_;
   /// Sieving status in percent
   double percent_ = 0;
   /// Prime number and prime k-tuplet counts
   counts_t counts_;
+  /// Record the counts at each multiple of tableStep_
+  uint64_t tableStep_ = 0;
+  /// Counts inside [start_, checkpoint] for each checkpoint
+  std::vector<counts_t> table_;
+  /// Count the primes p for which linearA_ * p + linearB_
+  /// is also prime, linearA_ = 0 = disabled
+  uint64_t linearA_ = 0;
+  int64_t linearB_ = 0;
   /// Used for communication with the Qt GUI app
   SharedMemory* sharedMemory_ = nullptr;
   void reset();
   void setStatus(double);
+  int fitMaxMemory(int);
 
 private:
   uint64_t sievedDistance_ = 0;
@@ -124,6 +156,9 @@ private:
   ParallelSieve* parent_ = nullptr;
   PreSieve preSieve_;
   void processSmallPrimes();
+  bool isSmallSieve() const;
+  void sievePrimes();
+  void correctTable();
   static void printStatus(double, double);
 };
 
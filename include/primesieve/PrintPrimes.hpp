@@ -30,11 +30,16 @@ class PrintPrimes : public Erat
 public:
   PrintPrimes(PrimeSieve&);
   void sieve();
-private:
   enum { END = 0xff + 1 };
+  /// Bitmasks of the prime k-tuplets inside a byte of the
+  /// sieve array, also used by TupletGenerator
   static const uint64_t bitmasks_[6][5];
+private:
   uint64_t low_ = 0;
-  /// Count lookup tables for prime k-tuplets
+  /// Next multiple of the table step
+  uint64_t checkpoint_ = 0;
+  bool isCheckpoint_ = false;
+  /// Count lookup tables for primes and prime k-tuplets
   std::vector<byte_t> kCounts_[6];
   counts_t& counts_;
   /// Reference to the associated PrimeSieve object
@@ -43,6 +48,8 @@ private:
   void print();
   void countPrimes();
   void countkTuplets();
+  void countCheckpoints();
+  void countBytes(const byte_t*, const byte_t*, counts_t&) const;
   void printPrimes() const;
   void printkTuplets() const;
 };
@@ -0,0 +1,82 @@
+///
+/// @file  Profile.hpp
+///        Per-host tuning profile. The profile stores the settings
+///        found by primesieve --tune: the sieve size, the bucket
+///        size, the EratSmall and EratMedium thresholds and the
+///        default number of threads. It is a text file with one
+///        "key = value" setting per line, by default
+///        $XDG_CONFIG_HOME/primesieve/profile (or
+///        ~/.config/primesieve/profile). The PRIMESIEVE_PROFILE
+///        environment variable overrides the default path, an
+///        empty PRIMESIEVE_PROFILE disables the profile.
+///
+///        The profile is read on first use. Settings of the API
+///        e.g. set_sieve_size() and set_num_threads() take
+///        precedence over the profile.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef PROFILE_HPP
+#define PROFILE_HPP
+
+#include "config.hpp"
+#include <string>
+
+namespace primesieve {
+
+struct Profile
+{
+  /// Sieve size in KiB, 0 = based on the CPU's cache sizes
+  int sieveSize = 0;
+  /// Default number of threads, 0 = all CPU threads
+  int threads = 0;
+  /// Largest bucket size class of the MemoryPool, i.e. the
+  /// max number of sieving primes processed per bucket.
+  int bucketBytes = config::BUCKET_BYTES;
+  /// See config::FACTOR_ERATSMALL
+  double factorEratSmall = config::FACTOR_ERATSMALL;
+  /// See config::FACTOR_ERATMEDIUM
+  double factorEratMedium = config::FACTOR_ERATMEDIUM;
+
+  /// Clamp the settings to their valid ranges
+  void check();
+
+  /// Read the settings from the profile file.
+  /// @return false if the file does not exist.
+  /// @throw primesieve_error if the file is invalid.
+  ///
+  bool read(const std::string& filename);
+
+  /// Write the settings to the profile file, the
+  /// parent directory is created if needed.
+  ///
+  void write(const std::string& filename) const;
+
+  /// Empty if there is no profile path
+  static std::string getDefaultPath();
+
+  /// Get the current profile, on first use the profile
+  /// is read from getDefaultPath(). If that profile is
+  /// invalid a warning is printed once and the built-in
+  /// defaults are used.
+  ///
+  static const Profile& get();
+
+  /// Replace the current profile (not thread safe,
+  /// must not be called while sieving).
+  ///
+  static void set(const Profile& profile);
+
+  /// Read the profile from the file, an empty
+  /// filename resets the built-in defaults.
+  ///
+  static void use(const std::string& filename);
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,67 @@
+///
+/// @file  ShmSegment.hpp
+///        Read-only data that is identical in all primesieve
+///        processes (sieving primes, pre-sieve buffers) can be
+///        stored in a POSIX shared memory segment. The first
+///        process creates and fills the segment, all other
+///        processes map it read-only. If shared memory is
+///        disabled, not supported or the segment cannot be
+///        used, the data is stored in private memory.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef SHMSEGMENT_HPP
+#define SHMSEGMENT_HPP
+
+#include <stdint.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace primesieve {
+
+class ShmSegment
+{
+public:
+  /// Fills the data of a new segment, returns the
+  /// number of bytes used (<= maxSize).
+  using fill_t = std::function<std::size_t(uint8_t* data, std::size_t maxSize)>;
+
+  /// Map the shared memory segment with the given name,
+  /// if the segment does not exist yet it is created and
+  /// filled using fill(). Returns nullptr if the data
+  /// must be stored in private memory.
+  ///
+  static std::shared_ptr<const ShmSegment> get(const std::string& name,
+                                               std::size_t maxSize,
+                                               const fill_t& fill);
+
+  /// Delete the segment, processes that
+  /// have mapped it can still use it.
+  static void remove(const std::string& name);
+
+  /// Shared memory is disabled by default
+  static void enable(bool enabled);
+  static bool isEnabled();
+
+  ShmSegment(void* map, std::size_t mapSize);
+  ShmSegment(const ShmSegment&) = delete;
+  ShmSegment& operator=(const ShmSegment&) = delete;
+  ~ShmSegment();
+
+  const uint8_t* getData() const;
+  std::size_t getSize() const;
+
+private:
+  void* map_;
+  std::size_t mapSize_;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,126 @@
+///
+/// @file  SieveStats.hpp
+/// @brief Per-phase timing statistics of the segmented sieve of
+///        Eratosthenes. The phases are timed using a cycle
+///        counter (rdtsc on x86) only if primesieve has been
+///        built with -DENABLE_STATS, otherwise PhaseTimer is
+///        an empty class and the timing code is optimized away.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef SIEVESTATS_HPP
+#define SIEVESTATS_HPP
+
+#include <stdint.h>
+#include <array>
+#include <chrono>
+
+#if defined(ENABLE_STATS) && \
+   (defined(__x86_64__) || defined(__i386__))
+  #include <x86intrin.h>
+  #define HAS_RDTSC
+#elif defined(ENABLE_STATS) && \
+     (defined(_M_X64) || defined(_M_IX86))
+  #include <intrin.h>
+  #define HAS_RDTSC
+#endif
+
+namespace primesieve {
+
+struct SieveStats
+{
+  enum Phase
+  {
+    PRE_SIEVE,
+    ERAT_SMALL,
+    ERAT_MEDIUM,
+    ERAT_BIG,
+    SIEVING_PRIMES,
+    COUNT,
+    PRINT,
+    PHASES
+  };
+
+  /// Elapsed ticks of each phase
+  std::array<uint64_t, PHASES> ticks;
+  /// Elapsed seconds of each phase
+  std::array<double, PHASES> seconds;
+  /// Number of sieved segments
+  uint64_t segments;
+
+  SieveStats() { reset(); }
+  void reset();
+  void calibrate(uint64_t ticks, double seconds);
+  SieveStats& operator+=(const SieveStats&);
+  static const char* getName(int phase);
+  static SieveStats getGlobal();
+  static void addGlobal(const SieveStats&);
+  static void resetGlobal();
+
+  static bool isEnabled()
+  {
+#if defined(ENABLE_STATS)
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /// Time stamp counter, the ticks of a phase are later
+  /// converted to seconds using calibrate().
+  ///
+  static uint64_t now()
+  {
+#if defined(HAS_RDTSC)
+    return __rdtsc();
+#else
+    auto t = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t).count();
+#endif
+  }
+};
+
+/// Adds the ticks elapsed between its construction and
+/// destruction to the given phase. stats = nullptr
+/// disables timing.
+///
+#if defined(ENABLE_STATS)
+
+class PhaseTimer
+{
+public:
+  PhaseTimer(SieveStats* stats, SieveStats::Phase phase) :
+    stats_(stats),
+    phase_(phase)
+  {
+    if (stats_)
+      start_ = SieveStats::now();
+  }
+  ~PhaseTimer()
+  {
+    if (stats_)
+      stats_->ticks[phase_] += SieveStats::now() - start_;
+  }
+private:
+  SieveStats* stats_;
+  SieveStats::Phase phase_;
+  uint64_t start_ = 0;
+};
+
+#else
+
+class PhaseTimer
+{
+public:
+  PhaseTimer(SieveStats*, SieveStats::Phase) { }
+};
+
+#endif
+
+} // namespace
+
+#endif
@@ -13,11 +13,12 @@
 #include "Erat.hpp"
 
 #include <stdint.h>
-#include <vector>
+#include <memory>
 
 namespace primesieve {
 
 class PreSieve;
+class SievingPrimesCache;
 
 class SievingPrimes : public Erat
 {
@@ -26,6 +27,7 @@ public:
   SievingPrimes(Erat*, PreSieve&);
   void init(Erat*, PreSieve&);
   uint64_t next();
+  uint64_t getMemoryUsage() const;
 private:
   uint64_t i_ = 0;
   uint64_t size_ = 0;
@@ -33,9 +35,16 @@ private:
   uint64_t tinyIdx_ = 0;
   uint64_t sieveIdx_ = ~0ull;
   uint64_t primes_[64];
-  std::vector<char> tinySieve_;
+  /// If the sieving primes cache file is used the
+  /// primes are decoded from its gaps_
+  std::shared_ptr<const SievingPrimesCache> cache_;
+  const uint8_t* gaps_ = nullptr;
+  uint64_t gapsIdx_ = 0;
+  uint64_t gapsSize_ = 0;
+  uint64_t gapsPrime_ = 0;
   void fill();
-  void tinySieve();
+  void fillCache();
+  void initCache(uint64_t, uint64_t);
   bool sieveSegment();
 };
 
@@ -47,6 +56,11 @@ inline uint64_t SievingPrimes::next()
   return primes_[i_++];
 }
 
+inline uint64_t SievingPrimes::getMemoryUsage() const
+{
+  return Erat::getMemoryUsage();
+}
+
 } // namespace
 
 #endif
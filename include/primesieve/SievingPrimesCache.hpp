@@ -0,0 +1,82 @@
+///
+/// @file  SievingPrimesCache.hpp
+///        Cache file of the sieving primes. Sieving near 2^64
+///        requires the 203 million primes below 2^32, generating
+///        these takes about 1 second per thread. The cache file
+///        stores each prime as half the distance to the previous
+///        prime (1 byte) and it is memory mapped read-only, hence
+///        its pages are shared by all threads and processes that
+///        use the same file. Without cache file the sieving primes
+///        can also be shared using shared memory.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef SIEVINGPRIMESCACHE_HPP
+#define SIEVINGPRIMESCACHE_HPP
+
+#include <stdint.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace primesieve {
+
+class ShmSegment;
+
+class SievingPrimesCache
+{
+public:
+  /// Store the odd primes <= maxPrime in a cache file
+  /// @pre maxPrime <= 2^32
+  static void build(const std::string& filename, uint64_t maxPrime);
+
+  /// Use the cache file for all sieving that starts afterwards,
+  /// an empty filename disables the cache.
+  /// @throw primesieve_error if the file is invalid.
+  ///
+  static void use(const std::string& filename);
+
+  /// Returns a cache that contains all primes <= maxPrime,
+  /// the cache file is used if it is large enough, else the
+  /// shared memory cache (if enabled). Returns nullptr if
+  /// there is no such cache.
+  ///
+  static std::shared_ptr<const SievingPrimesCache> get(uint64_t maxPrime);
+
+  /// Delete the shared memory caches
+  static void removeShared();
+
+  SievingPrimesCache(const std::string& filename);
+  SievingPrimesCache(std::shared_ptr<const ShmSegment> shm);
+  SievingPrimesCache(const SievingPrimesCache&) = delete;
+  SievingPrimesCache& operator=(const SievingPrimesCache&) = delete;
+  ~SievingPrimesCache();
+
+  /// (prime - previous prime) / 2, the
+  /// previous prime of the first prime is 1
+  const uint8_t* getGaps() const { return gaps_; }
+  uint64_t getSize() const { return size_; }
+  /// All primes <= getMaxPrime() are in the cache
+  uint64_t getMaxPrime() const { return maxPrime_; }
+
+private:
+  const uint8_t* gaps_ = nullptr;
+  uint64_t size_ = 0;
+  uint64_t maxPrime_ = 0;
+  /// Memory mapped file
+  void* map_ = nullptr;
+  std::size_t mapSize_ = 0;
+  /// Used if memory mapping is not supported
+  std::vector<uint8_t> buffer_;
+  std::shared_ptr<const ShmSegment> shm_;
+  bool init(const uint8_t* bytes, uint64_t bytesSize);
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,53 @@
+///
+/// @file  SmallSieve.hpp
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef SMALLSIEVE_HPP
+#define SMALLSIEVE_HPP
+
+#include "config.hpp"
+#include "PrimeSieve.hpp"
+#include "types.hpp"
+
+#include <stdint.h>
+
+namespace primesieve {
+
+/// SmallSieve counts the primes and prime k-tuplets inside
+/// small intervals below 2^32 without any heap allocation.
+/// The whole interval is sieved at once using a sieve array
+/// on the stack and the sieving primes from PrimeBitmap.
+/// Intervals below 2^20 (of any size) are read from
+/// PrimeBitmap instead.
+///
+class SmallSieve
+{
+public:
+  static bool isSmall(uint64_t start, uint64_t stop);
+  SmallSieve(uint64_t start, uint64_t stop);
+  void count(PrimeSieve& ps) const;
+private:
+  uint64_t start_;
+  uint64_t stop_;
+  /// sieve_[i] corresponds to the numbers
+  /// [low_ + i * 30 + 7, low_ + i * 30 + 31]
+  uint64_t low_;
+  uint64_t size_;
+  /// Points to buffer_ or into PrimeBitmap
+  const byte_t* sieve_;
+  byte_t firstMask_;
+  byte_t lastMask_;
+  alignas(8) byte_t buffer_[config::SMALL_SIEVE_BYTES];
+  void initMasks();
+  void preSieve();
+  void crossOff(uint32_t prime);
+};
+
+} // namespace
+
+#endif
@@ -2,7 +2,7 @@
 /// @file   StorePrimes.hpp
 /// @brief  Store primes in a vector.
 ///
-/// Copyright (C) 2018 Kim Walisch, <kim.walisch@gmail.com>
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
 ///
 /// This file is distributed under the BSD License. See the COPYING
 /// file in the top level directory.
@@ -12,6 +12,7 @@
 #define STOREPRIMES_HPP
 
 #include "iterator.hpp"
+#include "prime_count_approx.hpp"
 #include "primesieve_error.hpp"
 
 #include <stdint.h>
@@ -22,28 +23,20 @@
 
 namespace primesieve {
 
-/// primeCountApprox(x) >= pi(x)
-inline std::size_t prime_count_approx(uint64_t start, uint64_t stop)
-{
-  if (start > stop)
-    return 0;
-  if (stop <= 10)
-    return 4;
-
-  // pi(x) <= x / (log(x) - 1.1) + 5, for x >= 4
-  double x = (double) stop;
-  double logx = std::log(x);
-  double div = logx - 1.1;
-  double pix = (stop - start) / div + 5;
-
-  return (std::size_t) pix;
-}
+/// Declared in primesieve.hpp
+uint64_t count_primes(uint64_t start, uint64_t stop);
+bool is_exact_reserve();
 
 template <typename T>
 inline void store_primes(uint64_t start,
                          uint64_t stop,
                          T& primes)
 {
+  std::size_t count = 0;
+
+  if (is_exact_reserve())
+    count = (std::size_t) count_primes(start, stop);
+
   if (start > 0)
     start--;
   if (~stop == 0)
@@ -52,8 +45,9 @@ inline void store_primes(uint64_t start,
   if (start < stop)
   {
     using V = typename T::value_type;
-    std::size_t size = primes.size() + prime_count_approx(start, stop);
-    primes.reserve(size);
+    if (!is_exact_reserve())
+      count = prime_count_approx(start, stop);
+    primes.reserve(primes.size() + count);
 
     primesieve::iterator it(start, stop);
     uint64_t prime = it.next_prime();
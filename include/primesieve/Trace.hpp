@@ -0,0 +1,119 @@
+///
+/// @file  Trace.hpp
+/// @brief Records what each thread of primesieve does over time
+///        (chunks, segments, sieving primes generation, status
+///        updates, waiting for threads) and writes the events
+///        to a Chrome trace JSON file which can be viewed using
+///        chrome://tracing or https://ui.perfetto.dev.
+///
+///        Tracing is disabled by default. Each thread records its
+///        events into its own ring buffer without locking, if a
+///        ring buffer is full the oldest events are overwritten.
+///        If tracing is disabled TraceScope only checks a flag.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+
+namespace primesieve {
+
+class Trace
+{
+public:
+  enum Event
+  {
+    SIEVE,
+    CHUNK,
+    SEGMENT,
+    SIEVING_PRIMES,
+    STATUS,
+    WAIT,
+    EVENTS
+  };
+
+  /// Max number of events per thread
+  static constexpr uint64_t RING_SIZE = 1 << 16;
+
+  /// Discard all events and start recording,
+  /// the calling thread is named "main".
+  /// @pre No thread is recording events.
+  ///
+  static void start();
+
+  /// Stop recording
+  static void stop();
+
+  static bool isEnabled()
+  {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /// Nanoseconds elapsed since start()
+  static uint64_t now();
+
+  /// Add an event to the ring buffer of the calling thread
+  static void record(Event event,
+                     uint64_t begin,
+                     uint64_t end,
+                     uint64_t arg1,
+                     uint64_t arg2);
+
+  /// Name of the calling thread in the trace
+  static void setThreadName(const std::string& name);
+
+  /// Number of events that have been overwritten
+  static uint64_t getDropped();
+
+  /// Write all recorded events to a Chrome trace JSON file.
+  /// @pre No thread is recording events.
+  ///
+  static void write(const std::string& filename);
+
+private:
+  static std::atomic<bool> enabled_;
+};
+
+/// Records an event from its construction to its destruction
+class TraceScope
+{
+public:
+  TraceScope(Trace::Event event, uint64_t arg1 = 0, uint64_t arg2 = 0) :
+    event_(event),
+    arg1_(arg1),
+    arg2_(arg2),
+    enabled_(Trace::isEnabled())
+  {
+    if (enabled_)
+      begin_ = Trace::now();
+  }
+  ~TraceScope()
+  {
+    if (enabled_)
+      Trace::record(event_, begin_, Trace::now(), arg1_, arg2_);
+  }
+  void setArg2(uint64_t arg2)
+  {
+    arg2_ = arg2;
+  }
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+private:
+  Trace::Event event_;
+  uint64_t arg1_;
+  uint64_t arg2_;
+  uint64_t begin_ = 0;
+  bool enabled_;
+};
+
+} // namespace
+
+#endif
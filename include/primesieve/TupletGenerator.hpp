@@ -0,0 +1,62 @@
+///
+/// @file  TupletGenerator.hpp
+///        Generates the prime k-tuplets inside [start, stop] for
+///        primesieve::tuplet_iterator. The k-tuplets are found
+///        directly in the sieve array using the bitmasks of
+///        PrintPrimes, the other primes are never decoded.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef TUPLETGENERATOR_HPP
+#define TUPLETGENERATOR_HPP
+
+#include "Erat.hpp"
+#include "PreSieve.hpp"
+#include "SievingPrimes.hpp"
+
+#include <stdint.h>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace primesieve {
+
+class TupletGenerator : public Erat
+{
+public:
+  TupletGenerator(int k);
+  void init(uint64_t start, uint64_t stop);
+  void fill(std::vector<uint64_t>& tuplets, std::size_t* size);
+  static uint64_t alignStop(uint64_t stop);
+
+  bool finished() const
+  {
+    return finished_;
+  }
+
+private:
+  int k_;
+  /// Bitmasks of the k-tuplets inside a byte
+  const uint64_t* bitmasks_;
+  /// The bitmasks repeated for each byte of a 64-bit word
+  std::array<uint64_t, 4> wordmasks_;
+  std::size_t masks_ = 0;
+  uint64_t low_ = 0;
+  uint64_t sieveIdx_ = ~0ull;
+  uint64_t prime_ = 0;
+  bool isInit_ = false;
+  bool finished_ = false;
+  PreSieve preSieve_;
+  SievingPrimes sievingPrimes_;
+  void initErat();
+  void fillSmallTuplets(std::vector<uint64_t>&, std::size_t*);
+  bool sieveSegment();
+};
+
+} // namespace
+
+#endif
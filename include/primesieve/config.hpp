@@ -27,21 +27,47 @@ enum {
   ///
   BUCKET_BYTES = 1 << 13,
 
+  /// Smallest bucket size class of the MemoryPool, used for
+  /// sparsely populated bucket lists e.g. when sieving small
+  /// intervals. @pre MIN_BUCKET_BYTES must be a power of 2.
+  ///
+  MIN_BUCKET_BYTES = 1 << 10,
+
   /// The MemoryPool allocates at most MAX_ALLOC_BYTES of new
   /// memory when it runs out of buckets.
   ///
   MAX_ALLOC_BYTES = (1 << 20) * 16,
 
-  /// iterator::prev_prime() caches at least MIN_CACHE_ITERATOR
-  /// bytes of primes. Larger is usually faster but also
-  /// requires more memory.
+  /// iterator::next_prime() and iterator::next_primes() generate
+  /// up to ITERATOR_BUFFER_SIZE primes at once.
+  /// @pre ITERATOR_BUFFER_SIZE >= 64
+  ///
+  ITERATOR_BUFFER_SIZE = 1 << 10,
+
+  /// iterator::prev_prime() sieves intervals whose bitmap
+  /// uses at least MIN_CACHE_ITERATOR bytes. Larger is
+  /// usually faster but also requires more memory.
   ///
   MIN_CACHE_ITERATOR = (1 << 20) * 8,
 
-  /// iterator::prev_prime() maximum cache size in bytes, used
-  /// if pi(sqrt(n)) * 8 bytes > MAX_CACHE_ITERATOR.
+  /// iterator::prev_prime() maximum bitmap size in bytes,
+  /// used if sqrt(n) * 8 / 30 bytes > MAX_CACHE_ITERATOR.
+  ///
+  MAX_CACHE_ITERATOR = (1 << 20) * 1024,
+
+  /// The sieving primes cache file (if used) is only read if
+  /// the sieving primes up to at least this number are needed,
+  /// generating fewer sieving primes is very fast.
+  ///
+  MIN_SIEVING_PRIMES_CACHE = 1 << 20,
+
+  /// Counting the primes inside [start, stop] with stop < 2^20
+  /// or with stop < 2^32 and (stop - start) / 30 < SMALL_SIEVE_BYTES
+  /// uses SmallSieve, whose sieve array is allocated on the
+  /// stack. For larger intervals Erat's pre-sieving and
+  /// segmentation are faster.
   ///
-  MAX_CACHE_ITERATOR = (1 << 20) * 1024
+  SMALL_SIEVE_BYTES = 1 << 12
 };
 
   /// Sieving primes <= (sieveSize in bytes * FACTOR_ERATSMALL)
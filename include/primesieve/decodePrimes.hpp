@@ -0,0 +1,79 @@
+///
+/// @file  decodePrimes.hpp
+///        Decode the 1 bits of the sieve array into primes.
+///        There are multiple implementations (kernels), the
+///        fastest kernel supported by the CPU is selected at
+///        runtime.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef DECODEPRIMES_HPP
+#define DECODEPRIMES_HPP
+
+#include "types.hpp"
+
+#include <stdint.h>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace primesieve {
+
+extern const std::array<uint64_t, 64> bruijnBitValues;
+
+/// Reconstruct the prime number corresponding to
+/// the first set bit and unset that bit
+///
+inline uint64_t nextPrime(uint64_t* bits, uint64_t low)
+{
+  // calculate bitValues[bitScanForward(*bits)]
+  // using a custom De Bruijn bitscan
+  uint64_t debruijn = 0x3F08A4C6ACB9DBDull;
+  uint64_t mask = *bits - 1;
+  uint64_t bitValue = bruijnBitValues[((*bits ^ mask) * debruijn) >> 58];
+  uint64_t prime = low + bitValue;
+  *bits &= mask;
+  return prime;
+}
+
+/// Decode the 64-bit words of the sieve array starting at
+/// sieve[*sieveIdx] into primes, each word contains the
+/// numbers [*low, *low + 240[. Stops after the first word
+/// once more than maxSize primes have been decoded or at
+/// the end of the sieve array. Returns the number of primes,
+/// sieveIdx and low are moved forward.
+/// @pre primes has space for maxSize + 64 primes.
+///
+using decodePrimes_t = std::size_t (*)(const byte_t* sieve,
+                                       uint64_t* sieveIdx,
+                                       uint64_t sieveSize,
+                                       uint64_t* low,
+                                       uint64_t* primes,
+                                       std::size_t maxSize);
+
+struct DecodeKernel
+{
+  const char* name;
+  decodePrimes_t decode;
+};
+
+/// Kernels supported by the compiler and the
+/// CPU, ordered from fastest to slowest.
+///
+std::vector<DecodeKernel> getDecodeKernels();
+
+/// Decode using the fastest kernel
+std::size_t decodePrimes(const byte_t* sieve,
+                         uint64_t* sieveIdx,
+                         uint64_t sieveSize,
+                         uint64_t* low,
+                         uint64_t* primes,
+                         std::size_t maxSize);
+
+} // namespace
+
+#endif
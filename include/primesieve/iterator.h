@@ -30,6 +30,9 @@
 extern "C" {
 #endif
 
+/** Size of the primesieve_iterator state in bytes */
+#define PRIMESIEVE_ITERATOR_STATE_SIZE 48
+
 /**
  * C prime iterator, please refer to @link iterator.h iterator.h
  * @endlink for more information.
@@ -46,6 +49,12 @@ typedef struct
   void* vector;
   void* primeGenerator;
   int is_error;
+  /* Added in libprimesieve.so.10, the fields
+     above keep their offsets. */
+  uint64_t skipto;
+  void* prevPrimeGenerator;
+  void* chunkPolicy;
+  int mode;
 } primesieve_iterator;
 
 /** Initialize the primesieve iterator before first using it */
@@ -56,6 +65,10 @@ void primesieve_free_iterator(primesieve_iterator* it);
 
 /**
  * Reset the primesieve iterator to start.
+ * If start is inside the buffered primes or slightly larger,
+ * these are reused or the sieve of the current interval is
+ * moved forward. Otherwise a new interval is sieved, but the
+ * memory of the iterator is kept.
  * @param start      Generate primes > start (or < start).
  * @param stop_hint  Stop number optimization hint. E.g. if you want
  *                   to generate the primes below 1000 use
@@ -64,6 +77,44 @@ void primesieve_free_iterator(primesieve_iterator* it);
  */
 void primesieve_skipto(primesieve_iterator* it, uint64_t start, uint64_t stop_hint);
 
+/**
+ * Save the state of the primesieve iterator i.e. its current
+ * interval, the interval distance growth and its position into
+ * a small portable blob. This allows to resume long running
+ * scans after a restart.
+ * @param state  Buffer of PRIMESIEVE_ITERATOR_STATE_SIZE bytes.
+ */
+void primesieve_save_state(primesieve_iterator* it, uint8_t* state);
+
+/**
+ * Restore a state saved by primesieve_save_state(). Afterwards
+ * primesieve_next_prime() and primesieve_prev_prime() continue
+ * from the saved position. If the direction of the saved
+ * iterator is kept the following intervals are the same as
+ * those of the saved iterator. If the state is invalid
+ * primesieve_iterator.is_error is set to 1 and the iterator
+ * is not modified.
+ * @param state  Buffer of PRIMESIEVE_ITERATOR_STATE_SIZE bytes.
+ */
+void primesieve_restore_state(primesieve_iterator* it, const uint8_t* state);
+
+/**
+ * Limit the sieving memory of the primesieve iterator to about
+ * max_memory bytes, 0 means no limit (default). The intervals
+ * sieved by the iterator are shrunk to fit the limit, this also
+ * applies to an overly large stop_hint. Furthermore the intervals
+ * grow more slowly if the caller spends most of the time
+ * processing the primes. The memory of the sieving
+ * primes <= n^0.5 cannot be reduced.
+ */
+void primesieve_iterator_set_max_memory(primesieve_iterator* it, uint64_t max_memory);
+
+/**
+ * Current memory usage of the primesieve iterator in bytes i.e.
+ * its primes buffer, sieve arrays and sieving primes.
+ */
+uint64_t primesieve_iterator_memory_usage(primesieve_iterator* it);
+
 /** Internal use */
 void primesieve_generate_next_primes(primesieve_iterator*);
 
@@ -92,6 +143,27 @@ static inline uint64_t primesieve_prev_prime(primesieve_iterator* it)
   return it->primes[it->i];
 }
 
+/**
+ * Get the next block of primes in ascending order, the block can
+ * be processed using a tight loop. Afterwards
+ * primesieve_next_prime() continues after the last prime of the
+ * block. The last block contains UINT64_MAX if next prime > 2^64.
+ * The returned pointer is valid until the iterator is used again.
+ * @param size  Number of primes of the block (>= 1).
+ */
+const uint64_t* primesieve_next_primes(primesieve_iterator* it, size_t* size);
+
+/**
+ * Get the previous block of primes in ascending order, i.e. the
+ * primes below the current position. Afterwards
+ * primesieve_prev_prime() continues before the first prime of the
+ * block. If the first prime of the block is 0 there are no more
+ * primes below the second element. The returned pointer is valid
+ * until the iterator is used again.
+ * @param size  Number of primes of the block (>= 1).
+ */
+const uint64_t* primesieve_prev_primes(primesieve_iterator* it, size_t* size);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -20,6 +20,8 @@
 namespace primesieve {
 
 class PrimeGenerator;
+class PrevPrimeGenerator;
+class ChunkPolicy;
 
 uint64_t get_max_stop();
 
@@ -52,6 +54,10 @@ public:
   ~iterator();
 
   /// Reset the primesieve iterator to start.
+  /// If start is inside the buffered primes or slightly
+  /// larger, these are reused or the sieve of the current
+  /// interval is moved forward. Otherwise a new interval
+  /// is sieved, but the memory of the iterator is kept.
   /// @param start      Generate primes > start (or < start).
   /// @param stop_hint  Stop number optimization hint, gives significant
   ///                   speed up if few primes are generated. E.g. if
@@ -60,6 +66,37 @@ public:
   ///
   void skipto(uint64_t start, uint64_t stop_hint = get_max_stop());
 
+  /// Save the state of the iterator i.e. its current interval,
+  /// the interval distance growth and its position into a
+  /// small portable blob. This allows to resume long running
+  /// scans after a restart.
+  ///
+  std::vector<uint8_t> save_state() const;
+
+  /// Restore a state returned by save_state(). Afterwards
+  /// next_prime() and prev_prime() continue from the saved
+  /// position. If the direction of the saved iterator is kept
+  /// the following intervals are the same as those of the
+  /// saved iterator.
+  /// @throw primesieve_error if the state is invalid.
+  ///
+  void restore_state(const std::vector<uint8_t>& state);
+
+  /// Limit the sieving memory of the iterator to about
+  /// max_memory bytes, 0 means no limit (default). The
+  /// intervals sieved by the iterator are shrunk to fit the
+  /// limit, this also applies to an overly large stop_hint.
+  /// Furthermore the intervals grow more slowly if the caller
+  /// spends most of the time processing the primes. The memory
+  /// of the sieving primes <= n^0.5 cannot be reduced.
+  ///
+  void set_max_memory(uint64_t max_memory);
+
+  /// Current memory usage of the iterator in bytes i.e.
+  /// its primes buffer, sieve arrays and sieving primes.
+  ///
+  uint64_t memory_usage() const;
+
   /// Get the next prime.
   /// Returns UINT64_MAX if next prime > 2^64.
   ///
@@ -80,6 +117,27 @@ public:
     return primes_[i_];
   }
 
+  /// Get the next block of primes in ascending order, the
+  /// block can be processed using a tight loop. Afterwards
+  /// next_prime() continues after the last prime of the block.
+  /// The last block contains UINT64_MAX if next prime > 2^64.
+  /// @param size  Number of primes of the block (>= 1).
+  /// @return      Pointer to the first prime, valid until
+  ///              the iterator is used again.
+  ///
+  const uint64_t* next_primes(std::size_t* size);
+
+  /// Get the previous block of primes in ascending order,
+  /// i.e. the primes below the current position. Afterwards
+  /// prev_prime() continues before the first prime of the
+  /// block. If the first prime of the block is 0 there are
+  /// no more primes below the second element.
+  /// @param size  Number of primes of the block (>= 1).
+  /// @return      Pointer to the first prime, valid until
+  ///              the iterator is used again.
+  ///
+  const uint64_t* prev_primes(std::size_t* size);
+
 private:
   std::size_t i_;
   std::size_t last_idx_;
@@ -88,7 +146,14 @@ private:
   uint64_t stop_;
   uint64_t stop_hint_;
   uint64_t dist_;
+  /// skipto() start number if the buffered primes or the
+  /// current PrimeGenerator are reused, else 0
+  uint64_t skipto_;
+  /// Direction of the iterator (IteratorState::Mode)
+  int mode_;
   std::unique_ptr<PrimeGenerator> primeGenerator_;
+  std::unique_ptr<PrevPrimeGenerator> prevPrimeGenerator_;
+  std::unique_ptr<ChunkPolicy> chunkPolicy_;
   void generate_next_primes();
   void generate_prev_primes();
 };
@@ -43,9 +43,9 @@ public:
 
   void push_back(const T& val)
   {
-    array_[size_++] = val;
     if (size_ >= capacity_)
       resize(size_ * 2);
+    array_[size_++] = val;
   }
 
   void reserve(std::size_t n)
@@ -67,6 +67,13 @@ public:
     size_ = std::min(size_, capacity_);
   }
 
+  /// Release the unused capacity
+  void shrink_to_fit()
+  {
+    if (size_ < capacity_)
+      resize(size_);
+  }
+
   T& operator[] (T n)
   {
     return array_[n];
@@ -11,6 +11,8 @@
 #ifndef PMATH_HPP
 #define PMATH_HPP
 
+#include "prime_count_approx.hpp"
+
 #include <stdint.h>
 #include <algorithm>
 #include <cmath>
@@ -152,21 +154,12 @@ inline B inBetween(A min, B x, C max)
   return x;
 }
 
-/// primeCountApprox(x) >= pi(x)
+/// Tight upper bound for the number of primes
+/// inside [start, stop], see prime_count_approx.hpp
+///
 inline std::size_t primeCountApprox(uint64_t start, uint64_t stop)
 {
-  if (start > stop)
-    return 0;
-  if (stop <= 10)
-    return 4;
-
-  // pi(x) <= x / (log(x) - 1.1) + 5, for x >= 4
-  double x = (double) stop;
-  double logx = std::log(x);
-  double div = logx - 1.1;
-  double pix = (stop - start) / div + 5;
-
-  return (std::size_t) pix;
+  return prime_count_approx(start, stop);
 }
 
 inline std::size_t primeCountApprox(uint64_t stop)
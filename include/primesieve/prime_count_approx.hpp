@@ -0,0 +1,160 @@
+///
+/// @file   prime_count_approx.hpp
+/// @brief  Estimate the number of primes inside [start, stop]
+///         using the logarithmic integral and Riemann's R
+///         function. Used to reserve memory for storing primes.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef PRIME_COUNT_APPROX_HPP
+#define PRIME_COUNT_APPROX_HPP
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace primesieve {
+
+/// Logarithmic integral using Ramanujan's series,
+/// li(x) = gamma + log(log(x)) + sqrt(x) *
+/// sum_{n=1}^inf (-1)^(n-1) log(x)^n / (n! 2^(n-1)) *
+/// sum_{k=0}^{floor((n-1)/2)} 1 / (2k+1)
+///
+inline double li(double x)
+{
+  if (x <= 2)
+    return 1.045163780117492784;
+
+  double gamma = 0.577215664901532861;
+  double logx = std::log(x);
+  double sum = 0;
+  double inner = 0;
+  double term = 1;
+  double pow2 = 2;
+
+  for (int n = 1; n < 1000; n++)
+  {
+    term *= logx / n;
+    pow2 /= 2;
+    if (n % 2)
+      inner += 1.0 / n;
+    double t = term * pow2 * inner;
+    sum += (n % 2) ? t : -t;
+    if (t < 1e-18 * std::abs(sum))
+      break;
+  }
+
+  return gamma + std::log(logx) + std::sqrt(x) * sum;
+}
+
+/// li(b) - li(a) for 2 <= a <= b. Small intervals are
+/// integrated numerically (Simpson's rule) in order to
+/// avoid the cancellation error of li(b) - li(a).
+///
+inline double li_diff(double a, double b)
+{
+  a = std::max(a, 2.0);
+  b = std::max(a, b);
+
+  if (b - a > a / 8)
+    return li(b) - li(a);
+
+  double m = a + (b - a) / 2;
+  return (b - a) / 6 * (1 / std::log(a) +
+                        4 / std::log(m) +
+                        1 / std::log(b));
+}
+
+/// Büthe (2018): |li(x) - pi(x)| < sqrt(x) / log(x) *
+/// (1.95 + 3.9 / log(x) + 19.5 / log(x)^2)
+/// for 2657 <= x <= 1.4 * 10^25.
+///
+inline double li_error(double x)
+{
+  double logx = std::log(x);
+  return std::sqrt(x) / logx * (1.95 + 3.9 / logx + 19.5 / (logx * logx));
+}
+
+/// Upper bound for the number of primes inside [start, stop]
+/// using the proven bounds: pi(x) < li(x) for 2 <= x <= 10^19
+/// (Büthe 2018) and |li(x) - pi(x)| < li_error(x).
+///
+inline double prime_count_upper(uint64_t start, uint64_t stop)
+{
+  double x = (double) stop;
+  double upper = 0;
+
+  if (start <= 2657)
+    upper = li(x);
+  else
+  {
+    double s = (double) (start - 1);
+    upper = li_diff(s, x) + li_error(s);
+  }
+
+  if (x > 1e19)
+    upper += li_error(x);
+
+  // floating point rounding errors
+  return upper * (1 + 1e-12) + 10;
+}
+
+/// Number of primes inside [start, stop] using Riemann's
+/// R function, R(x) ~ li(x) - li(sqrt(x)) / 2. The counts of
+/// intervals deviate from R with a standard deviation of
+/// less than sqrt(count).
+///
+inline double prime_count_estimate(uint64_t start, uint64_t stop)
+{
+  double a = (double) start;
+  double b = (double) stop;
+  double count = li_diff(a, b);
+  count -= li_diff(std::sqrt(a), std::sqrt(b)) / 2;
+  return std::max(count, 0.0);
+}
+
+/// Cheap upper bound for the number of primes inside
+/// [start, stop], pi(x) <= x / (log(x) - 1.1) + 5 for
+/// x >= 4. It overestimates the count by up to 20%.
+///
+inline double prime_count_cheap(uint64_t start, uint64_t stop)
+{
+  double x = (double) stop;
+  double logx = std::log(x);
+  double div = logx - 1.1;
+  return (stop - start) / div + 5;
+}
+
+/// Tight upper bound for the number of primes inside
+/// [start, stop]. It uses the proven upper bound if that is
+/// tight and else the estimate + 8 standard deviations.
+/// Small counts use the cheap bound, the li and R series
+/// are too slow for e.g. short generate_primes() intervals
+/// and the tight bound only saves a few KiB.
+///
+inline std::size_t prime_count_approx(uint64_t start, uint64_t stop)
+{
+  if (start > stop)
+    return 0;
+  if (stop <= 10)
+    return 4;
+
+  double cheap = prime_count_cheap(start, stop);
+  if (cheap < (1 << 12))
+    return (std::size_t) cheap;
+
+  double upper = prime_count_upper(start, stop);
+  double estimate = prime_count_estimate(start, stop);
+  estimate += 8 * std::sqrt(estimate) + 10;
+
+  return (std::size_t) std::min(upper, estimate);
+}
+
+} // namespace
+
+#endif
@@ -0,0 +1,298 @@
+///
+/// @file   primes_range.hpp
+/// @brief  primesieve::primes(start, stop) returns an input range
+///         over the primes inside [start, stop]. The range is
+///         filled a whole block of primes at a time using
+///         primesieve::iterator::next_primes(), advancing to the
+///         next prime is a pointer increment. In C++20 the range
+///         models std::ranges::input_range and can be used in
+///         pipelines e.g. primes(0, 1000) | views::filter(...).
+///
+///         If the compiler supports C++20 coroutines
+///         primesieve::segments(start, stop) returns a
+///         primesieve::generator that yields the primes
+///         as std::span<const uint64_t> blocks.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef PRIMESIEVE_PRIMES_RANGE_HPP
+#define PRIMESIEVE_PRIMES_RANGE_HPP
+
+#include "iterator.hpp"
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+#if defined(__cpp_impl_coroutine) && \
+    defined(__has_include)
+  #if __has_include(<coroutine>) && \
+      __has_include(<span>)
+    #include <coroutine>
+    #include <exception>
+    #include <span>
+    #define PRIMESIEVE_COROUTINES
+  #endif
+#endif
+
+namespace primesieve {
+
+/// Single pass input range over the primes inside [start, stop].
+/// Iterators of the range are invalidated when the range is
+/// moved, begin() may only be called once.
+///
+class primes_range
+{
+public:
+  class iterator
+  {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = uint64_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const uint64_t*;
+    using reference = const uint64_t&;
+
+    iterator() = default;
+
+    reference operator*() const
+    {
+      return *cur_;
+    }
+
+    iterator& operator++()
+    {
+      if (++cur_ == end_)
+        next_block();
+      return *this;
+    }
+
+    /// The current block of primes may be overwritten
+    /// by ++, hence no copy is returned.
+    void operator++(int)
+    {
+      ++*this;
+    }
+
+    friend bool operator==(const iterator& a, const iterator& b)
+    {
+      return a.cur_ == b.cur_ ||
+             (a.done() && b.done());
+    }
+
+    friend bool operator!=(const iterator& a, const iterator& b)
+    {
+      return !(a == b);
+    }
+
+  private:
+    friend class primes_range;
+    const uint64_t* cur_ = nullptr;
+    const uint64_t* end_ = nullptr;
+    uint64_t stop_ = 0;
+    primes_range* range_ = nullptr;
+
+    iterator(primes_range* range) :
+      stop_(range->stop_),
+      range_(range)
+    {
+      next_block();
+    }
+
+    /// The addresses of cur_ and end_ must not escape,
+    /// else they cannot be kept in registers.
+    void next_block()
+    {
+      std::size_t size;
+      cur_ = range_->it_.next_primes(&size);
+      end_ = cur_ + size;
+    }
+
+    /// The end iterator has no block
+    bool done() const
+    {
+      return !cur_ ||
+             *cur_ > stop_;
+    }
+  };
+
+  /// @param start  First number of the range.
+  /// @param stop   Last number of the range, also used
+  ///               as primesieve::iterator stop_hint.
+  ///
+  primes_range(uint64_t start, uint64_t stop) :
+    it_((start > 0) ? start - 1 : 0, stop),
+    // UINT64_MAX marks the end of the primes
+    stop_(std::min(stop, get_max_stop() - 1))
+  { }
+
+  iterator begin()
+  {
+    return iterator(this);
+  }
+
+  iterator end()
+  {
+    return iterator();
+  }
+
+private:
+  ::primesieve::iterator it_;
+  uint64_t stop_;
+};
+
+/// Returns an input range over the primes inside [start, stop].
+/// The range uses a single primesieve::iterator and has
+/// the same speed as iterating over next_primes() blocks.
+///
+inline primes_range primes(uint64_t start, uint64_t stop)
+{
+  return primes_range(start, stop);
+}
+
+#if defined(PRIMESIEVE_COROUTINES)
+
+/// Minimal C++20 coroutine generator, it is an
+/// input range of the yielded values.
+///
+template <typename T>
+class generator
+{
+public:
+  struct promise_type;
+  using handle = std::coroutine_handle<promise_type>;
+
+  struct promise_type
+  {
+    T value_;
+    std::exception_ptr exception_;
+
+    generator get_return_object() { return generator(handle::from_promise(*this)); }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() noexcept { }
+    void unhandled_exception() { exception_ = std::current_exception(); }
+
+    std::suspend_always yield_value(T value) noexcept
+    {
+      value_ = value;
+      return {};
+    }
+  };
+
+  class iterator
+  {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+    explicit iterator(handle h) : h_(h) { }
+
+    const T& operator*() const
+    {
+      return h_.promise().value_;
+    }
+
+    iterator& operator++()
+    {
+      resume(h_);
+      return *this;
+    }
+
+    void operator++(int)
+    {
+      ++*this;
+    }
+
+    friend bool operator==(const iterator& it, std::default_sentinel_t)
+    {
+      return !it.h_ || it.h_.done();
+    }
+
+  private:
+    handle h_;
+  };
+
+  generator(const generator&) = delete;
+  generator& operator=(const generator&) = delete;
+
+  generator(generator&& other) noexcept :
+    h_(other.h_)
+  {
+    other.h_ = nullptr;
+  }
+
+  generator& operator=(generator&& other) noexcept
+  {
+    std::swap(h_, other.h_);
+    return *this;
+  }
+
+  ~generator()
+  {
+    if (h_)
+      h_.destroy();
+  }
+
+  /// Runs the coroutine up to the first co_yield
+  iterator begin()
+  {
+    resume(h_);
+    return iterator(h_);
+  }
+
+  std::default_sentinel_t end() const noexcept
+  {
+    return {};
+  }
+
+private:
+  handle h_;
+
+  explicit generator(handle h) :
+    h_(h)
+  { }
+
+  static void resume(handle h)
+  {
+    h.resume();
+    if (h.promise().exception_)
+      std::rethrow_exception(h.promise().exception_);
+  }
+};
+
+/// Yields the primes inside [start, stop] in blocks,
+/// the span of a block is valid until the generator
+/// is resumed. Other work (e.g. async I/O) can be
+/// done between the blocks.
+///
+inline generator<std::span<const uint64_t>> segments(uint64_t start, uint64_t stop)
+{
+  ::primesieve::iterator it((start > 0) ? start - 1 : 0, stop);
+  stop = std::min(stop, get_max_stop() - 1);
+
+  while (true)
+  {
+    std::size_t size;
+    const uint64_t* primes = it.next_primes(&size);
+    std::size_t n = std::upper_bound(primes, primes + size, stop) - primes;
+
+    if (n > 0)
+      co_yield std::span<const uint64_t>(primes, n);
+    if (n < size)
+      co_return;
+  }
+}
+
+#endif
+
+} // namespace
+
+#endif
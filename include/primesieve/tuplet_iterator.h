@@ -0,0 +1,100 @@
+/**
+ * @file   tuplet_iterator.h
+ * @brief  primesieve_tuplet_iterator allows to easily iterate
+ *         over prime k-tuplets: k = 2 twin primes, k = 3 prime
+ *         triplets, ..., k = 6 prime sextuplets. The k-tuplets
+ *         are found directly in the sieve array, the other
+ *         primes are never generated. Hence this is much faster
+ *         than filtering the primes of primesieve_iterator.
+ *
+ *         If any error occurs (e.g. k < 2 or k > 6) the primes
+ *         of the returned k-tuplet are PRIMESIEVE_ERROR and
+ *         primesieve_tuplet_iterator.is_error is set to 1.
+ *
+ * Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+ *
+ * This file is distributed under the BSD License. See the COPYING
+ * file in the top level directory.
+ */
+
+#ifndef PRIMESIEVE_TUPLET_ITERATOR_H
+#define PRIMESIEVE_TUPLET_ITERATOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * C prime k-tuplet iterator, please refer to @link
+ * tuplet_iterator.h tuplet_iterator.h @endlink for more
+ * information.
+ */
+typedef struct
+{
+  size_t i;
+  size_t size;
+  int k;
+  uint64_t start;
+  uint64_t stop;
+  uint64_t stop_hint;
+  uint64_t dist;
+  uint64_t* tuplets;
+  void* vector;
+  void* tupletGenerator;
+  int is_error;
+} primesieve_tuplet_iterator;
+
+/**
+ * Initialize the k-tuplet iterator before first using it.
+ * @param k  2 twin primes, 3 prime triplets, ...,
+ *           6 prime sextuplets.
+ */
+void primesieve_init_tuplet_iterator(primesieve_tuplet_iterator* it, int k);
+
+/** Free all memory */
+void primesieve_free_tuplet_iterator(primesieve_tuplet_iterator* it);
+
+/**
+ * Reset the k-tuplet iterator to start.
+ * @param start      Generate the k-tuplets whose first
+ *                   prime is > start.
+ * @param stop_hint  Stop number optimization hint, if you
+ *                   don't know use primesieve_get_max_stop().
+ */
+void primesieve_skipto_tuplet(primesieve_tuplet_iterator* it, uint64_t start, uint64_t stop_hint);
+
+/** Internal use */
+void primesieve_generate_next_tuplets(primesieve_tuplet_iterator*);
+
+/**
+ * Get the next prime k-tuplet, returns a pointer to
+ * its k primes in ascending order. All primes are
+ * UINT64_MAX if next k-tuplet > 2^64. The returned
+ * pointer is valid until the iterator is used again.
+ */
+static inline const uint64_t* primesieve_next_tuplet(primesieve_tuplet_iterator* it)
+{
+  if (it->i == it->size)
+    primesieve_generate_next_tuplets(it);
+  it->i += it->k;
+  return &it->tuplets[it->i - it->k];
+}
+
+/**
+ * Get the next block of prime k-tuplets, the primes of the
+ * k-tuplets are stored consecutively i.e. the j-th k-tuplet
+ * is [j * k, j * k + k[. Afterwards primesieve_next_tuplet()
+ * continues after the last k-tuplet of the block. The returned
+ * pointer is valid until the iterator is used again.
+ * @param size  Number of k-tuplets of the block (>= 1).
+ */
+const uint64_t* primesieve_next_tuplets(primesieve_tuplet_iterator* it, size_t* size);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,112 @@
+///
+/// @file   tuplet_iterator.hpp
+/// @brief  The tuplet_iterator class allows to easily iterate
+///         over prime k-tuplets e.g. twin primes.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef PRIMESIEVE_TUPLET_ITERATOR_HPP
+#define PRIMESIEVE_TUPLET_ITERATOR_HPP
+
+#include <stdint.h>
+#include <array>
+#include <cstddef>
+#include <vector>
+#include <memory>
+
+namespace primesieve {
+
+class TupletGenerator;
+
+uint64_t get_max_stop();
+
+/// primesieve::tuplet_iterator<k> iterates forwards over the
+/// prime k-tuplets: k = 2 twin primes, k = 3 prime triplets,
+/// k = 4 prime quadruplets, k = 5 prime quintuplets and
+/// k = 6 prime sextuplets. The k-tuplets are found directly in
+/// the sieve array, the other primes are never generated,
+/// hence this is much faster than filtering the primes of
+/// primesieve::iterator.
+///
+template <int K>
+class tuplet_iterator
+{
+public:
+  static_assert(K >= 2 && K <= 6, "tuplet_iterator<k>: k must be >= 2 and <= 6");
+
+  /// The primes of a k-tuplet in ascending order
+  using tuplet = std::array<uint64_t, K>;
+
+  /// Create a new tuplet_iterator object.
+  /// @param start      Generate the k-tuplets whose first
+  ///                   prime is > start.
+  /// @param stop_hint  Stop number optimization hint, gives significant
+  ///                   speed up if few k-tuplets are generated.
+  ///
+  tuplet_iterator(uint64_t start = 0, uint64_t stop_hint = get_max_stop());
+
+  /// primesieve::tuplet_iterator objects cannot be copied.
+  tuplet_iterator(const tuplet_iterator&) = delete;
+  tuplet_iterator& operator=(const tuplet_iterator&) = delete;
+
+  /// primesieve::tuplet_iterator objects support move semantics.
+  tuplet_iterator(tuplet_iterator&&) noexcept;
+  tuplet_iterator& operator=(tuplet_iterator&&) noexcept;
+
+  ~tuplet_iterator();
+
+  /// Reset the tuplet_iterator to start.
+  /// @param start      Generate the k-tuplets whose first
+  ///                   prime is > start.
+  /// @param stop_hint  Stop number optimization hint.
+  ///
+  void skipto(uint64_t start, uint64_t stop_hint = get_max_stop());
+
+  /// Get the next prime k-tuplet.
+  /// All primes are UINT64_MAX if next k-tuplet > 2^64.
+  ///
+  tuplet next_tuplet()
+  {
+    if (i_ == size_)
+      generate_next_tuplets();
+
+    tuplet t;
+    for (int j = 0; j < K; j++)
+      t[j] = tuplets_[i_ + j];
+
+    i_ += K;
+    return t;
+  }
+
+  /// Get the next block of prime k-tuplets, the primes of
+  /// the k-tuplets are stored consecutively i.e. the j-th
+  /// k-tuplet is [j * k, j * k + k[. Afterwards next_tuplet()
+  /// continues after the last k-tuplet of the block.
+  /// @param size  Number of k-tuplets of the block (>= 1).
+  /// @return      Pointer to the first prime, valid until
+  ///              the iterator is used again.
+  ///
+  const uint64_t* next_tuplets(std::size_t* size);
+
+private:
+  std::size_t i_;
+  std::size_t size_;
+  std::vector<uint64_t> tuplets_;
+  uint64_t start_;
+  uint64_t stop_;
+  uint64_t stop_hint_;
+  uint64_t dist_;
+  std::unique_ptr<TupletGenerator> tupletGenerator_;
+  void generate_next_tuplets();
+};
+
+using twin_iterator = tuplet_iterator<2>;
+using triplet_iterator = tuplet_iterator<3>;
+
+} // namespace
+
+#endif
@@ -9,6 +9,8 @@
 #   fastest timing indicates the best sieve size for the user's
 #   CPU. Note that we run single and multi-threaded benchmarks
 #   for small, medium and large primes.
+#   primesieve --tune finds the fastest sieve size (and other
+#   settings) automatically and stores it in the tuning profile.
 
 # Find the primesieve binary
 command -v ./primesieve >/dev/null 2>/dev/null
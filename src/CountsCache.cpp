@@ -0,0 +1,161 @@
+///
+/// @file  CountsCache.cpp
+///        LRU cache of the counts of fixed size blocks, block 0
+///        is [0, BLOCK_SIZE + 2], block i > 0 is
+///        [i * BLOCK_SIZE + 3, (i + 1) * BLOCK_SIZE + 2].
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/CountsCache.hpp>
+#include <primesieve/PrimeSieve.hpp>
+
+#include <stdint.h>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+namespace primesieve {
+
+CountsCache countsCache;
+
+constexpr uint64_t CountsCache::BLOCK_SIZE;
+
+/// Entry + list node + hash map node
+uint64_t CountsCache::entryBytes()
+{
+  return sizeof(Entry) + sizeof(void*) * 2 +
+         sizeof(uint64_t) + sizeof(lru_t::iterator) + sizeof(void*) * 3;
+}
+
+void CountsCache::setMaxMemory(uint64_t maxMemory)
+{
+  lock_guard<mutex> lock(mutex_);
+  maxEntries_ = maxMemory / entryBytes();
+  evict();
+}
+
+bool CountsCache::isEnabled() const
+{
+  lock_guard<mutex> lock(mutex_);
+  return maxEntries_ > 0;
+}
+
+void CountsCache::clear()
+{
+  lock_guard<mutex> lock(mutex_);
+  lru_.clear();
+  map_.clear();
+  hits_ = 0;
+  misses_ = 0;
+  evictions_ = 0;
+}
+
+CountsCache::Stats CountsCache::getStats() const
+{
+  lock_guard<mutex> lock(mutex_);
+  Stats stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.evictions = evictions_;
+  stats.blocks = lru_.size();
+  stats.memoryUsage = lru_.size() * entryBytes();
+  return stats;
+}
+
+bool CountsCache::find(uint64_t block, int flags, counts_t& counts)
+{
+  lock_guard<mutex> lock(mutex_);
+  auto iter = map_.find(block);
+
+  if (iter == map_.end() ||
+      (iter->second->flags & flags) != flags)
+  {
+    misses_++;
+    return false;
+  }
+
+  // move to front
+  lru_.splice(lru_.begin(), lru_, iter->second);
+  counts = iter->second->counts;
+  hits_++;
+  return true;
+}
+
+void CountsCache::insert(uint64_t block, int flags, const counts_t& counts)
+{
+  lock_guard<mutex> lock(mutex_);
+
+  if (maxEntries_ == 0)
+    return;
+
+  auto iter = map_.find(block);
+
+  if (iter != map_.end())
+  {
+    // Add the counts of the new flags
+    Entry& entry = *iter->second;
+    for (size_t i = 0; i < counts.size(); i++)
+      if (flags & (COUNT_PRIMES << i))
+        entry.counts[i] = counts[i];
+
+    entry.flags |= flags;
+    lru_.splice(lru_.begin(), lru_, iter->second);
+    return;
+  }
+
+  lru_.push_front(Entry{block, flags, counts});
+  map_[block] = lru_.begin();
+  evict();
+}
+
+/// Remove the least recently used entries
+void CountsCache::evict()
+{
+  while (lru_.size() > maxEntries_)
+  {
+    map_.erase(lru_.back().block);
+    lru_.pop_back();
+    evictions_++;
+  }
+}
+
+uint64_t CountsCache::blockStart(uint64_t block)
+{
+  if (block == 0)
+    return 0;
+  else
+    return block * BLOCK_SIZE + 3;
+}
+
+uint64_t CountsCache::blockStop(uint64_t block)
+{
+  return (block + 1) * BLOCK_SIZE + 2;
+}
+
+bool CountsCache::getBlocks(uint64_t start,
+                            uint64_t stop,
+                            uint64_t* firstBlock,
+                            uint64_t* lastBlock)
+{
+  if (stop < BLOCK_SIZE + 2)
+    return false;
+
+  if (start == 0)
+    *firstBlock = 0;
+  else if (start <= BLOCK_SIZE + 3)
+    *firstBlock = 1;
+  else
+    *firstBlock = (start - 4) / BLOCK_SIZE + 1;
+
+  *lastBlock = (stop - 2) / BLOCK_SIZE - 1;
+
+  return *firstBlock <= *lastBlock;
+}
+
+} // namespace
@@ -14,13 +14,17 @@
 #include <primesieve/EratSmall.hpp>
 #include <primesieve/EratMedium.hpp>
 #include <primesieve/EratBig.hpp>
+#include <primesieve/MemoryPool.hpp>
 #include <primesieve/PreSieve.hpp>
 #include <primesieve/pmath.hpp>
+#include <primesieve/Profile.hpp>
+#include <primesieve/SieveStats.hpp>
 #include <primesieve/primesieve_error.hpp>
 
 #include <stdint.h>
 #include <array>
 #include <algorithm>
+#include <cmath>
 #include <memory>
 
 using namespace std;
@@ -38,30 +42,39 @@ const array<byte_t, 37> unsetSmaller =
   0x00, 0x00, 0x00, 0x00, 0x00
 };
 
-/// unset bits > stop
-const array<byte_t, 37> unsetLarger =
+/// Approximate number of sieving primes <= x that are stored
+/// when sieving an interval of size dist. A sieving prime
+/// > dist is only stored if it has a multiple inside the
+/// interval that is not divisible by 2, 3, 5 and 7, the
+/// probability for that is about (dist / p) * (48 / 210).
+///
+uint64_t storedPrimes(uint64_t x, uint64_t dist)
 {
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
-  0x01, 0x01, 0x01, 0x03, 0x03, 0x07, 0x07, 0x07,
-  0x07, 0x0f, 0x0f, 0x1f, 0x1f, 0x1f, 0x1f, 0x3f,
-  0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x7f, 0x7f, 0xff,
-  0xff, 0xff, 0xff, 0xff, 0xff
-};
+  dist = max<uint64_t>(dist, 1000);
+
+  if (x <= dist)
+    return primeCountApprox(x);
+
+  double d = (double) dist;
+  double lnlnx = log(log((double) x));
+  double lnlnd = log(log(d));
+  double large = d * (48.0 / 210.0) * (lnlnx - lnlnd);
+
+  return primeCountApprox(dist) + (uint64_t) large;
+}
 
 } // namespace
 
 namespace primesieve {
 
-const array<uint64_t, 64> Erat::bruijnBitValues_ =
+/// unset bits > stop
+const array<byte_t, 37> Erat::unsetLarger_ =
 {
-    7,  47,  11,  49,  67, 113,  13,  53,
-   89,  71, 161, 101, 119, 187,  17, 233,
-   59,  79,  91,  73, 133, 139, 163, 103,
-  149, 121, 203, 169, 191, 217,  19, 239,
-   43,  61, 109,  83, 157,  97, 181, 229,
-   77, 131, 137, 143, 199, 167, 211,  41,
-  107, 151, 179, 227, 127, 197, 209,  37,
-  173, 223, 193,  31, 221,  29,  23, 241
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+  0x01, 0x01, 0x01, 0x03, 0x03, 0x07, 0x07, 0x07,
+  0x07, 0x0f, 0x0f, 0x1f, 0x1f, 0x1f, 0x1f, 0x3f,
+  0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x7f, 0x7f, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff
 };
 
 Erat::Erat() = default;
@@ -81,8 +94,14 @@ void Erat::init(uint64_t start,
                 uint64_t sieveSize,
                 PreSieve& preSieve)
 {
+  // Erat may be reinitialized, there
+  // must be no segment left to sieve.
   if (start > stop)
+  {
+    segmentLow_ = ~0ull;
+    segmentHigh_ = 0;
     return;
+  }
 
   if (start < 7)
     throw primesieve_error("Erat: start < 7");
@@ -109,8 +128,13 @@ void Erat::initSieve(uint64_t sieveSize)
   sieveSize_ = inBetween(8, sieveSize_, 4096);
   sieveSize_ *= 1024;
 
-  sieve_ = new byte_t[sieveSize_];
-  deleter_.reset(sieve_);
+  // reuse the sieve array if Erat is reinitialized
+  if (sieveSize_ != allocSize_)
+  {
+    sieve_ = new byte_t[sieveSize_];
+    deleter_.reset(sieve_);
+    allocSize_ = sieveSize_;
+  }
 }
 
 void Erat::initErat()
@@ -118,8 +142,16 @@ void Erat::initErat()
   uint64_t sqrtStop = isqrt(stop_);
   uint64_t l1CacheSize = EratSmall::getL1CacheSize(sieveSize_);
 
-  maxEratSmall_ = (uint64_t) (l1CacheSize * config::FACTOR_ERATSMALL);
-  maxEratMedium_ = (uint64_t) (sieveSize_ * config::FACTOR_ERATMEDIUM);
+  const Profile& profile = Profile::get();
+
+  maxEratSmall_ = (uint64_t) (l1CacheSize * profile.factorEratSmall);
+  maxEratMedium_ = (uint64_t) (sieveSize_ * profile.factorEratMedium);
+
+  // Erat may be reinitialized for sieving another
+  // interval, remove the old sieving primes.
+  eratSmall_.clear();
+  eratMedium_.clear();
+  eratBig_.clear();
 
   if (sqrtStop > maxPreSieve_)
     eratSmall_.init(stop_, l1CacheSize, maxEratSmall_);
@@ -127,6 +159,69 @@ void Erat::initErat()
     eratMedium_.init(stop_, sieveSize_, maxEratMedium_);
   if (sqrtStop > maxEratMedium_)
     eratBig_.init(stop_, sieveSize_, sqrtStop);
+
+  // Free the buckets of the previous
+  // interval that are no longer needed
+  if (!eratMedium_.enabled())
+    eratMedium_.trim();
+  if (!eratBig_.enabled())
+    eratBig_.trim();
+}
+
+/// Memory of the sieve array and of the sieving
+/// primes, in bytes.
+///
+uint64_t Erat::getMemoryUsage() const
+{
+  return allocSize_ +
+         eratSmall_.getMemoryUsage() +
+         eratMedium_.getMemoryUsage() +
+         eratBig_.getMemoryUsage();
+}
+
+/// Estimated memory usage of sieving [start, stop], i.e.
+/// the sieve array, the pre-sieve buffer and the sieving
+/// primes (incl. partially filled buckets).
+/// @sieveSize: Sieve size in KiB
+///
+uint64_t Erat::estimateMemoryUsage(uint64_t start,
+                                   uint64_t stop,
+                                   uint64_t sieveSize)
+{
+  sieveSize = floorPow2(sieveSize);
+  sieveSize = inBetween(8, sieveSize, 4096);
+  sieveSize *= 1024;
+
+  uint64_t l1CacheSize = EratSmall::getL1CacheSize(sieveSize);
+  const Profile& profile = Profile::get();
+  uint64_t maxEratSmall = (uint64_t) (l1CacheSize * profile.factorEratSmall);
+  uint64_t maxEratMedium = (uint64_t) (sieveSize * profile.factorEratMedium);
+  uint64_t sqrtStop = isqrt(stop);
+  uint64_t bytes = sieveSize;
+
+  // PreSieve uses 316 KiB if dist / 100 > 19# / 19
+  if (max(stop - start, sqrtStop) / 100 > 510510)
+    bytes += 9699690 / 30;
+
+  uint64_t dist = stop - start;
+  uint64_t primes = storedPrimes(sqrtStop, dist);
+  bytes += primes * sizeof(SievingPrime);
+
+  // EratMedium uses 64 bucket lists
+  if (sqrtStop > maxEratSmall)
+  {
+    uint64_t medium = storedPrimes(min(sqrtStop, maxEratMedium), dist);
+    bytes += 64 * MemoryPool::getBucketBytes(medium / 64);
+  }
+
+  // EratBig uses 1 bucket list per segment
+  if (sqrtStop > maxEratMedium)
+  {
+    uint64_t lists = EratBig::getListCount(sqrtStop, sieveSize);
+    bytes += lists * MemoryPool::getBucketBytes(primes / lists);
+  }
+
+  return bytes;
 }
 
 bool Erat::hasNextSegment() const
@@ -146,6 +241,7 @@ uint64_t Erat::byteRemainder(uint64_t n)
 ///
 void Erat::preSieve()
 {
+  PhaseTimer timer(stats_, SieveStats::PRE_SIEVE);
   preSieve_->copy(sieve_, sieveSize_, segmentLow_);
 
   // unset bits < start
@@ -161,15 +257,27 @@ void Erat::preSieve()
 void Erat::crossOff()
 {
   if (eratSmall_.enabled())
+  {
+    PhaseTimer timer(stats_, SieveStats::ERAT_SMALL);
     eratSmall_.crossOff(sieve_, sieveSize_);
+  }
   if (eratMedium_.enabled())
+  {
+    PhaseTimer timer(stats_, SieveStats::ERAT_MEDIUM);
     eratMedium_.crossOff(sieve_, sieveSize_);
+  }
   if (eratBig_.enabled())
+  {
+    PhaseTimer timer(stats_, SieveStats::ERAT_BIG);
     eratBig_.crossOff(sieve_);
+  }
 }
 
 void Erat::sieveSegment()
 {
+  if (stats_)
+    stats_->segments++;
+
   if (segmentHigh_ == stop_)
     sieveLastSegment();
   else
@@ -194,7 +302,7 @@ void Erat::sieveLastSegment()
   crossOff();
 
   // unset bits > stop
-  sieve_[sieveSize_ - 1] &= unsetLarger[rem];
+  sieve_[sieveSize_ - 1] &= unsetLarger_[rem];
 
   // unset bytes > stop
   uint64_t bytes = sieveSize_ % 8;
@@ -54,18 +54,46 @@ void EratBig::init(uint64_t stop, uint64_t sieveSize, uint64_t maxPrime)
 
 void EratBig::init(uint64_t sieveSize)
 {
-  uint64_t maxSievingPrime = maxPrime_ / 30;
-  uint64_t maxNextMultiple = maxSievingPrime * getMaxFactor() + getMaxFactor();
-  uint64_t maxMultipleIndex = sieveSize - 1 + maxNextMultiple;
-  uint64_t maxSegmentCount = maxMultipleIndex >> log2SieveSize_;
-  uint64_t size = maxSegmentCount + 1;
-
+  uint64_t size = getListCount(maxPrime_, sieveSize);
+  memoryPool_.init(primeCountApprox(maxPrime_), size);
   sievingPrimes_.resize(size);
 
   for (SievingPrime*& sievingPrime : sievingPrimes_)
     memoryPool_.reset(sievingPrime);
 }
 
+/// Number of bucket lists (one per segment) required
+/// for sieving primes <= maxPrime. Each list
+/// initially uses one bucket.
+///
+uint64_t EratBig::getListCount(uint64_t maxPrime, uint64_t sieveSize)
+{
+  uint64_t maxSievingPrime = maxPrime / 30;
+  uint64_t maxNextMultiple = maxSievingPrime * getMaxFactor() + getMaxFactor();
+  uint64_t maxMultipleIndex = sieveSize - 1 + maxNextMultiple;
+  uint64_t maxSegmentCount = maxMultipleIndex >> ilog2(sieveSize);
+  return maxSegmentCount + 1;
+}
+
+uint64_t EratBig::getMemoryUsage() const
+{
+  return memoryPool_.getMemoryUsage() +
+         sievingPrimes_.capacity() * sizeof(SievingPrime*);
+}
+
+/// Remove all sieving primes, the buckets
+/// are kept in the memory pool for reuse.
+///
+void EratBig::clear()
+{
+  if (enabled_)
+    for (SievingPrime* sievingPrime : sievingPrimes_)
+      memoryPool_.freeBuckets(sievingPrime);
+
+  sievingPrimes_.clear();
+  enabled_ = false;
+}
+
 /// Add a new sieving prime
 void EratBig::storeSievingPrime(uint64_t prime, uint64_t multipleIndex, uint64_t wheelIndex)
 {
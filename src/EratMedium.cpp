@@ -21,11 +21,13 @@
 #include <primesieve/Bucket.hpp>
 #include <primesieve/MemoryPool.hpp>
 #include <primesieve/Wheel.hpp>
+#include <primesieve/pmath.hpp>
 #include <primesieve/primesieve_error.hpp>
 #include <primesieve/types.hpp>
 #include <primesieve/bits.hpp>
 
 #include <stdint.h>
+#include <algorithm>
 #include <cassert>
 
 /// This macro sorts the current sieving prime by its
@@ -59,6 +61,8 @@ void EratMedium::init(uint64_t stop, uint64_t sieveSize, uint64_t maxPrime)
 
   enabled_ = true;
   maxPrime_ = maxPrime;
+  uint64_t sievingPrimes = primeCountApprox(std::min(maxPrime, isqrt(stop)));
+  memoryPool_.init(sievingPrimes, sievingPrimes_.size());
 
   Wheel::init(stop, sieveSize);
   resetSievingPrimes();
@@ -70,6 +74,18 @@ void EratMedium::resetSievingPrimes()
     memoryPool_.reset(sievingPrime);
 }
 
+/// Remove all sieving primes, the buckets
+/// are kept in the memory pool for reuse.
+///
+void EratMedium::clear()
+{
+  if (enabled_)
+    for (SievingPrime* sievingPrime : sievingPrimes_)
+      memoryPool_.freeBuckets(sievingPrime);
+
+  enabled_ = false;
+}
+
 /// Add a new sieving prime to EratMedium
 void EratMedium::storeSievingPrime(uint64_t prime, uint64_t multipleIndex, uint64_t wheelIndex)
 {
@@ -58,6 +58,13 @@ void EratSmall::init(uint64_t stop, uint64_t l1CacheSize, uint64_t maxPrime)
   primes_.reserve(count);
 }
 
+/// Remove all sieving primes
+void EratSmall::clear()
+{
+  primes_.clear();
+  enabled_ = false;
+}
+
 /// Add a new sieving prime to EratSmall
 void EratSmall::storeSievingPrime(uint64_t prime, uint64_t multipleIndex, uint64_t wheelIndex)
 {
@@ -9,13 +9,17 @@
 /// file in the top level directory.
 ///
 
+#include <primesieve.hpp>
 #include <primesieve/config.hpp>
+#include <primesieve/Erat.hpp>
 #include <primesieve/IteratorHelper.hpp>
 #include <primesieve/PrimeGenerator.hpp>
 #include <primesieve/pmath.hpp>
+#include <primesieve/primesieve_error.hpp>
 
 #include <stdint.h>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <limits>
 
@@ -24,14 +28,16 @@ using namespace primesieve;
 
 namespace {
 
-uint64_t getNextDist(uint64_t n, uint64_t dist)
+/// Minimum distance of an interval
+const uint64_t tinyDist = 1 << 10;
+
+uint64_t getNextDist(uint64_t n, uint64_t dist, uint64_t growth)
 {
   double x = (double) n;
-  uint64_t tinyDist = PrimeGenerator::maxCachedPrime() * 4;
   uint64_t minDist = (uint64_t) sqrt(x);
   uint64_t maxDist = 1ull << 60;
 
-  dist *= 4;
+  dist *= growth;
   dist = max(dist, tinyDist);
   dist = max(dist, minDist);
   dist = min(dist, maxDist);
@@ -39,23 +45,25 @@ uint64_t getNextDist(uint64_t n, uint64_t dist)
   return dist;
 }
 
-uint64_t getPrevDist(uint64_t n, uint64_t dist)
+uint64_t getPrevDist(uint64_t n, uint64_t dist, uint64_t growth)
 {
   double x = (double) n;
   x = max(x, 10.0);
-  double logx = ceil(log(x));
 
+  // PrevPrimeGenerator stores the interval
+  // in a bitmap, 1 byte per 30 numbers
   uint64_t minDist = config::MIN_CACHE_ITERATOR;
   uint64_t maxDist = config::MAX_CACHE_ITERATOR;
-  minDist /= sizeof(uint64_t);
-  maxDist /= sizeof(uint64_t);
-  minDist *= (uint64_t) logx;
-  maxDist *= (uint64_t) logx;
+  minDist *= 30;
+  maxDist *= 30;
 
-  uint64_t tinyDist = PrimeGenerator::maxCachedPrime() * 4;
+  // PrevPrimeGenerator generates the sieving primes
+  // only for the first interval, hence the
+  // following intervals can be larger.
   uint64_t defaultDist = (uint64_t) (sqrt(x) * 2);
+  minDist = max(minDist, defaultDist * 4);
 
-  dist *= 4;
+  dist *= growth;
   dist = max(dist, tinyDist);
   dist = min(dist, minDist);
   dist = max(dist, defaultDist);
@@ -64,6 +72,68 @@ uint64_t getPrevDist(uint64_t n, uint64_t dist)
   return dist;
 }
 
+uint64_t getGrowth(const ChunkPolicy* policy)
+{
+  return (policy) ? policy->getGrowth() : 4;
+}
+
+/// Sieve array size in bytes, see Erat::initSieve()
+uint64_t getSieveBytes()
+{
+  uint64_t sieveSize = floorPow2(get_sieve_size());
+  sieveSize = inBetween(8, sieveSize, 4096);
+  return sieveSize << 10;
+}
+
+/// Estimated memory usage of Erat sieving [start, stop]
+/// i.e. its sieve array, pre-sieve buffer and sieving
+/// primes, see Erat::initErat().
+///
+uint64_t sieveMemory(uint64_t start, uint64_t stop)
+{
+  return Erat::estimateMemoryUsage(start, stop, get_sieve_size());
+}
+
+/// Shrink the interval distance until the sieving
+/// memory is <= maxMemory or dist <= minDist.
+///
+template <typename F>
+uint64_t shrinkDist(uint64_t dist,
+                    uint64_t minDist,
+                    uint64_t maxMemory,
+                    F memory)
+{
+  while (dist > minDist &&
+         memory(dist) > maxMemory)
+    dist = max(dist / 2, minDist);
+
+  return dist;
+}
+
+double getTime()
+{
+  auto now = chrono::steady_clock::now();
+  return chrono::duration<double>(now.time_since_epoch()).count();
+}
+
+/// Magic number and version of the
+/// serialized iterator state
+const uint8_t stateMagic[5] = { 'P', 'S', 'I', 'T', 1 };
+
+void putUint64(uint8_t* bytes, uint64_t n)
+{
+  for (int i = 0; i < 8; i++)
+    bytes[i] = (uint8_t) (n >> (i * 8));
+}
+
+uint64_t getUint64(const uint8_t* bytes)
+{
+  uint64_t n = 0;
+  for (int i = 0; i < 8; i++)
+    n |= (uint64_t) bytes[i] << (i * 8);
+  return n;
+}
+
 bool useStopHint(uint64_t start,
                  uint64_t stopHint)
 {
@@ -86,7 +156,8 @@ namespace primesieve {
 void IteratorHelper::next(uint64_t* start,
                           uint64_t* stop,
                           uint64_t stopHint,
-                          uint64_t* dist)
+                          uint64_t* dist,
+                          const ChunkPolicy* policy)
 {
   *start = checkedAdd(*stop, 1);
   uint64_t maxCachedPrime = PrimeGenerator::maxCachedPrime();
@@ -94,33 +165,199 @@ void IteratorHelper::next(uint64_t* start,
   if (*start < maxCachedPrime)
   {
     // When the stop number <= maxCachedPrime
-    // primesieve::iterator uses the primes
-    // cache instead of sieving and does not
-    // even initialize Erat::init()
+    // primesieve::iterator reads the primes
+    // from PrimeBitmap instead of sieving and
+    // does not even initialize Erat::init()
     *stop = maxCachedPrime;
     *dist = *stop - *start;
   }
   else
   {
-    *dist = getNextDist(*start, *dist);
+    *dist = getNextDist(*start, *dist, getGrowth(policy));
     *stop = checkedAdd(*start, *dist);
 
     if (useStopHint(*start, stopHint))
       *stop = checkedAdd(stopHint, maxPrimeGap(stopHint));
+
+    // Also limits a stop hint that is much too large. The
+    // sieve array is allocated anyway, hence intervals
+    // smaller than a segment do not save memory.
+    if (policy)
+    {
+      uint64_t low = *start;
+      uint64_t minDist = max(isqrt(low), getSieveBytes() * 30);
+      uint64_t d = shrinkDist(*stop - low, minDist, policy->getMaxMemory(),
+                              [=](uint64_t d) { return nextMemory(low, checkedAdd(low, d)); });
+      *stop = checkedAdd(low, d);
+      *dist = min(*dist, d);
+    }
   }
 }
 
 void IteratorHelper::prev(uint64_t* start,
                           uint64_t* stop,
                           uint64_t stopHint,
-                          uint64_t* dist)
+                          uint64_t* dist,
+                          const ChunkPolicy* policy)
 {
   *stop = checkedSub(*start, 1);
-  *dist = getPrevDist(*stop, *dist);
+  *dist = getPrevDist(*stop, *dist, getGrowth(policy));
   *start = checkedSub(*stop, *dist);
 
   if (useStopHint(*start, *stop, stopHint))
     *start = checkedSub(stopHint, maxPrimeGap(stopHint));
+
+  if (policy)
+  {
+    uint64_t high = *stop;
+    uint64_t minDist = (uint64_t) (sqrt(max((double) high, 10.0)) * 2);
+    minDist = max(minDist, getSieveBytes() * 30);
+    uint64_t d = shrinkDist(high - *start, minDist, policy->getMaxMemory(),
+                            [=](uint64_t d) { return prevMemory(checkedSub(high, d), high); });
+    *start = checkedSub(high, d);
+    *dist = min(*dist, d);
+  }
+}
+
+/// Estimated memory usage of PrimeGenerator, it
+/// also sieves its sieving primes <= sqrt(stop).
+///
+uint64_t IteratorHelper::nextMemory(uint64_t start, uint64_t stop)
+{
+  return sieveMemory(start, stop) + getSieveBytes();
+}
+
+/// Estimated memory usage of PrevPrimeGenerator, it stores
+/// the interval in a bitmap (1 byte per 30 numbers) and
+/// the sieving primes using 1 byte per prime.
+///
+uint64_t IteratorHelper::prevMemory(uint64_t start, uint64_t stop)
+{
+  uint64_t bitmap = (stop - start) / 30;
+  uint64_t gaps = primeCountApprox(isqrt(stop));
+  return sieveMemory(start, stop) + bitmap + gaps;
+}
+
+ChunkPolicy::ChunkPolicy(uint64_t maxMemory) :
+  maxMemory_(maxMemory)
+{ }
+
+void ChunkPolicy::startSieve()
+{
+  sieveStart_ = getTime();
+}
+
+void ChunkPolicy::stopSieve()
+{
+  sieveTime_ += getTime() - sieveStart_;
+}
+
+/// Larger intervals only speed up the part of the time
+/// spent sieving. If the caller takes most of the time
+/// to process the primes the distance is not increased
+/// and no memory is wasted.
+/// @pre Called between startSieve() and stopSieve()
+///
+void ChunkPolicy::newInterval()
+{
+  double time = getTime();
+
+  if (intervalStart_ >= 0)
+  {
+    double sieveTime = sieveTime_ + (time - sieveStart_);
+    double totalTime = time - intervalStart_;
+
+    if (totalTime > 0)
+    {
+      double sieveShare = sieveTime / totalTime;
+
+      if (sieveShare >= 0.5)
+        growth_ = 4;
+      else if (sieveShare >= 0.1)
+        growth_ = 2;
+      else
+        growth_ = 1;
+    }
+  }
+
+  intervalStart_ = time;
+  sieveStart_ = time;
+  sieveTime_ = 0;
+}
+
+/// Used by skipto(), returns true if it is cheaper to sieve
+/// forward from the last generated prime up to start (using
+/// the current PrimeGenerator) than to sieve a new interval.
+/// A new interval needs to generate the sieving primes up
+/// to sqrt(stop) and to sieve at least one segment.
+///
+bool IteratorHelper::isFastForward(uint64_t prime,
+                                   uint64_t start,
+                                   uint64_t stop)
+{
+  if (start < prime ||
+      start >= stop)
+    return false;
+
+  uint64_t segmentDist = get_sieve_size() * 30ull << 10;
+  uint64_t maxDist = max(isqrt(start), segmentDist);
+
+  return start - prime <= maxDist;
+}
+
+void IteratorState::save(uint8_t* state) const
+{
+  copy_n(stateMagic, 5, state);
+  state[5] = (uint8_t) mode;
+  state[6] = 0;
+  state[7] = 0;
+
+  putUint64(&state[8], start);
+  putUint64(&state[16], stop);
+  putUint64(&state[24], stopHint);
+  putUint64(&state[32], dist);
+  putUint64(&state[40], position);
+}
+
+void IteratorState::save(uint8_t* state,
+                         int mode,
+                         uint64_t start,
+                         uint64_t stop,
+                         uint64_t stopHint,
+                         uint64_t dist,
+                         uint64_t skipto,
+                         const uint64_t* primes,
+                         size_t i)
+{
+  IteratorState s;
+  s.mode = mode;
+  s.start = start;
+  s.stop = stop;
+  s.stopHint = stopHint;
+  s.dist = dist;
+  s.position = start;
+
+  if (mode != FRESH)
+    s.position = (skipto) ? skipto : primes[i];
+
+  s.save(state);
+}
+
+void IteratorState::load(const uint8_t* state)
+{
+  if (!equal(stateMagic, stateMagic + 5, state))
+    throw primesieve_error("invalid iterator state");
+
+  mode = state[5];
+  start = getUint64(&state[8]);
+  stop = getUint64(&state[16]);
+  stopHint = getUint64(&state[24]);
+  dist = getUint64(&state[32]);
+  position = getUint64(&state[40]);
+
+  if (mode > PREV ||
+      (mode != FRESH && start > stop))
+    throw primesieve_error("invalid iterator state");
 }
 
 } // namespace
@@ -0,0 +1,261 @@
+///
+/// @file   LinearSieve.cpp
+/// @brief  LinearSieve finds the primes p for which a * p + b is
+///         also prime, e.g. a = 2, b = 1 finds the Sophie Germain
+///         primes. Each segment of the p sieve is processed
+///         together with the matching segments of a second sieve
+///         (PrimeLookup) over [a * start + b, a * stop + b]. Both
+///         sieves share the same stream of sieving primes. For
+///         each prime p of the current segment the bit of
+///         a * p + b is looked up in the second sieve array,
+///         which uses the same 30 numbers per byte layout.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/LinearSieve.hpp>
+#include <primesieve/Erat.hpp>
+#include <primesieve/littleendian_cast.hpp>
+#include <primesieve/pmath.hpp>
+#include <primesieve/PreSieve.hpp>
+#include <primesieve/PrimeSieve.hpp>
+#include <primesieve/primesieve_error.hpp>
+#include <primesieve/SievingPrimes.hpp>
+#include <primesieve/types.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+using namespace std;
+
+namespace primesieve {
+
+void SharedPrimes::init(Erat* erat, PreSieve& preSieve)
+{
+  sievingPrimes_.init(erat, preSieve);
+}
+
+/// @start:     Sieve primes >= start
+/// @stop:      Sieve primes <= stop
+/// @sieveSize: Sieve size in KiB
+/// @preSieve:  Pre-sieve small primes
+/// @sievingPrimes: Shared sieving primes
+///
+void PrimeLookup::init(uint64_t start,
+                       uint64_t stop,
+                       uint64_t sieveSize,
+                       PreSieve& preSieve,
+                       SharedPrimes* sievingPrimes)
+{
+  sievingPrimes_ = sievingPrimes;
+  Erat::init(start, stop, sieveSize, preSieve);
+}
+
+void PrimeLookup::sieveSegment()
+{
+  low_ = segmentLow_;
+  uint64_t sqrtHigh = isqrt(segmentHigh_);
+
+  if (!prime_)
+    prime_ = sievingPrimes_->next(1);
+
+  while (prime_ <= sqrtHigh)
+  {
+    addSievingPrime(prime_);
+    prime_ = sievingPrimes_->next(1);
+  }
+
+  Erat::sieveSegment();
+
+  if (hasNextSegment())
+    high_ = low_ + sieveSize_ * 30 + 6;
+  else
+    high_ = stop_;
+}
+
+/// @pre n >= start_ && n <= stop_ && n >= 7
+/// @pre n >= previous n
+///
+bool PrimeLookup::isPrime(uint64_t n)
+{
+  assert(n >= start_ && n <= stop_);
+
+  while (n > high_)
+    sieveSegment();
+
+  // The sieve array holds the numbers coprime to 30,
+  // unsetLarger_[rem] ^ unsetLarger_[rem - 1] is the bit
+  // of n or 0 if n is divisible by 2, 3 or 5.
+  uint64_t rem = byteRemainder(n);
+  uint64_t i = (n - rem - low_) / 30;
+  byte_t bit = unsetLarger_[rem] ^ unsetLarger_[rem - 1];
+
+  return (sieve_[i] & bit) != 0;
+}
+
+LinearSieve::LinearSieve(PrimeSieve& ps) :
+  a_(ps.getLinearA()),
+  b_(ps.getLinearB()),
+  counts_(ps.getCounts()),
+  ps_(ps)
+{
+  if (a_ == 0)
+    throw primesieve_error("LinearSieve: a must be > 0");
+
+  uint64_t start = ps.getStart();
+  uint64_t stop = ps.getStop();
+  uint64_t maxStop = numeric_limits<uint64_t>::max();
+  uint64_t maxB = (uint64_t) max<int64_t>(b_, 0);
+
+  if (stop > (maxStop - maxB) / a_)
+    throw primesieve_error("LinearSieve: a * stop + b > 2^64");
+
+  if (start > stop)
+    return;
+
+  // The primes p <= 5 are not sieved but their
+  // a * p + b values are looked up.
+  uint64_t sieveStart = max<uint64_t>(start, 7);
+  uint64_t lookupStart = linearForm(max<uint64_t>(start, 2));
+  uint64_t lookupStop = linearForm(stop);
+  lookupStart = max<uint64_t>(lookupStart, 7);
+  isLookup_ = lookupStart <= lookupStop;
+
+  // Both sieves share the PreSieve object,
+  // it must not change after initialization.
+  uint64_t sieveSize = ps.getSieveSize();
+  PreSieve& preSieve = ps.getPreSieve();
+  preSieve.init(sieveStart, stop);
+  if (isLookup_)
+    preSieve.init(lookupStart, lookupStop);
+
+  Erat::init(sieveStart, stop, sieveSize, preSieve);
+
+  if (isLookup_)
+  {
+    lookup_.init(lookupStart, lookupStop, sieveSize, preSieve, &sievingPrimes_);
+
+    // generate sieving primes up to the larger stop
+    if (lookupStop > stop_)
+      sievingPrimes_.init(&lookup_, preSieve);
+    else
+      sievingPrimes_.init(this, preSieve);
+  }
+  else if (hasNextSegment())
+    sievingPrimes_.init(this, preSieve);
+}
+
+/// Returns a * p + b, or 0 if a * p + b < 0
+uint64_t LinearSieve::linearForm(uint64_t p) const
+{
+  uint64_t ap = a_ * p;
+
+  if (b_ >= 0)
+    return ap + (uint64_t) b_;
+
+  uint64_t absB = ~((uint64_t) b_) + 1;
+  return (ap > absB) ? ap - absB : 0;
+}
+
+bool LinearSieve::isPrime(uint64_t n)
+{
+  if (n < 7)
+    return n == 2 || n == 3 || n == 5;
+  else
+    return lookup_.isPrime(n);
+}
+
+/// Process the primes p <= 5
+void LinearSieve::processSmallPrimes()
+{
+  ostringstream pairs;
+
+  for (uint64_t p : { 2, 3, 5 })
+  {
+    if (p < ps_.getStart() ||
+        p > ps_.getStop())
+      continue;
+
+    uint64_t q = linearForm(p);
+
+    if (isPrime(q))
+    {
+      if (ps_.isCountPrimes())
+        counts_[0]++;
+      if (ps_.isPrintPrimes())
+        pairs << "(" << p << ", " << q << ")\n";
+    }
+  }
+
+  cout << pairs.str();
+}
+
+void LinearSieve::sieve()
+{
+  processSmallPrimes();
+
+  if (!hasNextSegment())
+    return;
+
+  uint64_t prime = sievingPrimes_.next(0);
+
+  while (hasNextSegment())
+  {
+    low_ = segmentLow_;
+    uint64_t sqrtHigh = isqrt(segmentHigh_);
+
+    for (; prime <= sqrtHigh; prime = sievingPrimes_.next(0))
+      addSievingPrime(prime);
+
+    sieveSegment();
+    process();
+
+    if (ps_.isStatus())
+      ps_.updateStatus(sieveSize_ * 30);
+  }
+}
+
+/// Look up a * p + b for each prime p of
+/// the current segment.
+///
+void LinearSieve::process()
+{
+  uint64_t count = 0;
+  uint64_t low = low_;
+  bool isPrint = ps_.isPrintPrimes();
+  ostringstream pairs;
+
+  for (uint64_t i = 0; i < sieveSize_; i += 8)
+  {
+    uint64_t bits = littleendian_cast<uint64_t>(&sieve_[i]);
+
+    while (bits)
+    {
+      uint64_t p = nextPrime(&bits, low);
+      uint64_t q = linearForm(p);
+
+      if (isPrime(q))
+      {
+        count++;
+        if (isPrint)
+          pairs << "(" << p << ", " << q << ")\n";
+      }
+    }
+
+    low += 8 * 30;
+  }
+
+  if (ps_.isCountPrimes())
+    counts_[0] += count;
+  if (isPrint)
+    cout << pairs.str();
+}
+
+} // namespace
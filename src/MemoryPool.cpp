@@ -10,6 +10,13 @@
 ///        doing any memory allocation as long as the MemoryPool's
 ///        stock is not empty.
 ///
+///        Sparsely populated bucket lists (e.g. when sieving small
+///        intervals) use a smaller bucket size class. All buckets
+///        of a MemoryPool have the same size, else a sieving
+///        prime's bucket could not be found using its address.
+///        trim() frees the chunks of memory whose buckets are all
+///        unused, e.g. after sieving a large interval.
+///
 /// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
 ///
 /// This file is distributed under the BSD License. See the COPYING
@@ -19,36 +26,172 @@
 #include <primesieve/MemoryPool.hpp>
 #include <primesieve/config.hpp>
 #include <primesieve/Bucket.hpp>
+#include <primesieve/pmath.hpp>
+#include <primesieve/Profile.hpp>
 #include <primesieve/primesieve_error.hpp>
 
+#include <stdint.h>
 #include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <memory>
+#include <mutex>
 #include <vector>
 
-using std::size_t;
-using std::unique_ptr;
+using namespace std;
+
+namespace {
+
+/// Statistics of all memory pools
+atomic<uint64_t> allocations(0);
+atomic<uint64_t> totalBytes(0);
+atomic<uint64_t> peakBytes(0);
+
+/// The buckets in use are counted per memory pool
+/// (without atomic RMW in the sieving hot loop) and
+/// are summed when the statistics are read.
+mutex poolsMutex;
+vector<const primesieve::MemoryPool*> pools;
+uint64_t peakBucketsInUse = 0;
+
+void updatePeak(atomic<uint64_t>& peak, uint64_t n)
+{
+  uint64_t old = peak.load(memory_order_relaxed);
+
+  while (n > old &&
+         !peak.compare_exchange_weak(old, n, memory_order_relaxed))
+    { }
+}
+
+void addBytes(uint64_t bytes)
+{
+  uint64_t total = totalBytes += bytes;
+  updatePeak(peakBytes, total);
+}
+
+} // namespace
 
 namespace primesieve {
 
-void MemoryPool::reset(SievingPrime*& sievingPrime)
+MemoryPool::MemoryPool()
+{
+  lock_guard<mutex> lock(poolsMutex);
+  pools.push_back(this);
+}
+
+MemoryPool::~MemoryPool()
+{
+  totalBytes -= bytes_;
+
+  // Publish the peak of this pool
+  getStats();
+  lock_guard<mutex> lock(poolsMutex);
+  pools.erase(find(pools.begin(), pools.end(), this));
+}
+
+MemoryPool::Stats MemoryPool::getStats()
+{
+  Stats stats;
+  stats.bucketsInUse = 0;
+  uint64_t peak = 0;
+
+  {
+    lock_guard<mutex> lock(poolsMutex);
+
+    for (auto pool : pools)
+    {
+      stats.bucketsInUse += pool->bucketsInUse_.load(memory_order_relaxed);
+      peak += pool->peakBucketsInUse_.load(memory_order_relaxed);
+    }
+
+    peakBucketsInUse = max(peakBucketsInUse, peak);
+    stats.peakBucketsInUse = peakBucketsInUse;
+  }
+
+  stats.allocations = allocations;
+  stats.bytes = totalBytes;
+  stats.peakBytes = peakBytes;
+  return stats;
+}
+
+/// Smallest size class whose buckets can hold the
+/// average number of sieving primes per bucket list.
+/// The largest size class is set by the tuning profile.
+///
+size_t MemoryPool::getBucketBytes(uint64_t sievingPrimesPerList)
+{
+  size_t maxBytes = Profile::get().bucketBytes;
+  size_t bytes = config::MIN_BUCKET_BYTES;
+
+  while (bytes < maxBytes &&
+         Bucket::getCapacity(bytes) < sievingPrimesPerList)
+    bytes *= 2;
+
+  return bytes;
+}
+
+/// Called after all buckets have been returned to the stock
+/// (for sieving a new interval). Choose the size class for
+/// the new interval and free the memory of the previous
+/// interval if it uses more than twice what is needed.
+///
+/// @sievingPrimes: Upper bound for the number of sieving primes
+/// @lists:         Number of bucket lists
+///
+void MemoryPool::init(uint64_t sievingPrimes, uint64_t lists)
+{
+  lists = max<uint64_t>(lists, 1);
+  setBucketBytes(getBucketBytes(sievingPrimes / lists));
+
+  uint64_t bytes = sievingPrimes * sizeof(SievingPrime);
+  bytes += lists * bucketBytes_;
+
+  if (bytes_ > bytes * 2)
+    trim();
+}
+
+/// Change the size class of the buckets.
+/// @pre All buckets must be in the stock.
+///
+void MemoryPool::setBucketBytes(size_t bytes)
+{
+  bytes = inBetween(config::MIN_BUCKET_BYTES, bytes, config::BUCKET_BYTES);
+  bytes = floorPow2(bytes);
+
+  if (bytes != bucketBytes_)
+  {
+    assert(bucketsInUse_ == 0);
+    freeAll();
+    bucketBytes_ = bytes;
+  }
+}
+
+Bucket* MemoryPool::popBucket()
 {
   if (!stock_)
     allocateBuckets();
 
   Bucket* bucket = stock_;
   stock_ = stock_->next();
+
+  size_t inUse = bucketsInUse_.load(memory_order_relaxed) + 1;
+  bucketsInUse_.store(inUse, memory_order_relaxed);
+  if (inUse > peakBucketsInUse_.load(memory_order_relaxed))
+    peakBucketsInUse_.store(inUse, memory_order_relaxed);
+
+  return bucket;
+}
+
+void MemoryPool::reset(SievingPrime*& sievingPrime)
+{
+  Bucket* bucket = popBucket();
   bucket->setNext(nullptr);
   sievingPrime = bucket->begin();
 }
 
 void MemoryPool::addBucket(SievingPrime*& sievingPrime)
 {
-  if (!stock_)
-    allocateBuckets();
-
-  Bucket* bucket = stock_;
-  stock_ = stock_->next();
-
+  Bucket* bucket = popBucket();
   Bucket* old = getBucket(sievingPrime);
   old->setEnd(sievingPrime);
   bucket->setNext(old);
@@ -60,55 +203,154 @@ void MemoryPool::freeBucket(Bucket* bucket)
   bucket->reset();
   bucket->setNext(stock_);
   stock_ = bucket;
+  size_t inUse = bucketsInUse_.load(memory_order_relaxed);
+  bucketsInUse_.store(inUse - 1, memory_order_relaxed);
+}
+
+/// Move all buckets of the sieving prime's
+/// bucket list back to the stock.
+///
+void MemoryPool::freeBuckets(SievingPrime* sievingPrime)
+{
+  Bucket* bucket = getBucket(sievingPrime);
+
+  while (bucket)
+  {
+    Bucket* next = bucket->next();
+    freeBucket(bucket);
+    bucket = next;
+  }
 }
 
 void MemoryPool::allocateBuckets()
 {
-  if (memory_.empty())
-    memory_.reserve(128);
+  if (chunks_.empty())
+    chunks_.reserve(128);
 
-  // allocate a large chunk of memory
-  size_t bytes = count_ * sizeof(Bucket);
-  char* memory = new char[bytes];
-  memory_.emplace_back(unique_ptr<char[]>(memory));
-  void* ptr = memory;
+  // allocate a large chunk of memory, the
+  // extra bucket is used for alignment
+  size_t bytes = (count_ + 1) * bucketBytes_;
+  Chunk chunk;
+  chunk.memory.reset(new char[bytes]);
+  chunk.bytes = bytes;
+  chunk.count = count_;
 
-  // align pointer address to sizeof(Bucket)
-  if (!std::align(sizeof(Bucket), sizeof(Bucket), ptr, bytes))
+  // align pointer address to bucketBytes_
+  void* ptr = chunk.memory.get();
+  if (!std::align(bucketBytes_, count_ * bucketBytes_, ptr, bytes))
     throw primesieve_error("MemoryPool: failed to align memory!");
 
-  initBuckets(ptr, bytes);
+  chunk.buckets = (char*) ptr;
+  initBuckets(chunk);
+  bytes_ += chunk.bytes;
+  buckets_ += chunk.count;
+  allocations++;
+  addBytes(chunk.bytes);
+  chunks_.emplace_back(move(chunk));
   increaseAllocCount();
 }
 
-void MemoryPool::initBuckets(void* memory, size_t bytes)
+/// Add the chunk's buckets to the stock
+void MemoryPool::initBuckets(Chunk& chunk)
 {
-  Bucket* buckets = (Bucket*) memory;
-  count_ = bytes / sizeof(Bucket);
-  size_t i = 0;
-
-  if ((size_t) buckets % sizeof(Bucket) != 0)
+  if ((size_t) chunk.buckets % bucketBytes_ != 0)
     throw primesieve_error("MemoryPool: failed to align memory!");
 
-  if (count_ < 10)
+  if (chunk.count < 10)
     throw primesieve_error("MemoryPool: insufficient buckets allocated!");
 
-  for (; i + 1 < count_; i++)
+  for (size_t i = chunk.count; i-- > 0;)
   {
-    buckets[i].reset();
-    buckets[i].setNext(&buckets[i + 1]);
+    Bucket* bucket = (Bucket*) &chunk.buckets[i * bucketBytes_];
+    bucket->reset();
+    bucket->setNext(stock_);
+    stock_ = bucket;
   }
-
-  buckets[i].reset();
-  buckets[i].setNext(nullptr);
-  stock_ = buckets;
 }
 
 void MemoryPool::increaseAllocCount()
 {
   count_ += count_ / 8;
-  size_t maxCount = config::MAX_ALLOC_BYTES / sizeof(Bucket);
+  size_t maxCount = config::MAX_ALLOC_BYTES / bucketBytes_;
   count_ = std::min(count_, maxCount);
 }
 
+/// Free all memory
+/// @pre All buckets must be in the stock.
+///
+void MemoryPool::freeAll()
+{
+  totalBytes -= bytes_;
+  chunks_.clear();
+  stock_ = nullptr;
+  bytes_ = 0;
+  buckets_ = 0;
+  count_ = 64;
+}
+
+/// Free the chunks of memory whose
+/// buckets are all in the stock.
+///
+void MemoryPool::trim()
+{
+  if (buckets_ - bucketsInUse_ == 0)
+    return;
+
+  if (bucketsInUse_ == 0)
+  {
+    freeAll();
+    return;
+  }
+
+  sort(chunks_.begin(), chunks_.end(),
+       [](const Chunk& a, const Chunk& b) { return a.buckets < b.buckets; });
+
+  // Chunk index of the bucket
+  auto getChunk = [&](Bucket* bucket)
+  {
+    auto iter = upper_bound(chunks_.begin(), chunks_.end(), (char*) bucket,
+                            [](char* address, const Chunk& c) { return address < c.buckets; });
+    return (iter - chunks_.begin()) - 1;
+  };
+
+  vector<size_t> unused(chunks_.size(), 0);
+
+  for (Bucket* bucket = stock_; bucket; bucket = bucket->next())
+    unused[getChunk(bucket)]++;
+
+  // Remove the buckets of the unused
+  // chunks from the stock.
+  Bucket* stock = stock_;
+  stock_ = nullptr;
+
+  while (stock)
+  {
+    Bucket* bucket = stock;
+    stock = stock->next();
+    size_t i = getChunk(bucket);
+
+    if (unused[i] != chunks_[i].count)
+    {
+      bucket->setNext(stock_);
+      stock_ = bucket;
+    }
+  }
+
+  vector<Chunk> chunks;
+
+  for (size_t i = 0; i < chunks_.size(); i++)
+  {
+    if (unused[i] != chunks_[i].count)
+      chunks.emplace_back(move(chunks_[i]));
+    else
+    {
+      bytes_ -= chunks_[i].bytes;
+      buckets_ -= chunks_[i].count;
+      totalBytes -= chunks_[i].bytes;
+    }
+  }
+
+  chunks_ = move(chunks);
+}
+
 } // namespace
@@ -9,8 +9,12 @@
 ///
 
 #include <primesieve/config.hpp>
+#include <primesieve/CountsCache.hpp>
 #include <primesieve/ParallelSieve.hpp>
+#include <primesieve/PerfCounters.hpp>
 #include <primesieve/PrimeSieve.hpp>
+#include <primesieve/SieveStats.hpp>
+#include <primesieve/Trace.hpp>
 #include <primesieve/pmath.hpp>
 #include <primesieve/types.hpp>
 
@@ -21,6 +25,8 @@
 #include <chrono>
 #include <future>
 #include <mutex>
+#include <string>
+#include <utility>
 #include <vector>
 
 using namespace std;
@@ -125,31 +131,132 @@ uint64_t ParallelSieve::align(uint64_t n) const
     return n32 - n % 30;
 }
 
+/// If the last sieve() call used a single thread
+/// (no heap allocation) the stats of that thread
+/// are computed on demand.
+///
+vector<ParallelSieve::ThreadStats> ParallelSieve::getThreadStats() const
+{
+  if (!threadStats_.empty())
+    return threadStats_;
+
+  ThreadStats stats;
+  stats.chunks = 1;
+  stats.busySeconds = seconds_;
+  stats.finishSeconds = seconds_;
+
+  return { stats };
+}
+
 /// Print sieving status to stdout
 bool ParallelSieve::tryUpdateStatus(uint64_t dist)
 {
+  TraceScope trace(Trace::STATUS, dist);
   unique_lock<mutex> lock(mutex_, try_to_lock);
 
   if (lock.owns_lock())
     updateStatus(dist);
 
+  trace.setArg2(lock.owns_lock());
+
   return lock.owns_lock();
 }
 
+/// The counts cache is only used for counting
+/// inside intervals that contain whole blocks.
+///
+bool ParallelSieve::isCountsCache() const
+{
+  uint64_t first, last;
+
+  return useCountsCache_ &&
+         isFlag(COUNT_PRIMES, COUNT_SEXTUPLETS) &&
+         !isPrint() &&
+         !isStatus() &&
+         !isLinearForm() &&
+         !tableStep_ &&
+         !sharedMemory_ &&
+         countsCache.isEnabled() &&
+         CountsCache::getBlocks(start_, stop_, &first, &last);
+}
+
+/// Add the counts of the cached blocks inside [start_, stop_],
+/// sieve the missing blocks and the edges and add the
+/// counts of the missing blocks to the cache.
+///
+void ParallelSieve::sieveCountsCache()
+{
+  auto t1 = chrono::system_clock::now();
+  uint64_t first, last;
+  CountsCache::getBlocks(start_, stop_, &first, &last);
+
+  int flags = 0;
+  for (int i = 0; i < 6; i++)
+    if (isCount(i))
+      flags |= COUNT_PRIMES << i;
+
+  auto sieveRange = [&](uint64_t start, uint64_t stop)
+  {
+    ParallelSieve ps;
+    ps.useCountsCache_ = false;
+    ps.setSieveSize(getSieveSize());
+    ps.setNumThreads(numThreads_);
+    ps.sieve(start, stop, flags);
+    stats_ += ps.getStats();
+    return ps.getCounts();
+  };
+
+  for (uint64_t block = first; block <= last; block++)
+  {
+    counts_t counts;
+
+    if (!countsCache.find(block, flags, counts))
+    {
+      counts = sieveRange(CountsCache::blockStart(block),
+                          CountsCache::blockStop(block));
+      countsCache.insert(block, flags, counts);
+    }
+
+    counts_ += counts;
+  }
+
+  if (start_ < CountsCache::blockStart(first))
+    counts_ += sieveRange(start_, CountsCache::blockStart(first) - 1);
+  if (stop_ > CountsCache::blockStop(last))
+    counts_ += sieveRange(CountsCache::blockStop(last) + 1, stop_);
+
+  auto t2 = chrono::system_clock::now();
+  chrono::duration<double> seconds = t2 - t1;
+  seconds_ = seconds.count();
+}
+
 /// Sieve the primes and prime k-tuplets in [start, stop]
 /// in parallel using multi-threading.
 ///
 void ParallelSieve::sieve()
 {
   reset();
+  threadStats_.clear();
 
   if (start_ > stop_)
     return;
 
+  TraceScope trace(Trace::SIEVE, start_, stop_);
+
+  if (isCountsCache())
+  {
+    sieveCountsCache();
+    return;
+  }
+
   int threads = idealNumThreads();
+  threads = fitMaxMemory(threads);
 
   if (threads == 1)
+  {
+    TraceScope chunk(Trace::CHUNK, start_, stop_);
     PrimeSieve::sieve();
+  }
   else
   {
     setStatus(0);
@@ -160,10 +267,36 @@ void ParallelSieve::sieve()
     threads = inBetween(1, threads, iters);
     atomic<uint64_t> i(0);
 
+    // Each chunk stores its own table counts
+    // which are later combined using prefix sums
+    vector<counts_t> chunkCounts;
+    vector<vector<counts_t>> chunkTables;
+
+    if (tableStep_)
+    {
+      chunkCounts.resize(iters);
+      chunkTables.resize(iters);
+    }
+
+    // Each thread counts its own hardware events
+    if (isPerf_)
+      perfValues_.resize(max<size_t>(perfValues_.size(), threads));
+
+    threadStats_.resize(threads);
+
     // Each thread executes 1 task
-    auto task = [&]()
+    auto task = [&](int thread)
     {
+      if (Trace::isEnabled())
+        Trace::setThreadName("worker " + to_string(thread));
+
       PrimeSieve ps(this);
+      PerfCounters perf;
+      if (isPerf_)
+        perf.start();
+
+      SieveStats stats;
+      ThreadStats& threadStats = threadStats_[thread];
       uint64_t j;
       counts_t counts;
       counts.fill(0);
@@ -177,8 +310,35 @@ void ParallelSieve::sieve()
           start = align(start) + 1;
 
         // Sieve the primes inside [start, stop]
-        ps.sieve(start, stop);
+        {
+          TraceScope chunk(Trace::CHUNK, start, stop);
+          ps.sieve(start, stop);
+        }
         counts += ps.getCounts();
+        stats += ps.getStats();
+        threadStats.chunks++;
+        threadStats.busySeconds += ps.getSeconds();
+
+        if (tableStep_)
+        {
+          chunkCounts[j] = ps.getCounts();
+          chunkTables[j] = move(ps.getTable());
+        }
+      }
+
+      if (isPerf_)
+      {
+        perf.stop();
+        perfValues_[thread] += perf.getValues();
+      }
+
+      chrono::duration<double> finish = chrono::system_clock::now() - t1;
+      threadStats.finishSeconds = finish.count();
+
+      if (SieveStats::isEnabled())
+      {
+        lock_guard<mutex> lock(mutex_);
+        stats_ += stats;
       }
 
       return counts;
@@ -188,14 +348,31 @@ void ParallelSieve::sieve()
     futures.reserve(threads);
 
     for (int t = 0; t < threads; t++)
-      futures.emplace_back(async(launch::async, task));
+      futures.emplace_back(async(launch::async, task, t));
 
-    for (auto &f : futures)
-      counts_ += f.get();
+    for (int t = 0; t < threads; t++)
+    {
+      TraceScope wait(Trace::WAIT, t);
+      counts_ += futures[t].get();
+    }
+
+    counts_t sum;
+    sum.fill(0);
+
+    for (size_t j = 0; j < chunkTables.size(); j++)
+    {
+      for (auto& counts : chunkTables[j])
+        table_.push_back(counts += sum);
+      sum += chunkCounts[j];
+    }
 
     auto t2 = chrono::system_clock::now();
     chrono::duration<double> seconds = t2 - t1;
     seconds_ = seconds.count();
+
+    if (SieveStats::isEnabled())
+      SieveStats::addGlobal(stats_);
+
     setStatus(100);
   }
 
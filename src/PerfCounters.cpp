@@ -0,0 +1,178 @@
+///
+/// @file   PerfCounters.cpp
+/// @brief  Count hardware events of the calling thread using
+///         Linux perf_event_open(). The kernel may multiplex
+///         the events if there are fewer hardware counters
+///         than events, hence the counts are scaled by
+///         time_enabled / time_running.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/PerfCounters.hpp>
+
+#include <stdint.h>
+#include <array>
+#include <cstring>
+
+#if defined(__linux__)
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+  #define HAVE_PERF_EVENTS
+#endif
+
+using namespace std;
+
+namespace {
+
+const char* eventNames[] =
+{
+  "Cycles",
+  "Instructions",
+  "L1d misses",
+  "LLC misses",
+  "dTLB misses",
+  "Branch misses"
+};
+
+#if defined(HAVE_PERF_EVENTS)
+
+struct EventType
+{
+  uint32_t type;
+  uint64_t config;
+};
+
+uint64_t cacheMiss(uint64_t cache)
+{
+  return cache |
+         (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+const array<EventType, primesieve::PerfCounters::EVENTS> eventTypes =
+{{
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+  { PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_L1D) },
+  { PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_LL) },
+  { PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_DTLB) },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+}};
+
+/// Count the event in user space for the
+/// calling thread on any CPU.
+///
+int openEvent(const EventType& event)
+{
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = event.type;
+  attr.config = event.config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                     PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+#endif
+
+} // namespace
+
+namespace primesieve {
+
+bool PerfCounters::Values::isAvailable() const
+{
+  for (bool a : available)
+    if (a)
+      return true;
+
+  return false;
+}
+
+PerfCounters::Values& PerfCounters::Values::operator+=(const Values& other)
+{
+  for (int i = 0; i < EVENTS; i++)
+  {
+    counts[i] += other.counts[i];
+    available[i] = available[i] || other.available[i];
+  }
+
+  return *this;
+}
+
+const char* PerfCounters::getName(int event)
+{
+  return eventNames[event];
+}
+
+PerfCounters::~PerfCounters()
+{
+#if defined(HAVE_PERF_EVENTS)
+  for (int fd : fds_)
+    if (fd >= 0)
+      close(fd);
+#endif
+}
+
+void PerfCounters::open()
+{
+  isOpen_ = true;
+
+#if defined(HAVE_PERF_EVENTS)
+  for (int i = 0; i < EVENTS; i++)
+    fds_[i] = openEvent(eventTypes[i]);
+#endif
+}
+
+void PerfCounters::start()
+{
+  if (!isOpen_)
+    open();
+
+#if defined(HAVE_PERF_EVENTS)
+  for (int fd : fds_)
+    if (fd >= 0)
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+/// Disable the events and read their counts
+void PerfCounters::stop()
+{
+#if defined(HAVE_PERF_EVENTS)
+  for (int i = 0; i < EVENTS; i++)
+  {
+    int fd = fds_[i];
+    if (fd < 0)
+      continue;
+
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+    // value, time_enabled, time_running
+    uint64_t data[3];
+    if (read(fd, data, sizeof(data)) != sizeof(data))
+      continue;
+
+    values_.available[i] = true;
+    double scale = 1;
+    if (data[2] > 0 && data[2] < data[1])
+      scale = (double) data[1] / data[2];
+
+    // The events are disabled in between stop() and
+    // start(), hence they only count while enabled.
+    values_.counts[i] = (uint64_t) (data[0] * scale);
+  }
+#endif
+}
+
+} // namespace
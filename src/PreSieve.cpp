@@ -31,6 +31,7 @@
 #include <primesieve/PreSieve.hpp>
 #include <primesieve/EratSmall.hpp>
 #include <primesieve/pmath.hpp>
+#include <primesieve/ShmSegment.hpp>
 #include <primesieve/types.hpp>
 
 #include <stdint.h>
@@ -38,6 +39,7 @@
 #include <array>
 #include <iterator>
 #include <memory>
+#include <string>
 
 using namespace std;
 
@@ -78,10 +80,36 @@ void PreSieve::initBuffer(uint64_t maxPrime,
   maxPrime_ = maxPrime;
   primeProduct_ = primeProduct;
   size_ = primeProduct_ / 30;
+  deleter_.reset();
+  shm_.reset();
 
-  buffer_ = new byte_t[size_];
-  deleter_.reset(buffer_);
-  fill_n(buffer_, size_, (byte_t) 0xff);
+  // Small buffers are faster to initialize
+  // than to map into memory.
+  if (maxPrime_ >= 17)
+  {
+    string name = "presieve-" + to_string(maxPrime_);
+    shm_ = ShmSegment::get(name, size_, [this](byte_t* data, size_t)
+    {
+      sieveBuffer(data);
+      return (size_t) size_;
+    });
+  }
+
+  if (shm_ &&
+      shm_->getSize() == size_)
+    buffer_ = shm_->getData();
+  else
+  {
+    deleter_.reset(new byte_t[size_]);
+    sieveBuffer(deleter_.get());
+    buffer_ = deleter_.get();
+  }
+}
+
+/// Remove the multiples of primes <= maxPrime_
+void PreSieve::sieveBuffer(byte_t* buffer) const
+{
+  fill_n(buffer, size_, (byte_t) 0xff);
 
   EratSmall eratSmall;
   uint64_t stop = primeProduct_ * 2;
@@ -91,7 +119,14 @@ void PreSieve::initBuffer(uint64_t maxPrime,
     if (prime <= maxPrime_)
       eratSmall.addSievingPrime(prime, primeProduct_);
 
-  eratSmall.crossOff(buffer_, size_);
+  eratSmall.crossOff(buffer, size_);
+}
+
+/// Delete the shared memory buffers
+void PreSieve::removeShared()
+{
+  for (uint64_t prime : primes)
+    ShmSegment::remove("presieve-" + to_string(prime));
 }
 
 /// Copy pre-sieved buffer to sieve array
@@ -0,0 +1,220 @@
+///
+/// @file  PrevPrimeGenerator.cpp
+///        Generates the primes below the current position of
+///        primesieve::iterator. Each interval [start, stop] is
+///        sieved into a bitmap, afterwards the primes are
+///        decoded in blocks from the top of the bitmap down.
+///        Storing the bitmap instead of all primes of the
+///        interval uses about 8 * log(n) / 30 times less memory,
+///        the small primes buffer of the iterator stays in the
+///        CPU cache.
+///
+///        Unlike creating a new PrimeGenerator for each interval,
+///        the sieving primes are generated only once for the
+///        first (i.e. largest) interval and stored in a compact
+///        gaps array. The following intervals are below the first
+///        one, hence they need a subset of those sieving primes.
+///        The pre-sieve buffer, the sieve array and the bucket
+///        memory of EratMedium and EratBig are reused as well.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/Erat.hpp>
+#include <primesieve/decodePrimes.hpp>
+#include <primesieve/pmath.hpp>
+#include <primesieve/PreSieve.hpp>
+#include <primesieve/PrevPrimeGenerator.hpp>
+#include <primesieve/PrimeGenerator.hpp>
+#include <primesieve/primesieve_error.hpp>
+#include <primesieve/SievingPrimes.hpp>
+#include <primesieve/types.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+/// The primes <= maxSmallPrime are not sieved, they are read
+/// from PrimeBitmap (using PrimeGenerator). pi(311) = 64,
+/// hence they fit into the primes buffer.
+///
+const uint64_t maxSmallPrime = 311;
+
+} // namespace
+
+namespace primesieve {
+
+/// Sieve the primes inside [start, stop], the
+/// intervals should be passed in descending order.
+///
+void PrevPrimeGenerator::init(uint64_t start, uint64_t stop)
+{
+  smallStart_ = 1;
+  smallStop_ = 0;
+  words_ = 0;
+
+  if (start <= maxSmallPrime)
+  {
+    // no sieving required
+    smallStart_ = start;
+    smallStop_ = min(stop, maxSmallPrime);
+    start = maxSmallPrime + 1;
+  }
+
+  if (start > stop)
+    return;
+
+  int sieveSize = get_sieve_size();
+  Erat::init(start, stop, sieveSize, preSieve_);
+
+  if (isqrt(stop) > sqrtStop_)
+    initSievingPrimes();
+
+  sieve();
+}
+
+/// Generate the sieving primes <= sqrt(stop_)
+void PrevPrimeGenerator::initSievingPrimes()
+{
+  SievingPrimes sievingPrimes(this, preSieve_);
+  uint64_t sqrtStop = isqrt(stop_);
+  uint64_t old = preSieve_.getMaxPrime();
+
+  gapsBase_ = old;
+  sqrtStop_ = sqrtStop;
+  gaps_.clear();
+  gaps_.reserve(primeCountApprox(sqrtStop));
+
+  for (uint64_t prime = sievingPrimes.next();
+       prime <= sqrtStop;
+       prime = sievingPrimes.next())
+  {
+    uint64_t gap = (prime - old) / 2;
+    if (gap > 0xff)
+      throw primesieve_error("PrevPrimeGenerator: prime gap > 510");
+    gaps_.push_back((uint8_t) gap);
+    old = prime;
+  }
+}
+
+uint64_t PrevPrimeGenerator::nextSievingPrime()
+{
+  if (gapsIdx_ >= gaps_.size())
+    return ~0ull;
+
+  gapsPrime_ += gaps_[gapsIdx_++] * 2;
+  return gapsPrime_;
+}
+
+/// Sieve [start_, stop_] and copy each
+/// segment into the bitmap.
+///
+void PrevPrimeGenerator::sieve()
+{
+  low_ = segmentLow_;
+  uint64_t rem = byteRemainder(stop_);
+  uint64_t bytes = (stop_ - rem - low_) / 30 + 1;
+  words_ = (bytes + 7) / 8;
+  bitmap_.resize(words_ * 8);
+
+  gapsIdx_ = 0;
+  gapsPrime_ = gapsBase_;
+  prime_ = nextSievingPrime();
+  uint64_t maxPreSieve = preSieve_.getMaxPrime();
+
+  while (hasNextSegment())
+  {
+    uint64_t offset = (segmentLow_ - low_) / 30;
+    uint64_t sqrtHigh = isqrt(segmentHigh_);
+
+    // the pre-sieve buffer may have grown
+    // since the gaps have been generated
+    for (; prime_ <= sqrtHigh; prime_ = nextSievingPrime())
+      if (prime_ > maxPreSieve)
+        addSievingPrime(prime_);
+
+    Erat::sieveSegment();
+
+    // the last segment is padded with zero
+    // bytes up to the next multiple of 8
+    uint64_t size = min(sieveSize_ + 7, bitmap_.size() - offset);
+    size -= size % 8;
+    copy_n(sieve_, size, &bitmap_[offset]);
+  }
+}
+
+/// Fill the primes buffer with the next block of primes
+/// below the primes returned previously. The primes
+/// of the block are stored in ascending order.
+/// @pre primes.size() >= 128
+///
+void PrevPrimeGenerator::fill(vector<uint64_t>& primes,
+                              size_t* size)
+{
+  *size = 0;
+
+  if (!words_)
+  {
+    fillSmallPrimes(primes, size);
+    return;
+  }
+
+  // each 64-bit word contains at most 64 primes and
+  // decodePrimes() writes up to 64 primes past the
+  // current size, find the lowest word of the next block
+  size_t maxSize = primes.size() - 128;
+  size_t count = 0;
+  size_t last = words_;
+  const uint64_t* words = (const uint64_t*) bitmap_.data();
+
+  while (words_ > 0 && count <= maxSize)
+  {
+    words_--;
+    count += popcount(&words[words_], 1);
+  }
+
+  uint64_t idx = words_ * 8;
+  uint64_t low = low_ + words_ * (8 * 30);
+  size_t i = decodePrimes(bitmap_.data(), &idx, last * 8, &low, &primes[0], count);
+
+  assert(i == count);
+  *size = i;
+}
+
+/// The primes <= maxSmallPrime are copied from
+/// PrimeBitmap using PrimeGenerator. If the interval
+/// contains 2 the block starts with 0 which
+/// indicates that there are no more primes.
+///
+void PrevPrimeGenerator::fillSmallPrimes(vector<uint64_t>& primes,
+                                         size_t* size)
+{
+  if (smallStart_ > smallStop_)
+    return;
+
+  vector<uint64_t> smallPrimes;
+
+  if (smallStart_ <= 2)
+    smallPrimes.push_back(0);
+
+  PrimeGenerator primeGenerator(smallStart_, smallStop_);
+  primeGenerator.fill(smallPrimes);
+  assert(smallPrimes.size() <= primes.size());
+
+  copy(smallPrimes.begin(), smallPrimes.end(), primes.begin());
+  *size = smallPrimes.size();
+  smallStart_ = 1;
+  smallStop_ = 0;
+}
+
+} // namespace
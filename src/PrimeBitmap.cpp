@@ -0,0 +1,273 @@
+///
+/// @file   PrimeBitmap.cpp
+/// @brief  Bitmap of the primes < 2^20 with a rank table. The
+///         bitmap uses the same layout as the sieve array, each
+///         byte corresponds to an interval of size 30 and its
+///         8 bits to the numbers coprime to 30. The rank table
+///         stores the number of primes below each block of
+///         64 bytes, hence pi(n) requires at most 63 byte
+///         popcounts.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/PrimeBitmap.hpp>
+#include <primesieve/pmath.hpp>
+#include <primesieve/types.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+using namespace std;
+using namespace primesieve;
+
+namespace {
+
+const uint64_t BLOCK_BYTES = 64;
+const uint64_t BLOCKS = (PrimeBitmap::MAX / 30 + BLOCK_BYTES) / BLOCK_BYTES;
+const uint64_t SIEVE_BYTES = BLOCKS * BLOCK_BYTES;
+
+/// Bit of n % 30 inside a byte of the sieve array
+const array<int, 30> bitIndex =
+{
+  -1, 7, -1, -1, -1, -1, -1, 0, -1, -1,
+  -1, 1, -1, 2, -1, -1, -1, 3, -1, 4,
+  -1, -1, -1, 5, -1, -1, -1, -1, -1, 6
+};
+
+/// Offsets of the 8 bits of a byte of the sieve array
+const array<uint64_t, 8> bitValues = { 7, 11, 13, 17, 19, 23, 29, 31 };
+
+/// Residues modulo 30 that are coprime to 30
+const array<uint64_t, 8> wheel = { 1, 7, 11, 13, 17, 19, 23, 29 };
+
+/// Number of primes <= n for n < 7
+const array<uint64_t, 7> smallPi = { 0, 0, 1, 2, 2, 3, 3 };
+
+struct Table
+{
+  alignas(8) array<byte_t, SIEVE_BYTES> sieve;
+  /// Number of primes >= 7 below each block
+  array<uint32_t, BLOCKS + 1> ranks;
+};
+
+int popcount8(byte_t bits)
+{
+  int count = 0;
+  for (; bits; count++)
+    bits &= bits - 1;
+  return count;
+}
+
+/// Bits of the numbers <= low + r inside the byte
+/// corresponding to [low + 7, low + 31]
+///
+byte_t bitsUpTo(uint64_t r)
+{
+  auto iter = upper_bound(bitValues.begin(), bitValues.end(), r);
+  auto bits = iter - bitValues.begin();
+  return (byte_t) ((1u << bits) - 1);
+}
+
+/// Cross off the multiples prime * q with q >= prime
+/// and q coprime to 30.
+///
+void crossOff(byte_t* sieve, uint64_t prime)
+{
+  for (uint64_t w : wheel)
+  {
+    uint64_t q = prime - prime % 30 + w;
+    if (q < prime)
+      q += 30;
+
+    uint64_t multiple = prime * q;
+    byte_t mask = (byte_t) ~(1 << bitIndex[multiple % 30]);
+
+    for (uint64_t i = (multiple - 7) / 30; i < SIEVE_BYTES; i += prime)
+      sieve[i] &= mask;
+  }
+}
+
+Table initTable()
+{
+  Table table;
+  byte_t* sieve = table.sieve.data();
+  fill_n(sieve, SIEVE_BYTES, (byte_t) 0xff);
+
+  for (uint64_t i = 0; i * 30 + 7 < ctSqrt(PrimeBitmap::MAX); i++)
+    for (int bit = 0; bit < 8; bit++)
+      if (sieve[i] & (1 << bit))
+        crossOff(sieve, i * 30 + bitValues[bit]);
+
+  // Unset the bits of the numbers >= MAX
+  uint64_t last = (PrimeBitmap::MAX - 1 - 7) / 30;
+  sieve[last] &= bitsUpTo(PrimeBitmap::MAX - 1 - last * 30);
+  fill(&sieve[last + 1], &sieve[SIEVE_BYTES], (byte_t) 0);
+
+  table.ranks[0] = 0;
+  const uint64_t* words = (const uint64_t*) sieve;
+
+  for (uint64_t i = 0; i < BLOCKS; i++)
+  {
+    uint64_t count = popcount(&words[i * (BLOCK_BYTES / 8)], BLOCK_BYTES / 8);
+    table.ranks[i + 1] = table.ranks[i] + (uint32_t) count;
+  }
+
+  return table;
+}
+
+/// Generated on first use, it uses static storage
+const Table& getTable()
+{
+  static const Table table = initTable();
+  return table;
+}
+
+} // namespace
+
+namespace primesieve {
+
+constexpr uint64_t PrimeBitmap::MAX;
+
+const byte_t* PrimeBitmap::getSieve()
+{
+  return getTable().sieve.data();
+}
+
+/// @pre n < MAX
+bool PrimeBitmap::isPrime(uint64_t n)
+{
+  assert(n < MAX);
+
+  if (n < 7)
+    return n == 2 || n == 3 || n == 5;
+
+  int bit = bitIndex[n % 30];
+  if (bit < 0)
+    return false;
+
+  auto& sieve = getTable().sieve;
+  return (sieve[(n - 7) / 30] >> bit) & 1;
+}
+
+/// Number of primes <= n
+/// @pre n < MAX
+///
+uint64_t PrimeBitmap::primePi(uint64_t n)
+{
+  assert(n < MAX);
+
+  if (n < 7)
+    return smallPi[n];
+
+  auto& table = getTable();
+  uint64_t i = (n - 7) / 30;
+  uint64_t block = i / BLOCK_BYTES;
+  uint64_t count = 3 + table.ranks[block];
+
+  for (uint64_t j = block * BLOCK_BYTES; j < i; j++)
+    count += popcount8(table.sieve[j]);
+
+  byte_t bits = table.sieve[i] & bitsUpTo(n - i * 30);
+  count += popcount8(bits);
+
+  return count;
+}
+
+/// The nth prime, nthPrime(1) = 2
+/// @pre 1 <= n <= primePi(MAX - 1)
+///
+uint64_t PrimeBitmap::nthPrime(uint64_t n)
+{
+  assert(n >= 1);
+  assert(n <= primePi(MAX - 1));
+
+  if (n <= 3)
+    return (n == 1) ? 2 : n * 2 - 1;
+
+  // find the block that contains the
+  // (n - 3)th prime >= 7
+  auto& table = getTable();
+  auto& ranks = table.ranks;
+  n -= 3;
+  auto iter = lower_bound(ranks.begin(), ranks.end(), n);
+  uint64_t block = (iter - ranks.begin()) - 1;
+  n -= ranks[block];
+
+  for (uint64_t i = block * BLOCK_BYTES; i < SIEVE_BYTES; i++)
+  {
+    byte_t bits = table.sieve[i];
+    uint64_t count = popcount8(bits);
+
+    if (n > count)
+    {
+      n -= count;
+      continue;
+    }
+
+    for (int bit = 0; bit < 8; bit++)
+      if ((bits & (1 << bit)) && --n == 0)
+        return i * 30 + bitValues[bit];
+  }
+
+  return 0;
+}
+
+/// Store the primes inside [*start, stop] in the primes
+/// array, at most maxSize primes are stored. Afterwards
+/// start is set to the first number that has not been
+/// processed yet.
+/// @pre stop < MAX
+///
+size_t PrimeBitmap::getPrimes(uint64_t* start,
+                              uint64_t stop,
+                              uint64_t* primes,
+                              size_t maxSize)
+{
+  assert(stop < MAX);
+
+  uint64_t n = *start;
+  size_t size = 0;
+
+  for (; n < 7 && n <= stop && size < maxSize; n++)
+    if (n == 2 || n == 3 || n == 5)
+      primes[size++] = n;
+
+  auto& sieve = getTable().sieve;
+
+  while (n <= stop && size < maxSize)
+  {
+    uint64_t i = (n - 7) / 30;
+    uint64_t low = i * 30;
+    byte_t bits = sieve[i] & ~bitsUpTo(n - low - 1);
+    n = low + 37;
+
+    for (int bit = 0; bits != 0; bit++)
+    {
+      if (~bits & (1 << bit))
+        continue;
+
+      uint64_t prime = low + bitValues[bit];
+      if (prime > stop ||
+          size >= maxSize)
+      {
+        n = prime;
+        break;
+      }
+
+      primes[size++] = prime;
+      bits &= (byte_t) ~(1 << bit);
+    }
+  }
+
+  *start = max(n, *start);
+  return size;
+}
+
+} // namespace
@@ -13,7 +13,9 @@
 ///
 
 #include <primesieve/Erat.hpp>
+#include <primesieve/littleendian_cast.hpp>
 #include <primesieve/PreSieve.hpp>
+#include <primesieve/PrimeBitmap.hpp>
 #include <primesieve/PrimeGenerator.hpp>
 #include <primesieve/pmath.hpp>
 #include <primesieve/SievingPrimes.hpp>
@@ -21,99 +23,101 @@
 
 #include <stdint.h>
 #include <algorithm>
-#include <array>
-#include <cassert>
 #include <vector>
 
 using namespace std;
 
 namespace primesieve {
 
-/// First 64 primes
-const array<uint64_t, 64> PrimeGenerator::smallPrimes =
+PrimeGenerator::PrimeGenerator(uint64_t start, uint64_t stop) :
+  Erat(start, stop),
+  bitmapStart_(start)
+{ }
+
+/// Reinitialize PrimeGenerator to generate the primes inside
+/// [start, stop], the sieve array and the bucket memory of
+/// the previous interval are reused.
+///
+void PrimeGenerator::init(uint64_t start, uint64_t stop)
 {
-    2,   3,   5,   7,  11,  13,  17,  19,
-   23,  29,  31,  37,  41,  43,  47,  53,
-   59,  61,  67,  71,  73,  79,  83,  89,
-   97, 101, 103, 107, 109, 113, 127, 131,
-  137, 139, 149, 151, 157, 163, 167, 173,
-  179, 181, 191, 193, 197, 199, 211, 223,
-  227, 229, 233, 239, 241, 251, 257, 263,
-  269, 271, 277, 281, 283, 293, 307, 311
-};
-
-/// Number of primes <= n
-const array<uint8_t, 312> PrimeGenerator::primePi =
+  start_ = start;
+  stop_ = stop;
+  segmentLow_ = ~0ull;
+  segmentHigh_ = 0;
+  low_ = 0;
+  sieveIdx_ = ~0ull;
+  prime_ = 0;
+  bitmapStart_ = start;
+  isInit_ = false;
+  finished_ = false;
+}
+
+/// Fast-forward to the first 64-bit word of the sieve array
+/// that contains numbers > n. The segments below n are sieved
+/// (the sieving primes must be moved forward) but their
+/// primes are never extracted.
+/// @pre n >= last generated prime
+///
+void PrimeGenerator::skipto(uint64_t n)
 {
-   0,  0,  1,  2,  2,  3,  3,  4,  4,  4,
-   4,  5,  5,  6,  6,  6,  6,  7,  7,  8,
-   8,  8,  8,  9,  9,  9,  9,  9,  9, 10,
-  10, 11, 11, 11, 11, 11, 11, 12, 12, 12,
-  12, 13, 13, 14, 14, 14, 14, 15, 15, 15,
-  15, 15, 15, 16, 16, 16, 16, 16, 16, 17,
-  17, 18, 18, 18, 18, 18, 18, 19, 19, 19,
-  19, 20, 20, 21, 21, 21, 21, 21, 21, 22,
-  22, 22, 22, 23, 23, 23, 23, 23, 23, 24,
-  24, 24, 24, 24, 24, 24, 24, 25, 25, 25,
-  25, 26, 26, 27, 27, 27, 27, 28, 28, 29,
-  29, 29, 29, 30, 30, 30, 30, 30, 30, 30,
-  30, 30, 30, 30, 30, 30, 30, 31, 31, 31,
-  31, 32, 32, 32, 32, 32, 32, 33, 33, 34,
-  34, 34, 34, 34, 34, 34, 34, 34, 34, 35,
-  35, 36, 36, 36, 36, 36, 36, 37, 37, 37,
-  37, 37, 37, 38, 38, 38, 38, 39, 39, 39,
-  39, 39, 39, 40, 40, 40, 40, 40, 40, 41,
-  41, 42, 42, 42, 42, 42, 42, 42, 42, 42,
-  42, 43, 43, 44, 44, 44, 44, 45, 45, 46,
-  46, 46, 46, 46, 46, 46, 46, 46, 46, 46,
-  46, 47, 47, 47, 47, 47, 47, 47, 47, 47,
-  47, 47, 47, 48, 48, 48, 48, 49, 49, 50,
-  50, 50, 50, 51, 51, 51, 51, 51, 51, 52,
-  52, 53, 53, 53, 53, 53, 53, 53, 53, 53,
-  53, 54, 54, 54, 54, 54, 54, 55, 55, 55,
-  55, 55, 55, 56, 56, 56, 56, 56, 56, 57,
-  57, 58, 58, 58, 58, 58, 58, 59, 59, 59,
-  59, 60, 60, 61, 61, 61, 61, 61, 61, 61,
-  61, 61, 61, 62, 62, 62, 62, 62, 62, 62,
-  62, 62, 62, 62, 62, 62, 62, 63, 63, 63,
-  63, 64
-};
+  if (!isInit_)
+  {
+    bitmapStart_ = max(bitmapStart_, n);
+    return;
+  }
 
-PrimeGenerator::PrimeGenerator(uint64_t start, uint64_t stop) :
-  Erat(start, stop)
-{ }
+  // The last byte of a segment contains
+  // the number segmentLow_ + 1 of the next
+  // segment (30 * i + 31).
+  while (hasNextSegment() &&
+         n > segmentLow_)
+    sieveSegment();
+
+  if (sieveIdx_ < sieveSize_ &&
+      n > low_)
+  {
+    uint64_t words = (n - low_ - 1) / (8 * 30);
+    sieveIdx_ += words * 8;
+    low_ += words * 8 * 30;
+  }
+}
 
+/// The primes <= maxCachedPrime() are
+/// read from PrimeBitmap.
+///
 void PrimeGenerator::init(vector<uint64_t>& primes)
 {
   size_t size = primeCountApprox(start_, stop_);
   primes.reserve(size);
+  uint64_t stop = min(stop_, maxCachedPrime());
 
-  if (start_ <= maxCachedPrime())
+  if (bitmapStart_ <= stop)
   {
-    size_t a = getStartIdx();
-    size_t b = getStopIdx();
-
-    primes.insert(primes.end(),
-             smallPrimes.begin() + a,
-             smallPrimes.begin() + b);
+    uint64_t start = bitmapStart_;
+    size = primes.size();
+    size_t count = PrimeBitmap::primePi(stop);
+    if (start > 0)
+      count -= PrimeBitmap::primePi(start - 1);
+
+    primes.resize(size + count);
+    PrimeBitmap::getPrimes(&bitmapStart_, stop, &primes[size], count);
   }
 
   initErat();
 }
 
+/// The primes <= maxCachedPrime() are read from
+/// PrimeBitmap, at most primes.size() at once.
+///
 void PrimeGenerator::init(vector<uint64_t>& primes, size_t* size)
 {
-  if (start_ <= maxCachedPrime())
-  {
-    size_t a = getStartIdx();
-    size_t b = getStopIdx();
-
-    *size = b - a;
-    assert(*size <= primes.size());
+  uint64_t stop = min(stop_, maxCachedPrime());
 
-    copy(smallPrimes.begin() + a,
-         smallPrimes.begin() + b,
-         primes.begin());
+  if (bitmapStart_ <= stop)
+  {
+    *size = PrimeBitmap::getPrimes(&bitmapStart_, stop, &primes[0], primes.size());
+    if (*size > 0)
+      return;
   }
 
   initErat();
@@ -133,28 +137,6 @@ void PrimeGenerator::initErat()
   }
 }
 
-size_t PrimeGenerator::getStartIdx() const
-{
-  size_t startIdx = 0;
-
-  if (start_ > 1)
-    startIdx = primePi[start_ - 1];
-
-  return startIdx;
-}
-
-size_t PrimeGenerator::getStopIdx() const
-{
-  size_t stopIdx = 0;
-
-  if (stop_ < maxCachedPrime())
-    stopIdx = primePi[stop_];
-  else
-    stopIdx = smallPrimes.size();
-
-  return stopIdx;
-}
-
 bool PrimeGenerator::sieveSegment(vector<uint64_t>& primes)
 {
   if (!isInit_)
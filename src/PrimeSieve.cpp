@@ -10,11 +10,18 @@
 /// file in the top level directory.
 ///
 
+#include <primesieve.hpp>
 #include <primesieve/PrimeSieve.hpp>
+#include <primesieve/Erat.hpp>
+#include <primesieve/LinearSieve.hpp>
 #include <primesieve/ParallelSieve.hpp>
 #include <primesieve/pmath.hpp>
+#include <primesieve/PerfCounters.hpp>
 #include <primesieve/PrintPrimes.hpp>
 #include <primesieve/PreSieve.hpp>
+#include <primesieve/SieveStats.hpp>
+#include <primesieve/SmallSieve.hpp>
+#include <primesieve/primesieve_error.hpp>
 #include <primesieve/types.hpp>
 
 #include <stdint.h>
@@ -22,9 +29,11 @@
 #include <array>
 #include <chrono>
 #include <iostream>
+#include <limits>
 #include <string>
 
 using namespace std;
+using namespace primesieve;
 
 namespace {
 
@@ -48,6 +57,58 @@ const array<SmallPrime, 8> smallPrimes
   { 5, 17, 4, "(5, 7, 11, 13, 17)" }
 }};
 
+/// Returns a * p + b, saturated to [0, 2^64 - 1].
+/// LinearSieve reports a * p + b >= 2^64 as an error.
+///
+uint64_t linearForm(uint64_t a, int64_t b, uint64_t p)
+{
+  uint64_t maxStop = numeric_limits<uint64_t>::max();
+  if (p > maxStop / a)
+    return maxStop;
+
+  uint64_t ap = a * p;
+
+  if (b >= 0)
+    return (ap > maxStop - (uint64_t) b) ? maxStop : ap + (uint64_t) b;
+
+  uint64_t absB = ~((uint64_t) b) + 1;
+  return (ap > absB) ? ap - absB : 0;
+}
+
+/// Estimated memory usage of a thread sieving [start, stop],
+/// PrintPrimes also sieves its sieving primes <= sqrt(stop)
+/// using a second sieve array. If a > 0 LinearSieve also
+/// sieves [a * start + b, a * stop + b] using its lookup
+/// sieve (PrimeLookup).
+///
+uint64_t threadMemory(uint64_t start,
+                      uint64_t stop,
+                      int sieveSize,
+                      uint64_t a,
+                      int64_t b)
+{
+  uint64_t sievingPrimes = (uint64_t) sieveSize << 10;
+  uint64_t bytes = Erat::estimateMemoryUsage(start, stop, sieveSize) +
+                   sievingPrimes;
+
+  if (a)
+  {
+    uint64_t lookupStart = linearForm(a, b, max<uint64_t>(start, 2));
+    uint64_t lookupStop = linearForm(a, b, stop);
+    lookupStart = max<uint64_t>(lookupStart, 7);
+
+    if (lookupStart <= lookupStop)
+      bytes += Erat::estimateMemoryUsage(lookupStart, lookupStop, sieveSize);
+  }
+
+  return bytes;
+}
+
+string toMiB(uint64_t bytes)
+{
+  return to_string(ceilDiv(bytes, 1 << 20)) + " MiB";
+}
+
 } // namespace
 
 namespace primesieve {
@@ -60,6 +121,9 @@ PrimeSieve::PrimeSieve()
 
 /// Used for multi-threading
 PrimeSieve::PrimeSieve(ParallelSieve* parent) :
+  tableStep_(parent->tableStep_),
+  linearA_(parent->linearA_),
+  linearB_(parent->linearB_),
   flags_(parent->flags_),
   sieveSize_(parent->sieveSize_),
   parent_(parent)
@@ -70,6 +134,8 @@ PrimeSieve::~PrimeSieve() = default;
 void PrimeSieve::reset()
 {
   counts_.fill(0);
+  table_.clear();
+  stats_.reset();
   percent_ = -1.0;
   seconds_ = 0.0;
   sievedDistance_ = 0;
@@ -116,6 +182,11 @@ bool PrimeSieve::isStatus() const
   return isFlag(PRINT_STATUS, UPDATE_GUI_STATUS);
 }
 
+bool PrimeSieve::isLinearForm() const
+{
+  return linearA_ != 0;
+}
+
 bool PrimeSieve::isCount(int i) const
 {
   return isFlag(COUNT_PRIMES << i);
@@ -164,11 +235,69 @@ double PrimeSieve::getSeconds() const
   return seconds_;
 }
 
+SieveStats& PrimeSieve::getStats()
+{
+  return stats_;
+}
+
+/// Count cycles, instructions, cache misses, ... of each
+/// thread using the Linux perf_event_open() system call.
+///
+void PrimeSieve::setPerfCounters(bool enable)
+{
+  isPerf_ = enable;
+  perfValues_.clear();
+}
+
+const std::vector<PerfCounters::Values>& PrimeSieve::getPerfValues() const
+{
+  return perfValues_;
+}
+
 PreSieve& PrimeSieve::getPreSieve()
 {
   return preSieve_;
 }
 
+uint64_t PrimeSieve::getTableStep() const
+{
+  return tableStep_;
+}
+
+/// Checkpoints are the multiples of tableStep_ inside
+/// [start_, stop_]. Finds the first checkpoint >= n.
+/// @return false if there is no such checkpoint.
+///
+bool PrimeSieve::getNextCheckpoint(uint64_t* n) const
+{
+  if (!tableStep_)
+    return false;
+
+  uint64_t x = max(*n, tableStep_);
+  uint64_t last = stop_ - stop_ % tableStep_;
+
+  if (x > last)
+    return false;
+
+  *n = last - (last - x) / tableStep_ * tableStep_;
+  return true;
+}
+
+std::vector<counts_t>& PrimeSieve::getTable()
+{
+  return table_;
+}
+
+uint64_t PrimeSieve::getLinearA() const
+{
+  return linearA_;
+}
+
+int64_t PrimeSieve::getLinearB() const
+{
+  return linearB_;
+}
+
 void PrimeSieve::setFlags(int flags)
 {
   flags_ = flags;
@@ -179,6 +308,24 @@ void PrimeSieve::addFlags(int flags)
   flags_ |= flags;
 }
 
+/// Record the counts inside [start, x] for
+/// each multiple x of step, 0 = disabled.
+///
+void PrimeSieve::setTableStep(uint64_t step)
+{
+  tableStep_ = step;
+}
+
+/// Instead of the primes, count (and print) the primes p
+/// for which a * p + b is also prime, e.g. a = 2, b = 1
+/// for the Sophie Germain primes. a = 0 = disabled.
+///
+void PrimeSieve::setLinearForm(uint64_t a, int64_t b)
+{
+  linearA_ = a;
+  linearB_ = b;
+}
+
 void PrimeSieve::setStart(uint64_t start)
 {
   start_ = start;
@@ -258,6 +405,31 @@ void PrimeSieve::processSmallPrimes()
   }
 }
 
+/// The table counts include the small primes and k-tuplets
+/// <= stop_ from processSmallPrimes(), hence we remove
+/// the ones that are larger than the checkpoint.
+///
+void PrimeSieve::correctTable()
+{
+  uint64_t x = start_;
+
+  for (auto& counts : table_)
+  {
+    if (!getNextCheckpoint(&x) ||
+        x >= smallPrimes.back().last)
+      break;
+
+    for (auto& p : smallPrimes)
+      if (p.first >= start_ &&
+          p.last <= stop_ &&
+          p.last > x &&
+          isCount(p.index))
+        counts[p.index]--;
+
+    x++;
+  }
+}
+
 uint64_t PrimeSieve::countPrimes(uint64_t start, uint64_t stop)
 {
   sieve(start, stop, COUNT_PRIMES);
@@ -289,22 +461,132 @@ void PrimeSieve::sieve()
   if (start_ > stop_)
     return;
 
+  // Threads of ParallelSieve have
+  // already been checked by their parent
+  if (!parent_)
+    fitMaxMemory(1);
+
+  // Threads of ParallelSieve are
+  // counted by their parent
+  PerfCounters perf;
+  bool isPerf = isPerf_ && !parent_;
+  if (isPerf)
+    perf.start();
+
   setStatus(0);
   auto t1 = chrono::system_clock::now();
+  uint64_t ticks1 = SieveStats::now();
 
-  if (start_ <= 5)
-    processSmallPrimes();
-
-  if (stop_ >= 7)
+  if (isLinearForm())
   {
-    PrintPrimes printPrimes(*this);
-    printPrimes.sieve();
+    LinearSieve linearSieve(*this);
+    linearSieve.sieve();
   }
+  else
+    sievePrimes();
 
+  uint64_t ticks2 = SieveStats::now();
   auto t2 = chrono::system_clock::now();
   chrono::duration<double> seconds = t2 - t1;
   seconds_ = seconds.count();
+
+  if (isPerf)
+  {
+    perf.stop();
+    perfValues_.resize(max<size_t>(perfValues_.size(), 1));
+    perfValues_[0] += perf.getValues();
+  }
+
+  if (SieveStats::isEnabled())
+  {
+    stats_.calibrate(ticks2 - ticks1, seconds_);
+    // Threads of ParallelSieve are added
+    // to the global stats by their parent
+    if (!parent_)
+      SieveStats::addGlobal(stats_);
+  }
+
   setStatus(100);
 }
 
+/// Reduce the number of threads and if needed change the
+/// sieve size so that sieving [start_, stop_] uses at most
+/// get_max_memory() bytes, see set_max_memory().
+/// @return Number of threads <= threads
+///
+int PrimeSieve::fitMaxMemory(int threads)
+{
+  uint64_t maxMemory = get_max_memory();
+
+  if (!maxMemory ||
+      start_ > stop_)
+    return threads;
+
+  uint64_t memory = threadMemory(start_, stop_, sieveSize_, linearA_, linearB_);
+  uint64_t maxThreads = maxMemory / memory;
+
+  if (maxThreads >= 1)
+    return (int) min<uint64_t>(threads, maxThreads);
+
+  // Even 1 thread does not fit, a larger sieve size
+  // uses fewer EratBig bucket lists, a smaller sieve
+  // size uses a smaller sieve array.
+  int bestSize = sieveSize_;
+
+  for (int size = 8; size <= 4096; size *= 2)
+  {
+    uint64_t bytes = threadMemory(start_, stop_, size, linearA_, linearB_);
+    if (bytes < memory)
+    {
+      memory = bytes;
+      bestSize = size;
+    }
+  }
+
+  if (memory > maxMemory)
+    throw primesieve_error("sieving up to " + to_string(stop_) +
+                           " requires at least " + toMiB(memory) +
+                           " of memory, max memory is " + toMiB(maxMemory));
+
+  setSieveSize(bestSize);
+  return 1;
+}
+
+/// Small intervals are counted without heap allocations
+bool PrimeSieve::isSmallSieve() const
+{
+  return !isPrint() &&
+         !isStatus() &&
+         !tableStep_ &&
+         SmallSieve::isSmall(start_, stop_);
+}
+
+void PrimeSieve::sievePrimes()
+{
+  if (start_ <= 5)
+    processSmallPrimes();
+
+  // checkpoints < 7 are not sieved
+  uint64_t x = start_;
+  for (; getNextCheckpoint(&x) && x < 7; x++)
+    table_.push_back(counts_);
+
+  if (stop_ >= 7)
+  {
+    if (isSmallSieve())
+    {
+      SmallSieve smallSieve(start_, stop_);
+      smallSieve.count(*this);
+    }
+    else
+    {
+      PrintPrimes printPrimes(*this);
+      printPrimes.sieve();
+    }
+  }
+
+  if (!table_.empty())
+    correctTable();
+}
+
 } // namespace
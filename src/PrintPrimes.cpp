@@ -17,6 +17,8 @@
 #include <primesieve/PrimeSieve.hpp>
 #include <primesieve/Erat.hpp>
 #include <primesieve/SievingPrimes.hpp>
+#include <primesieve/SieveStats.hpp>
+#include <primesieve/Trace.hpp>
 #include <primesieve/types.hpp>
 
 #include <stdint.h>
@@ -49,16 +51,22 @@ PrintPrimes::PrintPrimes(PrimeSieve& ps) :
 
   Erat::init(start, stop, sieveSize, ps.getPreSieve());
 
-  if (ps_.isCountkTuplets())
+  if (SieveStats::isEnabled())
+    stats_ = &ps.getStats();
+
+  checkpoint_ = start;
+  isCheckpoint_ = ps_.getNextCheckpoint(&checkpoint_);
+
+  if (ps_.isCountkTuplets() || isCheckpoint_)
     initCounts();
 }
 
 /// Initialize the lookup tables to count the number
-/// of twins, triplets, ... per byte
+/// of primes, twins, triplets, ... per byte
 ///
 void PrintPrimes::initCounts()
 {
-  for (uint_t i = 1; i < counts_.size(); i++)
+  for (uint_t i = 0; i < counts_.size(); i++)
   {
     if (!ps_.isCount(i))
       continue;
@@ -68,6 +76,11 @@ void PrintPrimes::initCounts()
     for (uint64_t j = 0; j < 256; j++)
     {
       byte_t count = 0;
+      if (i == 0)
+      {
+        for (uint64_t b = j; b != 0; b &= b - 1)
+          count++;
+      }
       for (const uint64_t* b = bitmasks_[i]; *b <= j; b++)
       {
         if ((j & *b) == *b)
@@ -85,11 +98,18 @@ void PrintPrimes::sieve()
 
   while (hasNextSegment())
   {
+    TraceScope segment(Trace::SEGMENT, segmentLow_, segmentHigh_);
     low_ = segmentLow_;
     uint64_t sqrtHigh = isqrt(segmentHigh_);
 
-    for (; prime <= sqrtHigh; prime = sievingPrimes.next())
-      addSievingPrime(prime);
+    // SievingPrimes is not timed itself, its
+    // sieving is part of the sieving primes phase
+    {
+      PhaseTimer timer(stats_, SieveStats::SIEVING_PRIMES);
+      TraceScope trace(Trace::SIEVING_PRIMES, sqrtHigh);
+      for (; prime <= sqrtHigh; prime = sievingPrimes.next())
+        addSievingPrime(prime);
+    }
 
     sieveSegment();
     print();
@@ -99,14 +119,25 @@ void PrintPrimes::sieve()
 /// Executed after each sieved segment
 void PrintPrimes::print()
 {
-  if (ps_.isCountPrimes())
-    countPrimes();
-  if (ps_.isCountkTuplets())
-    countkTuplets();
-  if (ps_.isPrintPrimes())
-    printPrimes();
-  if (ps_.isPrintkTuplets())
-    printkTuplets();
+  {
+    PhaseTimer timer(stats_, SieveStats::COUNT);
+    if (isCheckpoint_)
+      countCheckpoints();
+    if (ps_.isCountPrimes())
+      countPrimes();
+    if (ps_.isCountkTuplets())
+      countkTuplets();
+  }
+
+  if (ps_.isPrint())
+  {
+    PhaseTimer timer(stats_, SieveStats::PRINT);
+    if (ps_.isPrintPrimes())
+      printPrimes();
+    if (ps_.isPrintkTuplets())
+      printkTuplets();
+  }
+
   if (ps_.isStatus())
     ps_.updateStatus(sieveSize_ * 30);
 }
@@ -139,6 +170,65 @@ void PrintPrimes::countkTuplets()
   }
 }
 
+/// Count the primes and prime k-tuplets inside
+/// the sieve array interval [first, last[
+///
+void PrintPrimes::countBytes(const byte_t* first,
+                             const byte_t* last,
+                             counts_t& counts) const
+{
+  for (uint_t i = 0; i < counts.size(); i++)
+  {
+    if (!ps_.isCount(i))
+      continue;
+
+    uint64_t sum = 0;
+    for (const byte_t* b = first; b != last; b++)
+      sum += kCounts_[i][*b];
+
+    counts[i] += sum;
+  }
+}
+
+/// Store the counts inside [start, checkpoint] for
+/// each checkpoint inside the current segment.
+/// Must be called before the current segment
+/// has been added to counts_.
+///
+void PrintPrimes::countCheckpoints()
+{
+  auto& table = ps_.getTable();
+  uint64_t high = checkedAdd(low_, sieveSize_ * 30 + 6);
+  uint64_t i = 0;
+  counts_t counts = counts_;
+
+  if (!hasNextSegment())
+    high = stop_;
+
+  while (isCheckpoint_ && checkpoint_ <= high)
+  {
+    // the checkpoint is located in sieve_[j]
+    uint64_t rem = byteRemainder(checkpoint_);
+    uint64_t j = (checkpoint_ - rem - low_) / 30;
+    countBytes(&sieve_[i], &sieve_[j], counts);
+    i = j;
+
+    // count the bits <= checkpoint in sieve_[j]
+    byte_t bits = sieve_[j] & unsetLarger_[rem];
+    counts_t partial = counts;
+    countBytes(&bits, &bits + 1, partial);
+    table.push_back(partial);
+
+    if (checkpoint_ >= stop_)
+      isCheckpoint_ = false;
+    else
+    {
+      checkpoint_++;
+      isCheckpoint_ = ps_.getNextCheckpoint(&checkpoint_);
+    }
+  }
+}
+
 /// Print primes to stdout
 void PrintPrimes::printPrimes() const
 {
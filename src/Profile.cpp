@@ -0,0 +1,249 @@
+///
+/// @file   Profile.cpp
+/// @brief  Read and write the per-host tuning profile.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/Profile.hpp>
+#include <primesieve/config.hpp>
+#include <primesieve/CpuInfo.hpp>
+#include <primesieve/pmath.hpp>
+#include <primesieve/primesieve_error.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+  #include <direct.h>
+#else
+  #include <sys/stat.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+primesieve::Profile profile;
+
+once_flag loaded;
+
+void load()
+{
+  call_once(loaded, []()
+  {
+    string path = primesieve::Profile::getDefaultPath();
+    primesieve::Profile p;
+
+    // An invalid profile must not break sieving,
+    // the built-in defaults are used instead.
+    try
+    {
+      if (!path.empty() && p.read(path))
+        profile = p;
+    }
+    catch (exception& e)
+    {
+      cerr << "primesieve: warning: " << e.what()
+           << ", using the default settings" << endl;
+    }
+  });
+}
+
+string trim(const string& str)
+{
+  const char* space = " \t\r\n";
+  size_t first = str.find_first_not_of(space);
+  if (first == string::npos)
+    return string();
+  size_t last = str.find_last_not_of(space);
+  return str.substr(first, last - first + 1);
+}
+
+bool isSeparator(char c)
+{
+#if defined(_WIN32)
+  return c == '/' || c == '\\';
+#else
+  return c == '/';
+#endif
+}
+
+/// Create the parent directories of the file,
+/// errors are reported when writing the file.
+///
+void createDirectories(const string& filename)
+{
+  for (size_t i = 1; i < filename.size(); i++)
+  {
+    if (isSeparator(filename[i]))
+    {
+      string dir = filename.substr(0, i);
+#if defined(_WIN32)
+      _mkdir(dir.c_str());
+#else
+      mkdir(dir.c_str(), 0755);
+#endif
+    }
+  }
+}
+
+} // namespace
+
+namespace primesieve {
+
+void Profile::check()
+{
+  if (sieveSize)
+  {
+    sieveSize = inBetween(8, sieveSize, 4096);
+    sieveSize = floorPow2(sieveSize);
+  }
+
+  threads = max(threads, 0);
+  bucketBytes = inBetween(config::MIN_BUCKET_BYTES, bucketBytes, config::BUCKET_BYTES);
+  bucketBytes = floorPow2(bucketBytes);
+
+  // EratSmall requires maxPrime <= l1CacheSize * 3,
+  // EratMedium requires maxPrime <= sieveSize * 9.
+  factorEratSmall = inBetween(0.0, factorEratSmall, 3.0);
+  factorEratMedium = inBetween(factorEratSmall, factorEratMedium, 9.0);
+}
+
+bool Profile::read(const string& filename)
+{
+  ifstream file(filename);
+  if (!file)
+    return false;
+
+  Profile p;
+  string line;
+
+  while (getline(file, line))
+  {
+    line = line.substr(0, line.find('#'));
+    line = trim(line);
+    if (line.empty())
+      continue;
+
+    size_t pos = line.find('=');
+    if (pos == string::npos)
+      throw primesieve_error("invalid profile " + filename + ": " + line);
+
+    string key = trim(line.substr(0, pos));
+    string value = trim(line.substr(pos + 1));
+
+    try
+    {
+      size_t end = 0;
+
+      if (key == "sieve_size")
+        p.sieveSize = stoi(value, &end);
+      else if (key == "threads")
+        p.threads = stoi(value, &end);
+      else if (key == "bucket_bytes")
+        p.bucketBytes = stoi(value, &end);
+      else if (key == "factor_erat_small")
+        p.factorEratSmall = stod(value, &end);
+      else if (key == "factor_erat_medium")
+        p.factorEratMedium = stod(value, &end);
+      else
+        // Unknown settings of other
+        // primesieve versions
+        end = value.size();
+
+      if (end != value.size())
+        throw invalid_argument(value);
+    }
+    catch (exception&)
+    {
+      throw primesieve_error("invalid profile " + filename + ": " + line);
+    }
+  }
+
+  p.check();
+  *this = p;
+
+  return true;
+}
+
+void Profile::write(const string& filename) const
+{
+  createDirectories(filename);
+  ofstream file(filename);
+
+  if (!file)
+    throw primesieve_error("failed to create " + filename);
+
+  file << "# primesieve tuning profile, generated by primesieve --tune" << endl;
+  if (cpuInfo.hasCpuName())
+    file << "# CPU: " << cpuInfo.cpuName() << endl;
+  file << "sieve_size = " << sieveSize << endl;
+  file << "threads = " << threads << endl;
+  file << "bucket_bytes = " << bucketBytes << endl;
+  file << "factor_erat_small = " << factorEratSmall << endl;
+  file << "factor_erat_medium = " << factorEratMedium << endl;
+
+  if (!file)
+    throw primesieve_error("failed to write " + filename);
+}
+
+string Profile::getDefaultPath()
+{
+  const char* path = getenv("PRIMESIEVE_PROFILE");
+  if (path)
+    return path;
+
+#if defined(_WIN32)
+  const char* appData = getenv("APPDATA");
+  if (appData && *appData)
+    return string(appData) + "\\primesieve\\profile";
+#else
+  const char* config = getenv("XDG_CONFIG_HOME");
+  if (config && *config)
+    return string(config) + "/primesieve/profile";
+
+  const char* home = getenv("HOME");
+  if (home && *home)
+    return string(home) + "/.config/primesieve/profile";
+#endif
+
+  return string();
+}
+
+const Profile& Profile::get()
+{
+  load();
+  return profile;
+}
+
+void Profile::set(const Profile& p)
+{
+  // Prevent the default profile
+  // from being read later
+  call_once(loaded, []() { });
+  profile = p;
+  profile.check();
+}
+
+void Profile::use(const string& filename)
+{
+  Profile p;
+
+  if (!filename.empty() &&
+      !p.read(filename))
+    throw primesieve_error("failed to open " + filename);
+
+  set(p);
+}
+
+} // namespace
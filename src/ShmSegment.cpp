@@ -0,0 +1,333 @@
+///
+/// @file  ShmSegment.cpp
+///        Publish-once protocol of the shared memory segments:
+///        shm_open(O_CREAT | O_EXCL) succeeds in only one process,
+///        that process fills the segment and then publishes it
+///        by setting the state in the header to READY (release).
+///        All other processes map the segment read-only and
+///        wait until its state is READY (acquire). No locks are
+///        needed, if the creator dies before publishing the
+///        segment it is deleted and recreated by the next run.
+///        A segment whose creator died before setting its size
+///        or its pid is deleted after waiting 1 second.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/ShmSegment.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#if !defined(_WIN32) && \
+    ATOMIC_INT_LOCK_FREE == 2 && \
+    ATOMIC_LLONG_LOCK_FREE == 2
+  #include <errno.h>
+  #include <fcntl.h>
+  #include <signal.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+  #define HAVE_SHARED_MEMORY
+#endif
+
+using namespace std;
+using namespace primesieve;
+
+namespace {
+
+/// A new segment is zero initialized by ftruncate(),
+/// hence its state is FILLING. Lock-free atomics
+/// also work across processes.
+///
+struct Header
+{
+  char magic[8];
+  atomic<uint64_t> pid;
+  atomic<uint64_t> size;
+  atomic<uint32_t> state;
+};
+
+enum { HEADER_SIZE = 64 };
+
+static_assert(sizeof(Header) <= HEADER_SIZE, "Header too large");
+
+atomic<bool> enabled(false);
+
+#if defined(HAVE_SHARED_MEMORY)
+
+/// Segment names contain the version, segments of
+/// incompatible primesieve versions are never used.
+const string namePrefix = "/primesieve-v1-";
+
+const char magic[8] = { 'P', 'S', 'S', 'H', 'M', 0, 0, 1 };
+
+enum State : uint32_t
+{
+  FILLING = 0,
+  READY = 1,
+  FAILED = 2
+};
+
+mutex mappedMutex;
+
+/// Segments mapped by this process
+map<string, shared_ptr<const ShmSegment>> mapped;
+
+void sleepMs()
+{
+  this_thread::sleep_for(chrono::milliseconds(1));
+}
+
+bool isAlive(uint64_t pid)
+{
+  return kill((pid_t) pid, 0) == 0 ||
+         errno != ESRCH;
+}
+
+shared_ptr<const ShmSegment> createSegment(int fd,
+                                           const string& name,
+                                           size_t maxSize,
+                                           const ShmSegment::fill_t& fill)
+{
+  size_t mapSize = HEADER_SIZE + maxSize;
+  void* map = nullptr;
+
+  if (ftruncate(fd, (off_t) mapSize) == 0)
+  {
+    map = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+      map = nullptr;
+  }
+
+  close(fd);
+
+  if (!map)
+  {
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+
+  auto shm = make_shared<const ShmSegment>(map, mapSize);
+  Header* header = (Header*) map;
+  header->pid = (uint64_t) getpid();
+  size_t size = 0;
+
+  try
+  {
+    size = fill((uint8_t*) map + HEADER_SIZE, maxSize);
+  }
+  catch (...)
+  {
+    header->state = FAILED;
+    shm_unlink(name.c_str());
+    throw;
+  }
+
+  if (size > maxSize)
+  {
+    header->state = FAILED;
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+
+  copy_n(magic, 8, header->magic);
+  header->size = size;
+
+  // Publish the segment, the data must
+  // be written before the state.
+  header->state.store(READY, memory_order_release);
+  mprotect(map, mapSize, PROT_READ);
+
+  return shm;
+}
+
+shared_ptr<const ShmSegment> openSegment(const string& name,
+                                         size_t maxSize)
+{
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd == -1)
+    return nullptr;
+
+  struct stat st;
+  size_t mapSize = HEADER_SIZE + maxSize;
+
+  // The creator sets the size using ftruncate(), segments
+  // of other users are not trusted.
+  for (int i = 0; true; i++)
+  {
+    if (fstat(fd, &st) != 0 ||
+        st.st_uid != geteuid())
+    {
+      close(fd);
+      return nullptr;
+    }
+
+    if (st.st_size != 0)
+      break;
+
+    // The creator died before ftruncate(),
+    // delete the stale segment.
+    if (i >= 1000)
+    {
+      close(fd);
+      shm_unlink(name.c_str());
+      return nullptr;
+    }
+
+    sleepMs();
+  }
+
+  if ((size_t) st.st_size != mapSize)
+  {
+    close(fd);
+    return nullptr;
+  }
+
+  void* map = mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (map == MAP_FAILED)
+    return nullptr;
+
+  auto shm = make_shared<const ShmSegment>(map, mapSize);
+  const Header* header = (const Header*) map;
+
+  for (int i = 0; true; i++)
+  {
+    uint32_t state = header->state.load(memory_order_acquire);
+    uint64_t pid = header->pid;
+
+    if (state == READY)
+    {
+      bool valid = equal(magic, magic + 8, header->magic) &&
+                   header->size <= maxSize;
+      return (valid) ? shm : nullptr;
+    }
+
+    if (state == FAILED)
+      return nullptr;
+
+    // The creator died before publishing the segment
+    // (or before writing its pid), delete the segment.
+    if ((pid == 0 && i >= 1000) ||
+        (pid != 0 && !isAlive(pid)))
+    {
+      shm_unlink(name.c_str());
+      return nullptr;
+    }
+
+    sleepMs();
+  }
+}
+
+#endif
+
+} // namespace
+
+namespace primesieve {
+
+shared_ptr<const ShmSegment> ShmSegment::get(const string& name,
+                                             size_t maxSize,
+                                             const fill_t& fill)
+{
+#if defined(HAVE_SHARED_MEMORY)
+  if (!isEnabled())
+    return nullptr;
+
+  string shmName = namePrefix + name;
+
+  {
+    lock_guard<mutex> lock(mappedMutex);
+    auto iter = mapped.find(shmName);
+    if (iter != mapped.end())
+      return iter->second;
+  }
+
+  // The segment is created without holding the lock as
+  // fill() may itself use shared memory. If multiple
+  // threads create the same segment concurrently only
+  // one thread fills it, same as for processes.
+  shared_ptr<const ShmSegment> shm;
+  int fd = shm_open(shmName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+
+  if (fd != -1)
+    shm = createSegment(fd, shmName, maxSize, fill);
+  else if (errno == EEXIST)
+    shm = openSegment(shmName, maxSize);
+
+  if (!shm)
+    return nullptr;
+
+  lock_guard<mutex> lock(mappedMutex);
+  auto& mappedShm = mapped[shmName];
+  if (!mappedShm)
+    mappedShm = shm;
+
+  return mappedShm;
+#else
+  (void) name;
+  (void) maxSize;
+  (void) fill;
+  return nullptr;
+#endif
+}
+
+void ShmSegment::remove(const string& name)
+{
+#if defined(HAVE_SHARED_MEMORY)
+  string shmName = namePrefix + name;
+  shm_unlink(shmName.c_str());
+
+  lock_guard<mutex> lock(mappedMutex);
+  mapped.erase(shmName);
+#else
+  (void) name;
+#endif
+}
+
+void ShmSegment::enable(bool isEnabled)
+{
+  enabled = isEnabled;
+}
+
+bool ShmSegment::isEnabled()
+{
+  return enabled;
+}
+
+ShmSegment::ShmSegment(void* map, size_t mapSize) :
+  map_(map),
+  mapSize_(mapSize)
+{ }
+
+ShmSegment::~ShmSegment()
+{
+#if defined(HAVE_SHARED_MEMORY)
+  munmap(map_, mapSize_);
+#endif
+}
+
+const uint8_t* ShmSegment::getData() const
+{
+  return (const uint8_t*) map_ + HEADER_SIZE;
+}
+
+size_t ShmSegment::getSize() const
+{
+  const Header* header = (const Header*) map_;
+  return (size_t) header->size;
+}
+
+} // namespace
@@ -0,0 +1,100 @@
+///
+/// @file   SieveStats.cpp
+/// @brief  Per-phase timing statistics. Each PrimeSieve object
+///         (i.e. each thread) collects its own statistics which
+///         are then added to the statistics of its parent
+///         ParallelSieve object and to the global statistics
+///         of the current process.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/SieveStats.hpp>
+
+#include <stdint.h>
+#include <mutex>
+
+using namespace std;
+
+namespace {
+
+/// Statistics of all sieving runs
+primesieve::SieveStats globalStats;
+mutex globalMutex;
+
+const char* phaseNames[] =
+{
+  "Pre-sieve",
+  "EratSmall",
+  "EratMedium",
+  "EratBig",
+  "Sieving primes",
+  "Count",
+  "Print"
+};
+
+} // namespace
+
+namespace primesieve {
+
+void SieveStats::reset()
+{
+  ticks.fill(0);
+  seconds.fill(0);
+  segments = 0;
+}
+
+/// Convert the ticks of each phase to seconds,
+/// ticks = elapsed ticks of the whole run,
+/// seconds = elapsed seconds of the whole run.
+///
+void SieveStats::calibrate(uint64_t totalTicks, double totalSeconds)
+{
+  if (totalTicks == 0)
+    return;
+
+  double secondsPerTick = totalSeconds / totalTicks;
+
+  for (int i = 0; i < PHASES; i++)
+    seconds[i] = ticks[i] * secondsPerTick;
+}
+
+SieveStats& SieveStats::operator+=(const SieveStats& other)
+{
+  for (int i = 0; i < PHASES; i++)
+  {
+    ticks[i] += other.ticks[i];
+    seconds[i] += other.seconds[i];
+  }
+
+  segments += other.segments;
+  return *this;
+}
+
+const char* SieveStats::getName(int phase)
+{
+  return phaseNames[phase];
+}
+
+SieveStats SieveStats::getGlobal()
+{
+  lock_guard<mutex> lock(globalMutex);
+  return globalStats;
+}
+
+void SieveStats::addGlobal(const SieveStats& stats)
+{
+  lock_guard<mutex> lock(globalMutex);
+  globalStats += stats;
+}
+
+void SieveStats::resetGlobal()
+{
+  lock_guard<mutex> lock(globalMutex);
+  globalStats.reset();
+}
+
+} // namespace
@@ -1,6 +1,10 @@
 ///
 /// @file  SievingPrimes.cpp
-///        Generates the sieving primes up n^(1/2).
+///        Generates the sieving primes up n^(1/2). If the
+///        sieving primes cache file or shared memory is used
+///        the sieving primes are read from it instead. The
+///        sieving primes of the sieving primes (up to n^(1/4))
+///        are read from PrimeBitmap.
 ///
 /// Copyright (C) 2018 Kim Walisch, <kim.walisch@gmail.com>
 ///
@@ -9,13 +13,16 @@
 ///
 
 #include <primesieve/SievingPrimes.hpp>
+#include <primesieve/config.hpp>
 #include <primesieve/Erat.hpp>
+#include <primesieve/decodePrimes.hpp>
 #include <primesieve/PreSieve.hpp>
-#include <primesieve/littleendian_cast.hpp>
+#include <primesieve/PrimeBitmap.hpp>
 #include <primesieve/pmath.hpp>
+#include <primesieve/SievingPrimesCache.hpp>
 
 #include <stdint.h>
-#include <vector>
+#include <algorithm>
 
 namespace primesieve {
 
@@ -26,45 +33,89 @@ SievingPrimes::SievingPrimes(Erat* erat, PreSieve& preSieve)
 
 void SievingPrimes::init(Erat* erat, PreSieve& preSieve)
 {
-  Erat::init(preSieve.getMaxPrime() + 1,
-             isqrt(erat->getStop()),
-             erat->getSieveSize(),
-             preSieve);
+  uint64_t start = preSieve.getMaxPrime() + 1;
+  uint64_t stop = isqrt(erat->getStop());
 
-  tinySieve();
-}
+  // reset the state if SievingPrimes is reinitialized
+  i_ = 0;
+  size_ = 0;
+  cache_.reset();
 
-/// Sieve up to n^(1/4)
-void SievingPrimes::tinySieve()
-{
-  uint64_t n = isqrt(stop_);
-  tinySieve_.resize(n + 1, true);
+  if (stop >= config::MIN_SIEVING_PRIMES_CACHE)
+  {
+    cache_ = SievingPrimesCache::get(stop);
 
-  for (uint64_t i = 3; i * i <= n; i += 2)
-    if (tinySieve_[i])
-      for (uint64_t j = i * i; j <= n; j += i * 2)
-        tinySieve_[j] = false;
+    if (cache_)
+    {
+      initCache(start, stop);
+      return;
+    }
+  }
 
+  Erat::init(start, stop, erat->getSieveSize(), preSieve);
+  low_ = segmentLow_;
+  sieveIdx_ = ~0ull;
   tinyIdx_ = start_;
   tinyIdx_ += ~tinyIdx_ & 1;
 }
 
+void SievingPrimes::initCache(uint64_t start, uint64_t stop)
+{
+  start_ = start;
+  stop_ = stop;
+  gaps_ = cache_->getGaps();
+  gapsSize_ = cache_->getSize();
+  gapsIdx_ = 0;
+  gapsPrime_ = 1;
+
+  // skip the pre-sieved primes
+  while (gapsIdx_ < gapsSize_ &&
+         gapsPrime_ + gaps_[gapsIdx_] * 2 < start)
+    gapsPrime_ += gaps_[gapsIdx_++] * 2;
+}
+
 void SievingPrimes::fill()
 {
+  if (cache_)
+  {
+    fillCache();
+    return;
+  }
+
   if (sieveIdx_ >= sieveSize_)
     if (!sieveSegment())
       return;
 
-  uint64_t num = 0;
-  uint64_t bits = littleendian_cast<uint64_t>(&sieve_[sieveIdx_]);
-  sieveIdx_ += 8;
+  // decode the next 64-bit word that contains primes
+  i_ = 0;
+  size_ = decodePrimes(sieve_, &sieveIdx_, sieveSize_, &low_, primes_, 0);
+}
+
+/// Decode the next 64 sieving primes from the cache file
+void SievingPrimes::fillCache()
+{
+  uint64_t n = std::min<uint64_t>(gapsSize_ - gapsIdx_, 64);
+  const uint8_t* gaps = &gaps_[gapsIdx_];
+  uint64_t prime = gapsPrime_;
 
-  for (; bits != 0; num++)
-    primes_[num] = nextPrime(&bits, low_);
+  for (uint64_t j = 0; j < n; j++)
+  {
+    prime += gaps[j] * 2;
+    primes_[j] = prime;
+  }
 
   i_ = 0;
-  size_ = num;
-  low_ += 8 * 30;
+  size_ = n;
+  gapsIdx_ += n;
+  gapsPrime_ = prime;
+
+  // no more sieving primes <= stop
+  if (n < 64 || prime > stop_)
+  {
+    size_ = std::upper_bound(primes_, primes_ + n, stop_) - primes_;
+    primes_[size_++] = ~0ull;
+    gapsIdx_ = gapsSize_;
+  }
 }
 
 bool SievingPrimes::sieveSegment()
@@ -74,8 +125,9 @@ bool SievingPrimes::sieveSegment()
     sieveIdx_ = 0;
     uint64_t high = segmentHigh_;
 
+    // stop_ <= 2^32, hence i < PrimeBitmap::MAX
     for (uint64_t& i = tinyIdx_; i * i <= high; i += 2)
-      if (tinySieve_[i])
+      if (PrimeBitmap::isPrime(i))
         addSievingPrime(i);
 
     Erat::sieveSegment();
@@ -0,0 +1,324 @@
+///
+/// @file  SievingPrimesCache.cpp
+///        Cache file of the sieving primes, the file format is:
+///
+///        bytes [0, 8[    magic number "PSCACHE" and version
+///        bytes [8, 16[   number of primes (little endian)
+///        bytes [16, 24[  max prime (little endian), the file
+///                        contains all primes <= max prime.
+///        bytes [24, ...[ (prime - previous prime) / 2 of each
+///                        odd prime, 1 byte per prime.
+///
+///        The largest prime gap below 2^32 is 336, hence half
+///        the gap fits into a byte.
+///
+///        If shared memory is enabled and no (large enough) cache
+///        file is used, the same format is stored in a shared
+///        memory segment. There is one segment for each power
+///        of 2 maxPrime >= 2^20.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/SievingPrimesCache.hpp>
+#include <primesieve/config.hpp>
+#include <primesieve/iterator.hpp>
+#include <primesieve/pmath.hpp>
+#include <primesieve/primesieve_error.hpp>
+#include <primesieve/ShmSegment.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+using namespace std;
+using namespace primesieve;
+
+namespace {
+
+enum { HEADER_SIZE = 24 };
+
+const uint8_t cacheMagic[8] = { 'P', 'S', 'C', 'A', 'C', 'H', 'E', 1 };
+
+/// Half gaps of the primes 3, 5, 7, 11, 13
+const uint8_t firstGaps[5] = { 1, 1, 1, 2, 1 };
+
+mutex cacheMutex;
+
+shared_ptr<const SievingPrimesCache> cache;
+
+void putUint64(uint8_t* bytes, uint64_t n)
+{
+  for (int i = 0; i < 8; i++)
+    bytes[i] = (uint8_t) (n >> (i * 8));
+}
+
+uint64_t getUint64(const uint8_t* bytes)
+{
+  uint64_t n = 0;
+  for (int i = 0; i < 8; i++)
+    n |= (uint64_t) bytes[i] << (i * 8);
+  return n;
+}
+
+void writeBytes(ofstream& file, const uint8_t* bytes, size_t size)
+{
+  file.write((const char*) bytes, size);
+}
+
+void writeHeader(uint8_t* header, uint64_t size, uint64_t maxPrime)
+{
+  copy_n(cacheMagic, 8, header);
+  putUint64(&header[8], size);
+  putUint64(&header[16], maxPrime);
+}
+
+/// Encode the odd primes <= maxPrime, write(bytes, size)
+/// is called for each block of 1 MiB.
+/// @return  Number of primes.
+///
+template <typename F>
+uint64_t writeGaps(uint64_t maxPrime, F write)
+{
+  vector<uint8_t> buffer;
+  buffer.reserve(1 << 20);
+  primesieve::iterator it(2, maxPrime);
+  uint64_t last = 1;
+  uint64_t size = 0;
+
+  for (uint64_t prime = it.next_prime(); prime <= maxPrime; prime = it.next_prime())
+  {
+    buffer.push_back((uint8_t) ((prime - last) / 2));
+    last = prime;
+
+    if (buffer.size() == buffer.capacity())
+    {
+      write(buffer.data(), buffer.size());
+      size += buffer.size();
+      buffer.clear();
+    }
+  }
+
+  write(buffer.data(), buffer.size());
+  size += buffer.size();
+
+  return size;
+}
+
+/// Upper bound of the number of primes <= x,
+/// Dusart 2010, valid for x >= 60184.
+///
+uint64_t primeCountUpper(uint64_t x)
+{
+  return (uint64_t) (x / (log((double) x) - 1.1)) + 1;
+}
+
+/// Shared memory cache of the primes <= 2^n
+shared_ptr<const SievingPrimesCache> getShared(uint64_t maxPrime)
+{
+  if (!ShmSegment::isEnabled())
+    return nullptr;
+
+  int n = ilog2(maxPrime - 1) + 1;
+  n = max(n, ilog2((int) config::MIN_SIEVING_PRIMES_CACHE));
+  if (n > 32)
+    return nullptr;
+
+  uint64_t limit = 1ull << n;
+  string name = "sieving-primes-" + to_string(n);
+  size_t maxSize = (size_t) (HEADER_SIZE + primeCountUpper(limit));
+
+  auto fill = [limit](uint8_t* data, size_t maxSize)
+  {
+    size_t size = HEADER_SIZE;
+    uint64_t count = writeGaps(limit, [&](const uint8_t* bytes, size_t bytesSize)
+    {
+      if (size + bytesSize > maxSize)
+        throw primesieve_error("sieving primes cache: shared memory too small");
+      copy_n(bytes, bytesSize, &data[size]);
+      size += bytesSize;
+    });
+
+    writeHeader(data, count, limit);
+    return size;
+  };
+
+  auto shm = ShmSegment::get(name, maxSize, fill);
+
+  if (!shm)
+    return nullptr;
+
+  try
+  {
+    return make_shared<SievingPrimesCache>(shm);
+  }
+  catch (primesieve_error&)
+  {
+    return nullptr;
+  }
+}
+
+} // namespace
+
+namespace primesieve {
+
+void SievingPrimesCache::build(const string& filename, uint64_t maxPrime)
+{
+  if (maxPrime > (1ull << 32))
+    throw primesieve_error("sieving primes cache: max prime > 2^32");
+
+  // Write into a temporary file first so that
+  // other processes never see a partial file
+  string tmpFile = filename + ".tmp";
+  ofstream file(tmpFile, ios::binary | ios::trunc);
+
+  if (!file)
+    throw primesieve_error("failed to create " + tmpFile);
+
+  uint8_t header[HEADER_SIZE] = { 0 };
+  writeBytes(file, header, HEADER_SIZE);
+
+  uint64_t size = writeGaps(maxPrime, [&](const uint8_t* bytes, size_t n)
+  {
+    writeBytes(file, bytes, n);
+  });
+
+  writeHeader(header, size, maxPrime);
+  file.seekp(0);
+  writeBytes(file, header, HEADER_SIZE);
+  file.close();
+
+  if (!file)
+    throw primesieve_error("failed to write " + tmpFile);
+
+  // On Windows rename() fails if the file exists
+  remove(filename.c_str());
+
+  if (rename(tmpFile.c_str(), filename.c_str()) != 0)
+    throw primesieve_error("failed to rename " + tmpFile);
+}
+
+void SievingPrimesCache::use(const string& filename)
+{
+  shared_ptr<const SievingPrimesCache> newCache;
+
+  if (!filename.empty())
+    newCache = make_shared<SievingPrimesCache>(filename);
+
+  // Sieving that is in progress keeps its
+  // reference to the old cache.
+  lock_guard<mutex> lock(cacheMutex);
+  cache = newCache;
+}
+
+shared_ptr<const SievingPrimesCache> SievingPrimesCache::get(uint64_t maxPrime)
+{
+  {
+    lock_guard<mutex> lock(cacheMutex);
+    if (cache &&
+        cache->getMaxPrime() >= maxPrime)
+      return cache;
+  }
+
+  return getShared(maxPrime);
+}
+
+void SievingPrimesCache::removeShared()
+{
+  for (int n = 0; n <= 32; n++)
+    ShmSegment::remove("sieving-primes-" + to_string(n));
+}
+
+SievingPrimesCache::SievingPrimesCache(const string& filename)
+{
+#if !defined(_WIN32)
+  int fd = open(filename.c_str(), O_RDONLY);
+  struct stat st;
+
+  if (fd == -1)
+    throw primesieve_error("failed to open " + filename);
+
+  if (fstat(fd, &st) == 0 &&
+      st.st_size >= HEADER_SIZE)
+  {
+    mapSize_ = (size_t) st.st_size;
+    map_ = mmap(nullptr, mapSize_, PROT_READ, MAP_SHARED, fd, 0);
+    if (map_ == MAP_FAILED)
+      map_ = nullptr;
+  }
+
+  close(fd);
+
+  if (!map_)
+    throw primesieve_error("failed to map " + filename);
+
+  if (!init((const uint8_t*) map_, mapSize_))
+  {
+    // the destructor is not called
+    munmap(map_, mapSize_);
+    throw primesieve_error("invalid sieving primes cache " + filename);
+  }
+#else
+  ifstream file(filename, ios::binary);
+
+  if (!file)
+    throw primesieve_error("failed to open " + filename);
+
+  buffer_.assign(istreambuf_iterator<char>(file),
+                 istreambuf_iterator<char>());
+
+  if (!init(buffer_.data(), buffer_.size()))
+    throw primesieve_error("invalid sieving primes cache " + filename);
+#endif
+}
+
+SievingPrimesCache::SievingPrimesCache(shared_ptr<const ShmSegment> shm) :
+  shm_(shm)
+{
+  if (!init(shm_->getData(), shm_->getSize()))
+    throw primesieve_error("invalid sieving primes cache in shared memory");
+}
+
+bool SievingPrimesCache::init(const uint8_t* bytes, uint64_t bytesSize)
+{
+  if (bytesSize < HEADER_SIZE ||
+      !equal(cacheMagic, cacheMagic + 8, bytes))
+    return false;
+
+  size_ = getUint64(&bytes[8]);
+  maxPrime_ = getUint64(&bytes[16]);
+  gaps_ = &bytes[HEADER_SIZE];
+  size_t n = (size_t) min<uint64_t>(size_, 5);
+
+  return size_ == bytesSize - HEADER_SIZE &&
+         maxPrime_ <= (1ull << 32) &&
+         equal(firstGaps, firstGaps + n, gaps_);
+}
+
+SievingPrimesCache::~SievingPrimesCache()
+{
+#if !defined(_WIN32)
+  if (map_)
+    munmap(map_, mapSize_);
+#endif
+}
+
+} // namespace
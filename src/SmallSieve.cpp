@@ -0,0 +1,259 @@
+///
+/// @file   SmallSieve.cpp
+/// @brief  Counting the primes inside a small interval using
+///         Erat requires many memory allocations (sieve array,
+///         PreSieve buffer, sieving primes, buckets) whose cost
+///         dominates for intervals of size ~ 10^5. SmallSieve
+///         instead crosses off the multiples of the sieving
+///         primes (from PrimeBitmap) directly in a sieve array
+///         on the stack. Intervals below 2^20 are not sieved at
+///         all, their primes are read from PrimeBitmap.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/SmallSieve.hpp>
+#include <primesieve/config.hpp>
+#include <primesieve/PrimeSieve.hpp>
+#include <primesieve/PrimeBitmap.hpp>
+#include <primesieve/PrintPrimes.hpp>
+#include <primesieve/pmath.hpp>
+#include <primesieve/types.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+using namespace std;
+using namespace primesieve;
+
+namespace {
+
+/// Bit of n % 30 inside a byte of the sieve array
+const array<int, 30> bitIndex =
+{
+  -1, 7, -1, -1, -1, -1, -1, 0, -1, -1,
+  -1, 1, -1, 2, -1, -1, -1, 3, -1, 4,
+  -1, -1, -1, 5, -1, -1, -1, -1, -1, 6
+};
+
+/// Residues modulo 30 that are coprime to 30
+const array<uint32_t, 8> wheel = { 1, 7, 11, 13, 17, 19, 23, 29 };
+
+/// Index of the first wheel residue >= n % 30
+const array<uint32_t, 30> wheelIndex =
+{
+  0, 0, 1, 1, 1, 1, 1, 1, 2, 2,
+  2, 2, 3, 3, 4, 4, 4, 4, 5, 5,
+  6, 6, 6, 6, 7, 7, 7, 7, 7, 7
+};
+
+/// Offsets of the 8 bits of a byte of the sieve array
+const array<uint64_t, 8> bitValues = { 7, 11, 13, 17, 19, 23, 29, 31 };
+
+/// 7 * 11 * 13 * 30 / 30
+const size_t PRESIEVE_BYTES = 1001;
+
+/// Sieve array pattern with the multiples of 7, 11 and 13
+/// removed, it repeats every 7 * 11 * 13 * 30 numbers.
+///
+const array<byte_t, PRESIEVE_BYTES>& getPreSieved()
+{
+  static const array<byte_t, PRESIEVE_BYTES> preSieved = []()
+  {
+    array<byte_t, PRESIEVE_BYTES> preSieved;
+    for (size_t i = 0; i < PRESIEVE_BYTES; i++)
+    {
+      preSieved[i] = 0;
+      for (int bit = 0; bit < 8; bit++)
+      {
+        uint64_t n = i * 30 + bitValues[bit];
+        if (n % 7 && n % 11 && n % 13)
+          preSieved[i] |= (byte_t) (1 << bit);
+      }
+    }
+
+    return preSieved;
+  }();
+
+  return preSieved;
+}
+
+} // namespace
+
+namespace primesieve {
+
+bool SmallSieve::isSmall(uint64_t start, uint64_t stop)
+{
+  start = max<uint64_t>(start, 7);
+
+  if (start > stop)
+    return false;
+  if (stop < PrimeBitmap::MAX)
+    return true;
+
+  return stop < (1ull << 32) &&
+         (stop - start) / 30 + 2 < config::SMALL_SIEVE_BYTES;
+}
+
+/// @pre isSmall(start, stop)
+SmallSieve::SmallSieve(uint64_t start, uint64_t stop) :
+  start_(max<uint64_t>(start, 7)),
+  stop_(stop)
+{
+  low_ = start_ - start_ % 30;
+  if (start_ - low_ < 7)
+    low_ -= 30;
+
+  size_ = (stop_ - low_ - 7) / 30 + 1;
+  initMasks();
+
+  if (stop_ < PrimeBitmap::MAX)
+  {
+    sieve_ = &PrimeBitmap::getSieve()[low_ / 30];
+    return;
+  }
+
+  uint64_t words = ceilDiv(size_, 8);
+  preSieve();
+  memset(&buffer_[size_], 0, words * 8 - size_);
+
+  // Primes 2, 3 and 5 are not stored in the sieve array,
+  // the multiples of 7, 11 and 13 have been pre-sieved.
+  uint64_t sqrtStop = isqrt(stop_);
+  const byte_t* primes = PrimeBitmap::getSieve();
+
+  for (uint64_t i = 0; i * 30 + 7 <= sqrtStop; i++)
+  {
+    for (int bit = 0; bit < 8; bit++)
+    {
+      uint64_t prime = i * 30 + bitValues[bit];
+      if ((primes[i] & (1 << bit)) &&
+          prime > 13 &&
+          prime <= sqrtStop)
+        crossOff((uint32_t) prime);
+    }
+  }
+
+  buffer_[0] &= firstMask_;
+  buffer_[size_ - 1] &= lastMask_;
+  sieve_ = buffer_;
+}
+
+/// Copy the pre-sieved pattern to the sieve array
+void SmallSieve::preSieve()
+{
+  auto& preSieved = getPreSieved();
+  uint64_t i = (low_ % (PRESIEVE_BYTES * 30)) / 30;
+  uint64_t j = 0;
+
+  while (j < size_)
+  {
+    uint64_t bytes = min(PRESIEVE_BYTES - i, size_ - j);
+    memcpy(&buffer_[j], &preSieved[i], bytes);
+    j += bytes;
+    i = 0;
+  }
+
+  // 7, 11 and 13 are prime
+  if (low_ == 0)
+    buffer_[0] |= 0x07;
+}
+
+/// Cross off the multiples prime * q with q coprime to 30.
+/// The multiples prime * (q + 30 * k) correspond to the same
+/// bit in every prime-th byte, hence we iterate over the
+/// (at most 8) first q of each residue. Large primes have few
+/// multiples inside [low_, stop_], we stop at the first
+/// multiple > stop_.
+///
+void SmallSieve::crossOff(uint32_t prime)
+{
+  // stop_ < 2^32, 32-bit division is faster
+  uint32_t low = (uint32_t) low_;
+  uint32_t stop = (uint32_t) stop_;
+  uint32_t q = max(prime, (low + 6) / prime + 1);
+  uint32_t i = wheelIndex[q % 30];
+  uint32_t q30 = q - q % 30;
+  uint32_t p30 = prime % 30;
+
+  for (int n = 0; n < 8; n++)
+  {
+    uint64_t multiple = (uint64_t) prime * (q30 + wheel[i]);
+    if (multiple > stop)
+      break;
+
+    // low is a multiple of 30
+    int bit = bitIndex[(p30 * wheel[i]) % 30];
+    byte_t mask = (byte_t) ~(1 << bit);
+
+    for (uint32_t j = (uint32_t) (multiple - low - 7) / 30; j < size_; j += prime)
+      buffer_[j] &= mask;
+
+    if (++i == 8)
+    {
+      i = 0;
+      q30 += 30;
+    }
+  }
+}
+
+/// Bitmasks to unset the bits of the numbers < start_
+/// in the first byte and > stop_ in the last byte.
+///
+void SmallSieve::initMasks()
+{
+  uint64_t last = low_ + (size_ - 1) * 30;
+  firstMask_ = 0;
+  lastMask_ = 0;
+
+  for (int bit = 0; bit < 8; bit++)
+  {
+    if (low_ + bitValues[bit] >= start_)
+      firstMask_ |= (byte_t) (1 << bit);
+    if (last + bitValues[bit] <= stop_)
+      lastMask_ |= (byte_t) (1 << bit);
+  }
+}
+
+/// Add the number of primes and prime k-tuplets
+/// to the counts of the PrimeSieve object.
+///
+void SmallSieve::count(PrimeSieve& ps) const
+{
+  counts_t& counts = ps.getCounts();
+
+  if (ps.isCount(0))
+  {
+    if (sieve_ != buffer_)
+      counts[0] += PrimeBitmap::primePi(stop_) - PrimeBitmap::primePi(start_ - 1);
+    else
+      counts[0] += popcount((const uint64_t*) buffer_, ceilDiv(size_, 8));
+  }
+
+  // i = 1 twins, i = 2 triplets, ...
+  for (size_t i = 1; i < counts.size(); i++)
+  {
+    if (!ps.isCount((int) i))
+      continue;
+
+    for (uint64_t j = 0; j < size_; j++)
+    {
+      byte_t bits = sieve_[j];
+      if (j == 0)
+        bits &= firstMask_;
+      if (j == size_ - 1)
+        bits &= lastMask_;
+
+      for (const uint64_t* b = PrintPrimes::bitmasks_[i]; *b <= bits; b++)
+        if ((bits & *b) == *b)
+          counts[i]++;
+    }
+  }
+}
+
+} // namespace
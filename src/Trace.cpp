@@ -0,0 +1,244 @@
+///
+/// @file   Trace.cpp
+/// @brief  Per-thread ring buffers of trace events and the
+///         Chrome trace JSON writer.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/Trace.hpp>
+#include <primesieve/primesieve_error.hpp>
+
+#include <stdint.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace primesieve;
+
+namespace {
+
+struct EventInfo
+{
+  const char* name;
+  const char* arg1;
+  const char* arg2;
+};
+
+const array<EventInfo, Trace::EVENTS> eventInfos =
+{{
+  { "sieve", "start", "stop" },
+  { "chunk", "start", "stop" },
+  { "segment", "low", "high" },
+  { "sieving_primes", "max_prime", nullptr },
+  { "status", "distance", "updated" },
+  { "wait", "thread", nullptr }
+}};
+
+struct Record
+{
+  Trace::Event event;
+  uint64_t begin;
+  uint64_t end;
+  uint64_t arg1;
+  uint64_t arg2;
+};
+
+/// Ring buffer of a single thread, only that
+/// thread adds events to the buffer.
+///
+struct Buffer
+{
+  Buffer(int id) :
+    records(Trace::RING_SIZE),
+    tid(id),
+    name("thread " + to_string(id))
+  { }
+
+  vector<Record> records;
+  /// Number of recorded events
+  atomic<uint64_t> count{0};
+  int tid;
+  string name;
+};
+
+mutex buffersMutex;
+vector<unique_ptr<Buffer>> buffers;
+
+/// Incremented by start(), invalidates the
+/// thread local buffers of the previous trace.
+///
+atomic<uint64_t> generation(0);
+
+chrono::steady_clock::time_point epoch;
+
+thread_local Buffer* localBuffer = nullptr;
+thread_local uint64_t localGeneration = 0;
+
+/// The mutex is only locked when a
+/// thread records its first event.
+///
+Buffer* getBuffer()
+{
+  uint64_t gen = generation.load(memory_order_acquire);
+
+  if (!localBuffer || localGeneration != gen)
+  {
+    lock_guard<mutex> lock(buffersMutex);
+    int tid = (int) buffers.size();
+    buffers.emplace_back(new Buffer(tid));
+    localBuffer = buffers.back().get();
+    localGeneration = gen;
+  }
+
+  return localBuffer;
+}
+
+string escape(const string& str)
+{
+  string res;
+  for (char c : str)
+  {
+    if (c == '"' || c == '\\')
+      res += '\\';
+    if ((unsigned char) c >= 0x20)
+      res += c;
+  }
+  return res;
+}
+
+/// Chrome trace timestamps are in microseconds
+double toMicroseconds(uint64_t ns)
+{
+  return ns / 1000.0;
+}
+
+} // namespace
+
+namespace primesieve {
+
+atomic<bool> Trace::enabled_(false);
+
+void Trace::start()
+{
+  {
+    lock_guard<mutex> lock(buffersMutex);
+    buffers.clear();
+    epoch = chrono::steady_clock::now();
+    generation++;
+  }
+
+  enabled_ = true;
+  setThreadName("main");
+}
+
+void Trace::stop()
+{
+  enabled_ = false;
+}
+
+uint64_t Trace::now()
+{
+  auto t = chrono::steady_clock::now() - epoch;
+  return chrono::duration_cast<chrono::nanoseconds>(t).count();
+}
+
+void Trace::record(Event event,
+                   uint64_t begin,
+                   uint64_t end,
+                   uint64_t arg1,
+                   uint64_t arg2)
+{
+  Buffer* buffer = getBuffer();
+  uint64_t n = buffer->count.load(memory_order_relaxed);
+  Record& r = buffer->records[n % RING_SIZE];
+  r.event = event;
+  r.begin = begin;
+  r.end = end;
+  r.arg1 = arg1;
+  r.arg2 = arg2;
+  buffer->count.store(n + 1, memory_order_release);
+}
+
+void Trace::setThreadName(const string& name)
+{
+  getBuffer()->name = name;
+}
+
+uint64_t Trace::getDropped()
+{
+  lock_guard<mutex> lock(buffersMutex);
+  uint64_t dropped = 0;
+
+  for (auto& buffer : buffers)
+  {
+    uint64_t count = buffer->count.load(memory_order_acquire);
+    if (count > RING_SIZE)
+      dropped += count - RING_SIZE;
+  }
+
+  return dropped;
+}
+
+void Trace::write(const string& filename)
+{
+  ofstream file(filename);
+  if (!file)
+    throw primesieve_error("failed to create " + filename);
+
+  uint64_t dropped = getDropped();
+  lock_guard<mutex> lock(buffersMutex);
+  string separator = "\n";
+
+  file << "{\"displayTimeUnit\": \"ms\", "
+       << "\"otherData\": {\"dropped_events\": " << dropped << "}, "
+       << "\"traceEvents\": [";
+  file << fixed << setprecision(3);
+
+  for (auto& buffer : buffers)
+  {
+    file << separator << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+         << "\"tid\": " << buffer->tid << ", "
+         << "\"args\": {\"name\": \"" << escape(buffer->name) << "\"}}";
+    separator = ",\n";
+
+    // Oldest event first
+    uint64_t count = buffer->count.load(memory_order_acquire);
+    uint64_t first = (count > RING_SIZE) ? count - RING_SIZE : 0;
+
+    for (uint64_t i = first; i < count; i++)
+    {
+      const Record& r = buffer->records[i % RING_SIZE];
+      const EventInfo& info = eventInfos[r.event];
+
+      file << separator << "{\"name\": \"" << info.name << "\", "
+           << "\"cat\": \"primesieve\", \"ph\": \"X\", \"pid\": 1, "
+           << "\"tid\": " << buffer->tid << ", "
+           << "\"ts\": " << toMicroseconds(r.begin) << ", "
+           << "\"dur\": " << toMicroseconds(r.end - r.begin) << ", "
+           << "\"args\": {\"" << info.arg1 << "\": " << r.arg1;
+
+      if (info.arg2)
+        file << ", \"" << info.arg2 << "\": " << r.arg2;
+
+      file << "}}";
+    }
+  }
+
+  file << "\n]}\n";
+
+  if (!file)
+    throw primesieve_error("failed to write " + filename);
+}
+
+} // namespace
@@ -0,0 +1,236 @@
+///
+/// @file  TupletGenerator.cpp
+///        Generates the prime k-tuplets inside [start, stop] in
+///        blocks. Each 64-bit word of the sieve array is tested
+///        for all bitmasks of the k-tuplets at once using SWAR
+///        (SIMD within a register) operations. Only the bytes of
+///        the rare words that contain a k-tuplet are decoded,
+///        all other primes are skipped.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/Erat.hpp>
+#include <primesieve/littleendian_cast.hpp>
+#include <primesieve/pmath.hpp>
+#include <primesieve/PrintPrimes.hpp>
+#include <primesieve/primesieve_error.hpp>
+#include <primesieve/TupletGenerator.hpp>
+#include <primesieve/types.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct SmallTuplet
+{
+  int k;
+  array<uint64_t, 5> primes;
+};
+
+/// The prime k-tuplets containing primes < 7
+/// are not found by sieving.
+///
+const array<SmallTuplet, 5> smallTuplets =
+{{
+  { 2, {{ 3, 5 }} },
+  { 2, {{ 5, 7 }} },
+  { 3, {{ 5, 7, 11 }} },
+  { 4, {{ 5, 7, 11, 13 }} },
+  { 5, {{ 5, 7, 11, 13, 17 }} }
+}};
+
+} // namespace
+
+namespace primesieve {
+
+TupletGenerator::TupletGenerator(int k) :
+  k_(k)
+{
+  if (k < 2 || k > 6)
+    throw primesieve_error("TupletGenerator: k must be >= 2 and <= 6");
+
+  bitmasks_ = PrintPrimes::bitmasks_[k - 1];
+
+  for (; bitmasks_[masks_] != PrintPrimes::END; masks_++)
+    wordmasks_[masks_] = bitmasks_[masks_] * 0x0101010101010101ull;
+}
+
+/// Generate the k-tuplets inside [start, stop], the sieve
+/// array and the bucket memory of the previous interval
+/// are reused.
+///
+void TupletGenerator::init(uint64_t start, uint64_t stop)
+{
+  start_ = start;
+  stop_ = stop;
+  segmentLow_ = ~0ull;
+  segmentHigh_ = 0;
+  low_ = 0;
+  sieveIdx_ = ~0ull;
+  prime_ = 0;
+  isInit_ = false;
+  finished_ = false;
+}
+
+/// The k-tuplets are located inside a single byte of the
+/// sieve array, i.e. inside [30 * i + 7, 30 * i + 31].
+/// Round up stop so that no k-tuplet crosses the border
+/// between two consecutive intervals.
+///
+uint64_t TupletGenerator::alignStop(uint64_t stop)
+{
+  uint64_t rem = stop % 30;
+  uint64_t maxStop = numeric_limits<uint64_t>::max();
+
+  if (rem >= 1 && rem <= 6)
+    return stop;
+  if (stop > maxStop - 30)
+    return maxStop;
+
+  return stop + (31 - rem) % 30;
+}
+
+void TupletGenerator::initErat()
+{
+  uint64_t startErat = max<uint64_t>(start_, 7);
+  isInit_ = true;
+
+  if (startErat <= stop_)
+  {
+    int sieveSize = get_sieve_size();
+    Erat::init(startErat, stop_, sieveSize, preSieve_);
+    sievingPrimes_.init(this, preSieve_);
+  }
+}
+
+void TupletGenerator::fillSmallTuplets(vector<uint64_t>& tuplets,
+                                       size_t* size)
+{
+  for (auto& t : smallTuplets)
+  {
+    if (t.k == k_ &&
+        t.primes[0] >= start_ &&
+        t.primes[k_ - 1] <= stop_)
+    {
+      for (int j = 0; j < k_; j++)
+        tuplets[(*size)++] = t.primes[j];
+    }
+  }
+}
+
+bool TupletGenerator::sieveSegment()
+{
+  if (!hasNextSegment())
+    return false;
+
+  uint64_t sqrtHigh = isqrt(segmentHigh_);
+
+  sieveIdx_ = 0;
+  low_ = segmentLow_;
+
+  if (!prime_)
+    prime_ = sievingPrimes_.next();
+
+  while (prime_ <= sqrtHigh)
+  {
+    addSievingPrime(prime_);
+    prime_ = sievingPrimes_.next();
+  }
+
+  Erat::sieveSegment();
+  return true;
+}
+
+/// Fill the tuplets buffer with the primes of the next
+/// k-tuplets, size is the number of primes (k per k-tuplet).
+/// @pre tuplets.size() >= 64 * k
+///
+void TupletGenerator::fill(vector<uint64_t>& tuplets,
+                           size_t* size)
+{
+  size_t i = 0;
+
+  if (!isInit_)
+  {
+    fillSmallTuplets(tuplets, &i);
+    initErat();
+  }
+
+  // Each 64-bit word of the sieve array contains at
+  // most 32 k-tuplets, fill the tuplets buffer until
+  // it is nearly full or the interval is finished.
+  size_t maxSize = tuplets.size() - 32 * k_;
+  uint64_t* out = tuplets.data();
+  const uint64_t m7f = 0x7f7f7f7f7f7f7f7full;
+
+  while (i <= maxSize)
+  {
+    if (sieveIdx_ >= sieveSize_ &&
+        !sieveSegment())
+    {
+      finished_ = true;
+      break;
+    }
+
+    // Use local copies, the compiler cannot keep the
+    // members in registers as writing to the tuplets
+    // buffer may alias them.
+    const byte_t* sieve = sieve_;
+    uint64_t sieveIdx = sieveIdx_;
+    uint64_t sieveSize = sieveSize_;
+    uint64_t low = low_;
+
+    for (; sieveIdx < sieveSize && i <= maxSize; sieveIdx += 8, low += 8 * 30)
+    {
+      uint64_t word = littleendian_cast<uint64_t>(&sieve[sieveIdx]);
+      uint64_t match = 0;
+
+      // Find the bytes with all bits of a bitmask set,
+      // (word & mask) ^ mask is 0 for these bytes.
+      // Then set the high bit of each zero byte.
+      for (size_t m = 0; m < masks_; m++)
+      {
+        uint64_t x = (word & wordmasks_[m]) ^ wordmasks_[m];
+        match |= ~(((x & m7f) + m7f) | x | m7f);
+      }
+
+      // Decode only the matching bytes
+      for (uint64_t j = 0; match; j++, match >>= 8)
+      {
+        if (match & 0x80)
+        {
+          uint64_t bits = sieve[sieveIdx + j];
+
+          for (const uint64_t* bitmask = bitmasks_; *bitmask <= bits; bitmask++)
+          {
+            if ((bits & *bitmask) == *bitmask)
+            {
+              uint64_t b = *bitmask;
+              while (b)
+                out[i++] = nextPrime(&b, low + j * 30);
+            }
+          }
+        }
+      }
+    }
+
+    sieveIdx_ = sieveIdx;
+    low_ = low;
+  }
+
+  *size = i;
+}
+
+} // namespace
@@ -15,10 +15,13 @@
 #include <primesieve/malloc_vector.hpp>
 
 #include <stdint.h>
+#include <algorithm>
 #include <cstdlib>
 #include <cstddef>
 #include <cerrno>
 #include <exception>
+#include <new>
+#include <vector>
 
 using namespace std;
 using namespace primesieve;
@@ -32,6 +35,7 @@ void* store_primes(uint64_t start, uint64_t stop, size_t* size)
   {
     malloc_vector<T> primes;
     store_primes(start, stop, primes);
+    primes.shrink_to_fit();
 
     if (size)
       *size = primes.size();
@@ -66,6 +70,23 @@ void* store_n_primes(uint64_t n, uint64_t start)
   }
 }
 
+/// Copy the table counts into a malloc'ed array
+uint64_t* copy_table(const vector<uint64_t>& table, size_t* size)
+{
+  size_t n = max<size_t>(table.size(), 1);
+  uint64_t* counts = (uint64_t*) malloc(n * sizeof(uint64_t));
+
+  if (!counts)
+    throw bad_alloc();
+
+  copy(table.begin(), table.end(), counts);
+
+  if (size)
+    *size = table.size();
+
+  return counts;
+}
+
 } // namespace
 
 void* primesieve_generate_primes(uint64_t start, uint64_t stop, size_t* size, int type)
@@ -137,6 +158,19 @@ uint64_t primesieve_nth_prime(int64_t n, uint64_t start)
   }
 }
 
+int primesieve_is_prime(uint64_t n)
+{
+  try
+  {
+    return is_prime(n);
+  }
+  catch (exception&)
+  {
+    errno = EDOM;
+    return 0;
+  }
+}
+
 uint64_t primesieve_count_primes(uint64_t start, uint64_t stop)
 {
   try
@@ -215,6 +249,141 @@ uint64_t primesieve_count_sextuplets(uint64_t start, uint64_t stop)
   }
 }
 
+uint64_t primesieve_count_sophie_germain_primes(uint64_t start, uint64_t stop)
+{
+  try
+  {
+    return count_sophie_germain_primes(start, stop);
+  }
+  catch (exception&)
+  {
+    errno = EDOM;
+    return PRIMESIEVE_ERROR;
+  }
+}
+
+uint64_t primesieve_count_safe_primes(uint64_t start, uint64_t stop)
+{
+  try
+  {
+    return count_safe_primes(start, stop);
+  }
+  catch (exception&)
+  {
+    errno = EDOM;
+    return PRIMESIEVE_ERROR;
+  }
+}
+
+uint64_t primesieve_count_linear_primes(uint64_t a, int64_t b, uint64_t start, uint64_t stop)
+{
+  try
+  {
+    return count_linear_primes(a, b, start, stop);
+  }
+  catch (exception&)
+  {
+    errno = EDOM;
+    return PRIMESIEVE_ERROR;
+  }
+}
+
+uint64_t* primesieve_count_primes_table(uint64_t start, uint64_t stop, uint64_t step, size_t* size)
+{
+  try
+  {
+    return copy_table(count_primes_table(start, stop, step), size);
+  }
+  catch (exception&)
+  {
+    if (size)
+      *size = 0;
+
+    errno = EDOM;
+    return nullptr;
+  }
+}
+
+uint64_t* primesieve_count_twins_table(uint64_t start, uint64_t stop, uint64_t step, size_t* size)
+{
+  try
+  {
+    return copy_table(count_twins_table(start, stop, step), size);
+  }
+  catch (exception&)
+  {
+    if (size)
+      *size = 0;
+
+    errno = EDOM;
+    return nullptr;
+  }
+}
+
+uint64_t* primesieve_count_triplets_table(uint64_t start, uint64_t stop, uint64_t step, size_t* size)
+{
+  try
+  {
+    return copy_table(count_triplets_table(start, stop, step), size);
+  }
+  catch (exception&)
+  {
+    if (size)
+      *size = 0;
+
+    errno = EDOM;
+    return nullptr;
+  }
+}
+
+uint64_t* primesieve_count_quadruplets_table(uint64_t start, uint64_t stop, uint64_t step, size_t* size)
+{
+  try
+  {
+    return copy_table(count_quadruplets_table(start, stop, step), size);
+  }
+  catch (exception&)
+  {
+    if (size)
+      *size = 0;
+
+    errno = EDOM;
+    return nullptr;
+  }
+}
+
+uint64_t* primesieve_count_quintuplets_table(uint64_t start, uint64_t stop, uint64_t step, size_t* size)
+{
+  try
+  {
+    return copy_table(count_quintuplets_table(start, stop, step), size);
+  }
+  catch (exception&)
+  {
+    if (size)
+      *size = 0;
+
+    errno = EDOM;
+    return nullptr;
+  }
+}
+
+uint64_t* primesieve_count_sextuplets_table(uint64_t start, uint64_t stop, uint64_t step, size_t* size)
+{
+  try
+  {
+    return copy_table(count_sextuplets_table(start, stop, step), size);
+  }
+  catch (exception&)
+  {
+    if (size)
+      *size = 0;
+
+    errno = EDOM;
+    return nullptr;
+  }
+}
+
 void primesieve_print_primes(uint64_t start, uint64_t stop)
 {
   try
@@ -287,6 +456,30 @@ void primesieve_print_sextuplets(uint64_t start, uint64_t stop)
   }
 }
 
+void primesieve_print_sophie_germain_primes(uint64_t start, uint64_t stop)
+{
+  try
+  {
+    print_sophie_germain_primes(start, stop);
+  }
+  catch (exception&)
+  {
+    errno = EDOM;
+  }
+}
+
+void primesieve_print_linear_primes(uint64_t a, int64_t b, uint64_t start, uint64_t stop)
+{
+  try
+  {
+    print_linear_primes(a, b, start, stop);
+  }
+  catch (exception&)
+  {
+    errno = EDOM;
+  }
+}
+
 int primesieve_get_sieve_size()
 {
   return get_sieve_size();
@@ -297,16 +490,143 @@ int primesieve_get_num_threads()
   return get_num_threads();
 }
 
+uint64_t primesieve_get_max_memory()
+{
+  return get_max_memory();
+}
+
 void primesieve_set_sieve_size(int sieve_size)
 {
   set_sieve_size(sieve_size);
 }
 
+void primesieve_set_exact_reserve(int exact)
+{
+  set_exact_reserve(exact != 0);
+}
+
 void primesieve_set_num_threads(int num_threads)
 {
   set_num_threads(num_threads);
 }
 
+void primesieve_set_max_memory(uint64_t max_memory)
+{
+  set_max_memory(max_memory);
+}
+
+int primesieve_build_sieving_primes_cache(const char* filename,
+                                          uint64_t max_prime)
+{
+  try
+  {
+    build_sieving_primes_cache(filename, max_prime);
+    return 0;
+  }
+  catch (exception&)
+  {
+    errno = EDOM;
+    return -1;
+  }
+}
+
+int primesieve_set_profile(const char* filename)
+{
+  try
+  {
+    set_profile((filename) ? filename : "");
+    return 0;
+  }
+  catch (exception&)
+  {
+    errno = EDOM;
+    return -1;
+  }
+}
+
+int primesieve_set_sieving_primes_cache(const char* filename)
+{
+  try
+  {
+    set_sieving_primes_cache((filename) ? filename : "");
+    return 0;
+  }
+  catch (exception&)
+  {
+    errno = EDOM;
+    return -1;
+  }
+}
+
+void primesieve_set_shared_memory(int enabled)
+{
+  set_shared_memory(enabled != 0);
+}
+
+void primesieve_remove_shared_memory()
+{
+  remove_shared_memory();
+}
+
+void primesieve_set_counts_cache(uint64_t max_memory)
+{
+  set_counts_cache(max_memory);
+}
+
+primesieve_counts_cache_stats primesieve_get_counts_cache_stats()
+{
+  counts_cache_stats stats = get_counts_cache_stats();
+  primesieve_counts_cache_stats res;
+  res.hits = stats.hits;
+  res.misses = stats.misses;
+  res.evictions = stats.evictions;
+  res.blocks = stats.blocks;
+  res.memory_usage = stats.memory_usage;
+  return res;
+}
+
+void primesieve_clear_counts_cache()
+{
+  clear_counts_cache();
+}
+
+primesieve_memory_pool_stats primesieve_get_memory_pool_stats()
+{
+  memory_pool_stats stats = get_memory_pool_stats();
+  primesieve_memory_pool_stats res;
+  res.buckets_in_use = stats.buckets_in_use;
+  res.peak_buckets_in_use = stats.peak_buckets_in_use;
+  res.allocations = stats.allocations;
+  res.bytes = stats.bytes;
+  res.peak_bytes = stats.peak_bytes;
+  return res;
+}
+
+int primesieve_is_sieve_stats_enabled()
+{
+  return is_sieve_stats_enabled();
+}
+
+primesieve_sieve_stats primesieve_get_sieve_stats()
+{
+  sieve_stats stats = get_sieve_stats();
+  primesieve_sieve_stats res;
+  res.pre_sieve = stats.pre_sieve;
+  res.erat_small = stats.erat_small;
+  res.erat_medium = stats.erat_medium;
+  res.erat_big = stats.erat_big;
+  res.sieving_primes = stats.sieving_primes;
+  res.count = stats.count;
+  res.print = stats.print;
+  res.segments = stats.segments;
+  return res;
+}
+
+void primesieve_reset_sieve_stats()
+{
+  reset_sieve_stats();
+}
+
 uint64_t primesieve_get_max_stop()
 {
   return get_max_stop();
@@ -11,15 +11,28 @@
 ///
 
 #include <primesieve.hpp>
+#include <primesieve/CountsCache.hpp>
 #include <primesieve/CpuInfo.hpp>
+#include <primesieve/MemoryPool.hpp>
 #include <primesieve/pmath.hpp>
+#include <primesieve/PrimeBitmap.hpp>
 #include <primesieve/PrimeSieve.hpp>
 #include <primesieve/ParallelSieve.hpp>
+#include <primesieve/PreSieve.hpp>
+#include <primesieve/primesieve_error.hpp>
+#include <primesieve/Profile.hpp>
+#include <primesieve/ShmSegment.hpp>
+#include <primesieve/SieveStats.hpp>
+#include <primesieve/SievingPrimesCache.hpp>
 
 #include <stdint.h>
+#include <algorithm>
 #include <cstddef>
 #include <limits>
 #include <string>
+#include <vector>
+
+using namespace primesieve;
 
 namespace {
 
@@ -27,6 +40,34 @@ int sieve_size = 0;
 
 int num_threads = 0;
 
+uint64_t max_memory = 0;
+
+bool exact_reserve = false;
+
+/// Count inside [start, x] for each multiple x of
+/// step, i = 0 primes, i = 1 twins, ...
+///
+std::vector<uint64_t> count_table(uint64_t start,
+                                  uint64_t stop,
+                                  uint64_t step,
+                                  int i)
+{
+  if (step == 0)
+    throw primesieve_error("table step must be > 0");
+
+  ParallelSieve ps;
+  ps.setTableStep(step);
+  ps.sieve(start, stop, COUNT_PRIMES << i);
+
+  std::vector<uint64_t> table;
+  table.reserve(ps.getTable().size());
+
+  for (auto& counts : ps.getTable())
+    table.push_back(counts[i]);
+
+  return table;
+}
+
 }
 
 namespace primesieve {
@@ -37,6 +78,14 @@ uint64_t nth_prime(int64_t n, uint64_t start)
   return ps.nthPrime(n, start);
 }
 
+bool is_prime(uint64_t n)
+{
+  if (n < PrimeBitmap::MAX)
+    return PrimeBitmap::isPrime(n);
+
+  return count_primes(n, n) == 1;
+}
+
 uint64_t count_primes(uint64_t start, uint64_t stop)
 {
   ParallelSieve ps;
@@ -79,6 +128,67 @@ uint64_t count_sextuplets(uint64_t start, uint64_t stop)
   return ps.getCount(5);
 }
 
+std::vector<uint64_t> count_primes_table(uint64_t start, uint64_t stop, uint64_t step)
+{
+  return count_table(start, stop, step, 0);
+}
+
+std::vector<uint64_t> count_twins_table(uint64_t start, uint64_t stop, uint64_t step)
+{
+  return count_table(start, stop, step, 1);
+}
+
+std::vector<uint64_t> count_triplets_table(uint64_t start, uint64_t stop, uint64_t step)
+{
+  return count_table(start, stop, step, 2);
+}
+
+std::vector<uint64_t> count_quadruplets_table(uint64_t start, uint64_t stop, uint64_t step)
+{
+  return count_table(start, stop, step, 3);
+}
+
+std::vector<uint64_t> count_quintuplets_table(uint64_t start, uint64_t stop, uint64_t step)
+{
+  return count_table(start, stop, step, 4);
+}
+
+std::vector<uint64_t> count_sextuplets_table(uint64_t start, uint64_t stop, uint64_t step)
+{
+  return count_table(start, stop, step, 5);
+}
+
+uint64_t count_linear_primes(uint64_t a, int64_t b, uint64_t start, uint64_t stop)
+{
+  if (a == 0)
+    throw primesieve_error("linear form: a must be > 0");
+
+  ParallelSieve ps;
+  ps.setLinearForm(a, b);
+  ps.sieve(start, stop, COUNT_PRIMES);
+  return ps.getCount(0);
+}
+
+uint64_t count_sophie_germain_primes(uint64_t start, uint64_t stop)
+{
+  return count_linear_primes(2, 1, start, stop);
+}
+
+/// A safe prime q = 2p + 1 corresponds
+/// to a Sophie Germain prime p.
+///
+uint64_t count_safe_primes(uint64_t start, uint64_t stop)
+{
+  if (stop < 5)
+    return 0;
+
+  start = std::max<uint64_t>(start, 5);
+  if (start > stop)
+    return 0;
+
+  return count_sophie_germain_primes(start / 2, (stop - 1) / 2);
+}
+
 void print_primes(uint64_t start, uint64_t stop)
 {
   PrimeSieve ps;
@@ -115,10 +225,30 @@ void print_sextuplets(uint64_t start, uint64_t stop)
   ps.sieve(start, stop, PRINT_SEXTUPLETS);
 }
 
+void print_linear_primes(uint64_t a, int64_t b, uint64_t start, uint64_t stop)
+{
+  if (a == 0)
+    throw primesieve_error("linear form: a must be > 0");
+
+  PrimeSieve ps;
+  ps.setLinearForm(a, b);
+  ps.sieve(start, stop, PRINT_PRIMES);
+}
+
+void print_sophie_germain_primes(uint64_t start, uint64_t stop)
+{
+  print_linear_primes(2, 1, start, stop);
+}
+
 int get_num_threads()
 {
   if (num_threads)
     return num_threads;
+
+  // number of threads from the tuning profile
+  int threads = Profile::get().threads;
+  if (threads)
+    return inBetween(1, threads, ParallelSieve::getMaxThreads());
   else
     return ParallelSieve::getMaxThreads();
 }
@@ -128,6 +258,112 @@ void set_num_threads(int threads)
   num_threads = inBetween(1, threads, ParallelSieve::getMaxThreads());
 }
 
+void set_exact_reserve(bool exact)
+{
+  exact_reserve = exact;
+}
+
+bool is_exact_reserve()
+{
+  return exact_reserve;
+}
+
+uint64_t get_max_memory()
+{
+  return max_memory;
+}
+
+void set_max_memory(uint64_t bytes)
+{
+  max_memory = bytes;
+}
+
+void build_sieving_primes_cache(const std::string& filename,
+                                uint64_t max_prime)
+{
+  SievingPrimesCache::build(filename, max_prime);
+}
+
+void set_sieving_primes_cache(const std::string& filename)
+{
+  SievingPrimesCache::use(filename);
+}
+
+void set_profile(const std::string& filename)
+{
+  Profile::use(filename);
+}
+
+void set_shared_memory(bool enabled)
+{
+  ShmSegment::enable(enabled);
+}
+
+void remove_shared_memory()
+{
+  SievingPrimesCache::removeShared();
+  PreSieve::removeShared();
+}
+
+void set_counts_cache(uint64_t max_memory)
+{
+  countsCache.setMaxMemory(max_memory);
+}
+
+counts_cache_stats get_counts_cache_stats()
+{
+  CountsCache::Stats stats = countsCache.getStats();
+  counts_cache_stats res;
+  res.hits = stats.hits;
+  res.misses = stats.misses;
+  res.evictions = stats.evictions;
+  res.blocks = stats.blocks;
+  res.memory_usage = stats.memoryUsage;
+  return res;
+}
+
+void clear_counts_cache()
+{
+  countsCache.clear();
+}
+
+memory_pool_stats get_memory_pool_stats()
+{
+  MemoryPool::Stats stats = MemoryPool::getStats();
+  memory_pool_stats res;
+  res.buckets_in_use = stats.bucketsInUse;
+  res.peak_buckets_in_use = stats.peakBucketsInUse;
+  res.allocations = stats.allocations;
+  res.bytes = stats.bytes;
+  res.peak_bytes = stats.peakBytes;
+  return res;
+}
+
+bool is_sieve_stats_enabled()
+{
+  return SieveStats::isEnabled();
+}
+
+sieve_stats get_sieve_stats()
+{
+  SieveStats stats = SieveStats::getGlobal();
+  sieve_stats res;
+  res.pre_sieve = stats.seconds[SieveStats::PRE_SIEVE];
+  res.erat_small = stats.seconds[SieveStats::ERAT_SMALL];
+  res.erat_medium = stats.seconds[SieveStats::ERAT_MEDIUM];
+  res.erat_big = stats.seconds[SieveStats::ERAT_BIG];
+  res.sieving_primes = stats.seconds[SieveStats::SIEVING_PRIMES];
+  res.count = stats.seconds[SieveStats::COUNT];
+  res.print = stats.seconds[SieveStats::PRINT];
+  res.segments = stats.segments;
+  return res;
+}
+
+void reset_sieve_stats()
+{
+  SieveStats::resetGlobal();
+}
+
 uint64_t get_max_stop()
 {
   return std::numeric_limits<uint64_t>::max();
@@ -150,6 +386,10 @@ int get_sieve_size()
   if (sieve_size)
     return sieve_size;
 
+  // sieve size from the tuning profile
+  if (Profile::get().sieveSize)
+    return Profile::get().sieveSize;
+
   // Shared CPU caches are usually slow. Hence we only use
   // the L2 cache for sieving if each physical CPU core
   // has a private L2 cache. Also we only use half of the
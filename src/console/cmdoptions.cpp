@@ -47,10 +47,19 @@ struct Option
       throw primesieve_error("missing value for option " + str);
     return calculator::eval<T>(val);
   }
+
+  string getFilename() const
+  {
+    if (val.empty())
+      throw primesieve_error("missing filename for option " + str);
+    return val;
+  }
 };
 
 enum OptionID
 {
+  OPTION_BUILD_CACHE,
+  OPTION_CACHE,
   OPTION_COUNT,
   OPTION_CPU_INFO,
   OPTION_HELP,
@@ -58,18 +67,27 @@ enum OptionID
   OPTION_NO_STATUS,
   OPTION_NUMBER,
   OPTION_DISTANCE,
+  OPTION_PERF,
   OPTION_PRINT,
   OPTION_QUIET,
+  OPTION_SHM,
   OPTION_SIZE,
+  OPTION_SOPHIE_GERMAIN,
+  OPTION_STATS,
+  OPTION_TABLE,
   OPTION_TEST,
   OPTION_THREADS,
   OPTION_TIME,
+  OPTION_TRACE,
+  OPTION_TUNE,
   OPTION_VERSION
 };
 
 /// Command-line options
 map<string, OptionID> optionMap =
 {
+  { "--build-cache", OPTION_BUILD_CACHE },
+  { "--cache",     OPTION_CACHE },
   { "-c",          OPTION_COUNT },
   { "--count",     OPTION_COUNT },
   { "--cpu-info",  OPTION_CPU_INFO },
@@ -82,16 +100,23 @@ map<string, OptionID> optionMap =
   { "--number",    OPTION_NUMBER },
   { "-d",          OPTION_DISTANCE },
   { "--dist",      OPTION_DISTANCE },
+  { "--perf",      OPTION_PERF },
   { "-p",          OPTION_PRINT },
   { "--print",     OPTION_PRINT },
   { "-q",          OPTION_QUIET },
   { "--quiet",     OPTION_QUIET },
   { "-s",          OPTION_SIZE },
   { "--size",      OPTION_SIZE },
+  { "--shm",       OPTION_SHM },
+  { "--sophie-germain", OPTION_SOPHIE_GERMAIN },
+  { "--stats",     OPTION_STATS },
+  { "--table",     OPTION_TABLE },
   { "--test",      OPTION_TEST },
   { "-t",          OPTION_THREADS },
   { "--threads",   OPTION_THREADS },
   { "--time",      OPTION_TIME },
+  { "--trace",     OPTION_TRACE },
+  { "--tune",      OPTION_TUNE },
   { "-v",          OPTION_VERSION },
   { "--version",   OPTION_VERSION }
 };
@@ -176,6 +201,18 @@ string getValue(const string& str)
     return str.substr(pos);
 }
 
+/// Options whose value is a filename
+bool isFileOption(const string& opt)
+{
+  auto iter = optionMap.find(opt);
+
+  return iter != optionMap.end() &&
+         (iter->second == OPTION_BUILD_CACHE ||
+          iter->second == OPTION_CACHE ||
+          iter->second == OPTION_TRACE ||
+          iter->second == OPTION_TUNE);
+}
+
 /// e.g. "--threads=8"
 /// -> opt.opt = "--threads"
 /// -> opt.val = "8"
@@ -188,6 +225,18 @@ Option makeOption(const string& str)
   opt.opt = getOption(str);
   opt.val = getValue(str);
 
+  // e.g. "--cache=primes.dat"
+  // -> opt.opt = "--cache"
+  // -> opt.val = "primes.dat"
+  size_t pos = str.find('=');
+
+  if (pos != string::npos &&
+      isFileOption(str.substr(0, pos)))
+  {
+    opt.opt = str.substr(0, pos);
+    opt.val = str.substr(pos + 1);
+  }
+
   if (opt.opt.empty() && !opt.val.empty())
     opt.opt = "--number";
 
@@ -284,16 +333,25 @@ CmdOptions parseOptions(int argc, char* argv[])
 
     switch (optionMap[opt.opt])
     {
+      case OPTION_BUILD_CACHE: opts.buildCacheFile = opt.getFilename(); break;
+      case OPTION_CACHE:     opts.cacheFile = opt.getFilename(); break;
       case OPTION_COUNT:     optionCount(opt, opts); break;
       case OPTION_CPU_INFO:  optionCpuInfo(); break;
       case OPTION_DISTANCE:  optionDistance(opt, opts); break;
       case OPTION_PRINT:     optionPrint(opt, opts); break;
+      case OPTION_PERF:      opts.perf = true; break;
       case OPTION_SIZE:      opts.sieveSize = opt.getValue<int>(); break;
+      case OPTION_TABLE:     opts.tableStep = opt.getValue<uint64_t>(); break;
       case OPTION_THREADS:   opts.threads = opt.getValue<int>(); break;
       case OPTION_QUIET:     opts.quiet = true; break;
+      case OPTION_SHM:       opts.sharedMemory = true; break;
       case OPTION_NTH_PRIME: opts.nthPrime = true; break;
+      case OPTION_SOPHIE_GERMAIN: opts.sophieGermain = true; break;
+      case OPTION_STATS:     opts.stats = true; break;
       case OPTION_NO_STATUS: opts.status = false; break;
       case OPTION_TIME:      opts.time = true; break;
+      case OPTION_TRACE:     opts.traceFile = opt.getFilename(); break;
+      case OPTION_TUNE:      opts.tune = true; opts.profileFile = opt.val; break;
       case OPTION_NUMBER:    opts.numbers.push_back(opt.getValue<uint64_t>()); break;
       case OPTION_HELP:      help(); break;
       case OPTION_TEST:      test(); break;
@@ -301,7 +359,9 @@ CmdOptions parseOptions(int argc, char* argv[])
     }
   }
 
-  if (opts.numbers.empty())
+  if (opts.numbers.empty() &&
+      opts.buildCacheFile.empty() &&
+      !opts.tune)
     throw primesieve_error("missing STOP number");
 
   if (opts.quiet)
@@ -12,17 +12,28 @@
 
 #include <stdint.h>
 #include <deque>
+#include <string>
 
 struct CmdOptions
 {
   std::deque<uint64_t> numbers;
+  std::string cacheFile;
+  std::string buildCacheFile;
+  std::string profileFile;
+  std::string traceFile;
+  uint64_t tableStep = 0;
   int flags = 0;
   int sieveSize = 0;
   int threads = 0;
   bool quiet = false;
+  bool sharedMemory = false;
   bool nthPrime = false;
+  bool perf = false;
+  bool sophieGermain = false;
   bool status = true;
+  bool stats = false;
   bool time = false;
+  bool tune = false;
 };
 
 CmdOptions parseOptions(int, char**);
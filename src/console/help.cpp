@@ -26,6 +26,10 @@ const string helpMenu
   "(< 2^64) using the segmented sieve of Eratosthenes.\n"
   "\n"
   "Options:\n"
+  "          --build-cache=<FILE>\n"
+  "                         Store the primes < 2^32 (203 MB) in a cache\n"
+  "                         file, speeds up sieving near 2^64\n"
+  "          --cache=<FILE> Read the sieving primes from the cache file\n"
   "  -c[N+], --count[=N+]   Count primes and prime k-tuplets, N <= 6,\n"
   "                         e.g. -c1 primes, -c2 twins, -c3 triplets, ...\n"
   "          --cpu-info     Print CPU information\n"
@@ -34,13 +38,30 @@ const string helpMenu
   "  -n,     --nth-prime    Calculate the nth prime,\n"
   "                         e.g. 1 100 -n finds the 1st prime > 100\n"
   "          --no-status    Turn off the progressing status\n"
+  "          --perf         Print hardware performance counters (cycles,\n"
+  "                         cache misses, ...), requires Linux perf events\n"
   "  -p[N],  --print[=N]    Print primes or prime k-tuplets, N <= 6,\n"
   "                         e.g. -p1 primes, -p2 twins, -p3 triplets, ...\n"
   "  -q,     --quiet        Quiet mode, prints less output\n"
   "  -s<N>,  --size=<N>     Set the sieve size in KiB, N <= 4096\n"
+  "          --shm          Share the sieving primes with other primesieve\n"
+  "                         processes using shared memory\n"
+  "          --sophie-germain\n"
+  "                         Count the Sophie Germain primes p (2p + 1 is\n"
+  "                         also prime), print the pairs using -p\n"
+  "          --stats        Print the time spent in each sieving phase,\n"
+  "                         requires cmake -DENABLE_STATS=ON\n"
+  "          --table=<N>    Print the counts inside [START, x] for each\n"
+  "                         multiple x of N, e.g. 1e12 --table=1e9\n"
   "          --test         Run various sieving tests\n"
   "  -t<N>,  --threads=<N>  Set the number of threads, N <= CPU cores\n"
   "          --time         Print the time elapsed in seconds\n"
+  "          --trace=<FILE> Write a Chrome trace JSON file of what each\n"
+  "                         thread does over time (chrome://tracing)\n"
+  "          --tune[=<FILE>]\n"
+  "                         Find the fastest settings for this CPU and\n"
+  "                         store them in the tuning profile, by default\n"
+  "                         $XDG_CONFIG_HOME/primesieve/profile\n"
   "  -v,     --version      Print version and license information\n"
   "\n"
   "Examples:\n"
@@ -8,14 +8,24 @@
 /// file in the top level directory.
 ///
 
+#include <primesieve.hpp>
 #include <primesieve/ParallelSieve.hpp>
+#include <primesieve/PerfCounters.hpp>
+#include <primesieve/Trace.hpp>
 #include "cmdoptions.hpp"
 
 #include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
 #include <exception>
 #include <iomanip>
 #include <string>
+#include <utility>
+#include <vector>
+
+void tune(const CmdOptions&);
 
 using namespace std;
 using namespace primesieve;
@@ -33,6 +43,163 @@ void printSeconds(double sec)
   cout << "Seconds: " << fixed << setprecision(3) << sec << endl;
 }
 
+/// Print the time spent in each sieving phase,
+/// summed over all threads.
+///
+void printStats()
+{
+  if (!is_sieve_stats_enabled())
+  {
+    cout << "Stats: not available, requires cmake -DENABLE_STATS=ON" << endl;
+    return;
+  }
+
+  sieve_stats stats = get_sieve_stats();
+
+  const pair<string, double> phases[] =
+  {
+    { "Pre-sieve:      ", stats.pre_sieve },
+    { "EratSmall:      ", stats.erat_small },
+    { "EratMedium:     ", stats.erat_medium },
+    { "EratBig:        ", stats.erat_big },
+    { "Sieving primes: ", stats.sieving_primes },
+    { "Count:          ", stats.count },
+    { "Print:          ", stats.print }
+  };
+
+  double total = 0;
+  for (auto& phase : phases)
+    total += phase.second;
+
+  cout << "Segments: " << stats.segments << endl;
+
+  for (auto& phase : phases)
+  {
+    double percent = (total > 0) ? phase.second * 100 / total : 0;
+    cout << phase.first << fixed << setprecision(3) << phase.second
+         << " sec (" << setprecision(1) << percent << "%)" << endl;
+  }
+}
+
+/// Estimated number of crossing-offs of the sieve of
+/// Eratosthenes for [start, stop]. Each sieving prime p
+/// removes about dist / p * 8 / 30 multiples (wheel 30) and
+/// PreSieve removes the multiples of primes <= 19. Uses
+/// sum 1 / p for p <= x ~ log(log(x)) + 0.2615.
+///
+double estimateCrossOffs(uint64_t start, uint64_t stop)
+{
+  double sqrtStop = sqrt((double) stop);
+  if (sqrtStop <= 19)
+    return 0;
+
+  double dist = (double) (stop - start);
+  double sumInverse = log(log(sqrtStop)) - log(log(19.0));
+  return dist * 8 / 30 * sumInverse;
+}
+
+void printPerfValue(const PerfCounters::Values& values, int event)
+{
+  if (values.available[event])
+    cout << values.counts[event];
+  else
+    cout << "n/a";
+}
+
+/// Print the hardware events (summed over all threads)
+/// and derived metrics, dist = sieved distance or 0
+/// if unknown.
+///
+void printPerf(const ParallelSieve& ps, uint64_t dist)
+{
+  auto& threads = ps.getPerfValues();
+  PerfCounters::Values sum;
+
+  for (auto& values : threads)
+    sum += values;
+
+  if (!sum.isAvailable())
+  {
+    cout << "Perf: not available, perf events are not supported or not "
+            "permitted (see /proc/sys/kernel/perf_event_paranoid)" << endl;
+    return;
+  }
+
+  for (int i = 0; i < PerfCounters::EVENTS; i++)
+  {
+    string name = PerfCounters::getName(i);
+    name += ": ";
+    cout << left << setw(16) << name << right;
+    printPerfValue(sum, i);
+
+    if (threads.size() > 1)
+    {
+      cout << " (";
+      for (size_t t = 0; t < threads.size(); t++)
+      {
+        cout << (t ? ", " : "");
+        printPerfValue(threads[t], i);
+      }
+      cout << ")";
+    }
+
+    cout << endl;
+  }
+
+  auto& counts = sum.counts;
+  auto& available = sum.available;
+  cout << fixed << setprecision(3);
+
+  if (available[PerfCounters::CYCLES] &&
+      available[PerfCounters::INSTRUCTIONS] &&
+      counts[PerfCounters::CYCLES] > 0)
+    cout << "Instructions per cycle: "
+         << (double) counts[PerfCounters::INSTRUCTIONS] / counts[PerfCounters::CYCLES] << endl;
+
+  // The sieve array uses 1 byte per 30 numbers
+  double bytes = dist / 30.0;
+  if (available[PerfCounters::CYCLES] && bytes >= 1)
+    cout << "Cycles per sieved byte: "
+         << counts[PerfCounters::CYCLES] / bytes << endl;
+
+  double crossOffs = estimateCrossOffs(ps.getStart(), ps.getStop());
+  if (dist > 0 && crossOffs >= 1)
+  {
+    for (int i : { PerfCounters::L1D_MISSES,
+                   PerfCounters::LLC_MISSES,
+                   PerfCounters::DTLB_MISSES,
+                   PerfCounters::BRANCH_MISSES })
+    {
+      if (available[i])
+        cout << PerfCounters::getName(i) << " per crossing-off: "
+             << counts[i] / crossOffs << endl;
+    }
+  }
+}
+
+/// Print the counts inside [start, x] for
+/// each multiple x of the table step.
+///
+void printTable(ParallelSieve& ps)
+{
+  uint64_t x = ps.getStart();
+
+  for (auto& counts : ps.getTable())
+  {
+    ps.getNextCheckpoint(&x);
+    cout << x;
+
+    for (int i = 0; i < 6; i++)
+      if (ps.isCount(i))
+        cout << ' ' << counts[i];
+
+    cout << '\n';
+    x++;
+  }
+
+  cout << flush;
+}
+
 /// Count & print primes and prime k-tuplets
 void sieve(CmdOptions& opt)
 {
@@ -47,8 +214,18 @@ void sieve(CmdOptions& opt)
     ps.setSieveSize(opt.sieveSize);
   if (opt.threads)
     ps.setNumThreads(opt.threads);
+  if (opt.sophieGermain)
+  {
+    // count or print the pairs (p, 2p + 1)
+    ps.setLinearForm(2, 1);
+    ps.setFlags(ps.isPrint() ? PRINT_PRIMES : COUNT_PRIMES);
+    if (opt.status)
+      ps.addFlags(PRINT_STATUS);
+  }
   if (ps.isPrint())
     ps.setNumThreads(1);
+  else if (opt.tableStep && !ps.isLinearForm())
+    ps.setTableStep(opt.tableStep);
   if (numbers.size() < 2)
     numbers.push_front(0);
 
@@ -57,6 +234,10 @@ void sieve(CmdOptions& opt)
 
   if (!opt.quiet)
     printSettings(ps);
+  if (opt.stats)
+    reset_sieve_stats();
+  if (opt.perf)
+    ps.setPerfCounters(true);
 
   ps.sieve();
 
@@ -70,14 +251,58 @@ void sieve(CmdOptions& opt)
     "Prime sextuplets: "
   };
 
+  if (ps.getTableStep())
+    printTable(ps);
+
   if (opt.time)
     printSeconds(ps.getSeconds());
+  if (opt.stats)
+    printStats();
+  if (opt.perf)
+    printPerf(ps, ps.getDistance());
+
+  if (ps.isLinearForm())
+  {
+    if (ps.isCountPrimes())
+      cout << "Sophie Germain primes: " << ps.getCount(0) << endl;
+    return;
+  }
 
   for (int i = 0; i < 6; i++)
     if (ps.isCount(i))
       cout << text[i] << ps.getCount(i) << endl;
 }
 
+/// Write the events recorded since Trace::start()
+void writeTrace(CmdOptions& opt)
+{
+  Trace::stop();
+  Trace::write(opt.traceFile);
+
+  if (!opt.quiet)
+  {
+    cout << "Trace: " << opt.traceFile << endl;
+    uint64_t dropped = Trace::getDropped();
+    if (dropped)
+      cout << "Trace: " << dropped << " old events overwritten" << endl;
+  }
+}
+
+/// Store the primes < 2^32 in a cache file
+void buildCache(CmdOptions& opt)
+{
+  auto t1 = chrono::system_clock::now();
+  build_sieving_primes_cache(opt.buildCacheFile);
+  auto t2 = chrono::system_clock::now();
+  chrono::duration<double> seconds = t2 - t1;
+
+  if (!opt.quiet)
+  {
+    cout << "Sieving primes cache: " << opt.buildCacheFile << endl;
+    printSeconds(seconds.count());
+  }
+}
+
 void nthPrime(CmdOptions& opt)
 {
   ParallelSieve ps;
@@ -100,11 +325,19 @@ void nthPrime(CmdOptions& opt)
 
   if (!opt.quiet)
     printSettings(ps);
+  if (opt.stats)
+    reset_sieve_stats();
+  if (opt.perf)
+    ps.setPerfCounters(true);
 
   nthPrime = ps.nthPrime(n, start);
 
   if (opt.time)
     printSeconds(ps.getSeconds());
+  if (opt.stats)
+    printStats();
+  if (opt.perf)
+    printPerf(ps, 0);
 
   cout << "Nth prime: " << nthPrime << endl;
 }
@@ -117,10 +350,35 @@ int main(int argc, char* argv[])
   {
     CmdOptions opt = parseOptions(argc, argv);
 
+    if (opt.tune)
+    {
+      tune(opt);
+      return 0;
+    }
+
+    if (!opt.buildCacheFile.empty())
+    {
+      buildCache(opt);
+      if (opt.numbers.empty())
+        return 0;
+    }
+
+    if (!opt.cacheFile.empty())
+      set_sieving_primes_cache(opt.cacheFile);
+
+    if (opt.sharedMemory)
+      set_shared_memory(true);
+
+    if (!opt.traceFile.empty())
+      Trace::start();
+
     if (opt.nthPrime)
       nthPrime(opt);
     else
       sieve(opt);
+
+    if (!opt.traceFile.empty())
+      writeTrace(opt);
   }
   catch (exception& e)
   {
@@ -0,0 +1,205 @@
+///
+/// @file   tune.cpp
+/// @brief  Find the fastest settings for the current CPU (option:
+///         --tune) and store them in the tuning profile which
+///         is read by libprimesieve on first use. The settings
+///         are tuned one after another by sieving near 10^10
+///         (small sieving primes), 10^14 (medium sieving primes)
+///         and 10^18 (large sieving primes).
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/CpuInfo.hpp>
+#include <primesieve/ParallelSieve.hpp>
+#include <primesieve/Profile.hpp>
+#include <primesieve/primesieve_error.hpp>
+#include "cmdoptions.hpp"
+
+#include <stdint.h>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace primesieve;
+
+namespace {
+
+struct Position
+{
+  uint64_t start;
+  uint64_t dist;
+};
+
+/// Each position takes about 0.5 seconds
+/// on a single CPU core (x64 2019).
+///
+const array<Position, 3> positions =
+{{
+  { (uint64_t) 1e10, (uint64_t) 2e9 },
+  { (uint64_t) 1e14, (uint64_t) 1e9 },
+  { (uint64_t) 1e18, (uint64_t) 5e8 }
+}};
+
+/// A setting is only changed if it is at least
+/// 1% faster, this avoids tuning noise.
+///
+const double minSpeedup = 1.01;
+
+/// Best of 2 runs, in seconds. ParallelSieve
+/// uses the sieve size and the number of
+/// threads of the current profile.
+///
+double sieveTime(const Position& pos, uint64_t scale)
+{
+  double best = 0;
+
+  for (int i = 0; i < 2; i++)
+  {
+    ParallelSieve ps;
+    auto t1 = chrono::steady_clock::now();
+    ps.sieve(pos.start, pos.start + pos.dist * scale, COUNT_PRIMES);
+    auto t2 = chrono::steady_clock::now();
+    chrono::duration<double> seconds = t2 - t1;
+
+    if (i == 0 || seconds.count() < best)
+      best = seconds.count();
+  }
+
+  return best;
+}
+
+/// Geometric mean of the sieving times of all
+/// positions using the profile's settings.
+/// @scale: Multiplies the sieving distance
+///
+double score(const Profile& profile, uint64_t scale)
+{
+  Profile::set(profile);
+  double logSum = 0;
+
+  for (auto& pos : positions)
+    logSum += log(sieveTime(pos, scale));
+
+  return exp(logSum / positions.size());
+}
+
+template <typename T>
+void printValue(const string& name, T value, const string& unit, double seconds)
+{
+  ostringstream setting;
+  setting << name << " = " << value << unit;
+  cout << "  " << left << setw(32) << setting.str() << right
+       << fixed << setprecision(3) << seconds << " sec" << endl;
+  cout << defaultfloat;
+}
+
+/// Try all values of the setting, the profile is
+/// updated with the fastest value.
+/// @bestTime: Time of the current profile (0 if unknown),
+///            updated with the time of the fastest value.
+///
+template <typename T>
+void tuneSetting(Profile& profile,
+                 T Profile::* setting,
+                 const vector<T>& values,
+                 const string& name,
+                 const string& unit,
+                 double& bestTime,
+                 uint64_t scale = 1)
+{
+  cout << "Tuning " << name << endl;
+
+  T current = profile.*setting;
+  T best = current;
+  if (bestTime <= 0)
+    bestTime = score(profile, scale);
+  printValue(name, current, unit, bestTime);
+
+  for (T value : values)
+  {
+    if (value == current)
+      continue;
+
+    Profile p = profile;
+    p.*setting = value;
+    double seconds = score(p, scale);
+    printValue(name, value, unit, seconds);
+
+    if (seconds * minSpeedup < bestTime)
+    {
+      best = value;
+      bestTime = seconds;
+    }
+  }
+
+  profile.*setting = best;
+  cout << "Best " << name << " = " << best << unit << endl;
+  cout << endl;
+}
+
+} // namespace
+
+void tune(const CmdOptions& opts)
+{
+  string filename = opts.profileFile;
+  if (filename.empty())
+    filename = Profile::getDefaultPath();
+  if (filename.empty())
+    throw primesieve_error("no default profile path, use --tune=FILE");
+
+  // Tune starting from the built-in defaults,
+  // the existing profile is ignored.
+  Profile profile;
+  Profile::set(profile);
+  profile.sieveSize = get_sieve_size();
+  profile.threads = 1;
+
+  cout << "Tuning primesieve for " << (cpuInfo.hasCpuName() ? cpuInfo.cpuName() : "unknown CPU") << endl;
+  cout << "This takes a few minutes..." << endl;
+  cout << endl;
+
+  vector<int> sieveSizes;
+  for (int size = 16; size <= 4096; size *= 2)
+    sieveSizes.push_back(size);
+
+  double defaultTime = score(profile, 1);
+  double tunedTime = defaultTime;
+  tuneSetting(profile, &Profile::sieveSize, sieveSizes, "sieve_size", " KiB", tunedTime);
+  tuneSetting(profile, &Profile::factorEratSmall, { 0.2, 0.3, 0.4, 0.6, 0.8, 1.0 }, "factor_erat_small", "", tunedTime);
+  tuneSetting(profile, &Profile::factorEratMedium, { 2.0, 3.0, 4.0, 5.0, 6.0, 8.0 }, "factor_erat_medium", "", tunedTime);
+  tuneSetting(profile, &Profile::bucketBytes, { 2048, 4096, 8192 }, "bucket_bytes", " B", tunedTime);
+
+  // With SMT (Hyper-Threading) using 1 thread per
+  // CPU core is sometimes faster than using all
+  // CPU threads. Each candidate sieves the same
+  // (larger) distance, 0 = all CPU threads.
+  int maxThreads = ParallelSieve::getMaxThreads();
+  profile.threads = 0;
+
+  if (maxThreads > 1 &&
+      cpuInfo.hasCpuCores() &&
+      (int) cpuInfo.cpuCores() < maxThreads)
+  {
+    double threadsTime = 0;
+    vector<int> threads = { (int) cpuInfo.cpuCores() };
+    tuneSetting(profile, &Profile::threads, threads, "threads", "", threadsTime, maxThreads);
+  }
+
+  Profile::set(profile);
+  profile.write(filename);
+
+  cout << "Single-threaded speedup over the defaults: " << fixed << setprecision(2)
+       << defaultTime / tunedTime << endl;
+  cout << "Profile: " << filename << endl;
+}
@@ -0,0 +1,248 @@
+///
+/// @file  decodePrimes.cpp
+///        Decode the 1 bits of the sieve array into primes.
+///
+///        The default kernel extracts one prime at a time using
+///        nextPrime() which needs a de Bruijn multiply and
+///        a loop with a hard to predict branch per prime. The x86
+///        kernels decode each 64-bit word in batches of 8 primes
+///        without branches: the bit index is found using TZCNT
+///        and the primes of a word with more than 8 primes are
+///        decoded using AVX-512 VPCOMPRESSQ, each byte of the word
+///        is the mask which selects its primes from the vector
+///        low + { 7, 11, 13, 17, 19, 23, 29, 31 }.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/decodePrimes.hpp>
+#include <primesieve/littleendian_cast.hpp>
+#include <primesieve/types.hpp>
+
+#include <stdint.h>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// The kernels use 64-bit intrinsics (TZCNT, BLSR,
+// POPCNT) which are not available on 32-bit x86.
+#if defined(__x86_64__) && \
+    (defined(__GNUC__) || \
+     defined(__clang__)) && \
+     defined(__has_include)
+  #if __has_include(<immintrin.h>)
+    #include <immintrin.h>
+    #define X86_KERNELS
+  #endif
+#endif
+
+using namespace std;
+
+namespace {
+
+using namespace primesieve;
+
+size_t decodeDefault(const byte_t* sieve,
+                     uint64_t* sieveIdx,
+                     uint64_t sieveSize,
+                     uint64_t* low,
+                     uint64_t* primes,
+                     size_t maxSize)
+{
+  size_t i = 0;
+  uint64_t idx = *sieveIdx;
+  uint64_t lowIdx = *low;
+
+  do
+  {
+    uint64_t bits = littleendian_cast<uint64_t>(&sieve[idx]);
+    idx += 8;
+
+    for (; bits != 0; i++)
+      primes[i] = nextPrime(&bits, lowIdx);
+
+    lowIdx += 8 * 30;
+  }
+  while (i <= maxSize && idx < sieveSize);
+
+  *sieveIdx = idx;
+  *low = lowIdx;
+  return i;
+}
+
+#if defined(X86_KERNELS)
+
+/// bitValues[i] = number of the i-th bit of a 64-bit word,
+/// TZCNT(0) = 64 is used for the unused batch slots.
+///
+const array<uint64_t, 65> bitValues =
+{
+    7,  11,  13,  17,  19,  23,  29,  31,
+   37,  41,  43,  47,  49,  53,  59,  61,
+   67,  71,  73,  77,  79,  83,  89,  91,
+   97, 101, 103, 107, 109, 113, 119, 121,
+  127, 131, 133, 137, 139, 143, 149, 151,
+  157, 161, 163, 167, 169, 173, 179, 181,
+  187, 191, 193, 197, 199, 203, 209, 211,
+  217, 221, 223, 227, 229, 233, 239, 241,
+    0
+};
+
+__attribute__ ((target ("bmi,popcnt")))
+size_t decodeBmi(const byte_t* sieve,
+                 uint64_t* sieveIdx,
+                 uint64_t sieveSize,
+                 uint64_t* low,
+                 uint64_t* primes,
+                 size_t maxSize)
+{
+  size_t i = 0;
+  uint64_t idx = *sieveIdx;
+  uint64_t lowIdx = *low;
+
+  do
+  {
+    uint64_t bits = littleendian_cast<uint64_t>(&sieve[idx]);
+    uint64_t* out = &primes[i];
+    i += _mm_popcnt_u64(bits);
+    idx += 8;
+
+    // Decode 8 primes per iteration without branches,
+    // the slots after the last prime are overwritten
+    // by the next word.
+    do
+    {
+      for (int j = 0; j < 8; j++)
+      {
+        out[j] = lowIdx + bitValues[_tzcnt_u64(bits)];
+        bits = _blsr_u64(bits);
+      }
+      out += 8;
+    }
+    while (bits != 0);
+
+    lowIdx += 8 * 30;
+  }
+  while (i <= maxSize && idx < sieveSize);
+
+  *sieveIdx = idx;
+  *low = lowIdx;
+  return i;
+}
+
+__attribute__ ((target ("avx512f,bmi,popcnt")))
+size_t decodeAvx512(const byte_t* sieve,
+                    uint64_t* sieveIdx,
+                    uint64_t sieveSize,
+                    uint64_t* low,
+                    uint64_t* primes,
+                    size_t maxSize)
+{
+  size_t i = 0;
+  uint64_t idx = *sieveIdx;
+  uint64_t lowIdx = *low;
+  const __m512i wheel = _mm512_setr_epi64(7, 11, 13, 17, 19, 23, 29, 31);
+  const __m512i byteDist = _mm512_set1_epi64(30);
+
+  do
+  {
+    uint64_t bits = littleendian_cast<uint64_t>(&sieve[idx]);
+    uint64_t* out = &primes[i];
+    size_t count = _mm_popcnt_u64(bits);
+    i += count;
+    idx += 8;
+
+    // Few primes (large numbers), TZCNT is faster
+    if (count <= 8)
+    {
+      for (int j = 0; j < 8; j++)
+      {
+        out[j] = lowIdx + bitValues[_tzcnt_u64(bits)];
+        bits = _blsr_u64(bits);
+      }
+    }
+    else
+    {
+      __m512i numbers = _mm512_add_epi64(_mm512_set1_epi64(lowIdx), wheel);
+
+      // Each byte of the word selects its
+      // primes from 8 consecutive numbers
+      for (int j = 0; j < 8; j++)
+      {
+        __mmask8 mask = (__mmask8) (bits >> (j * 8));
+        __m512i vprimes = _mm512_maskz_compress_epi64(mask, numbers);
+        _mm512_storeu_si512((__m512i*) out, vprimes);
+        out += _mm_popcnt_u32(mask);
+        numbers = _mm512_add_epi64(numbers, byteDist);
+      }
+    }
+
+    lowIdx += 8 * 30;
+  }
+  while (i <= maxSize && idx < sieveSize);
+
+  *sieveIdx = idx;
+  *low = lowIdx;
+  return i;
+}
+
+#endif
+
+decodePrimes_t getDecoder()
+{
+  return getDecodeKernels().front().decode;
+}
+
+} // namespace
+
+namespace primesieve {
+
+const array<uint64_t, 64> bruijnBitValues =
+{
+    7,  47,  11,  49,  67, 113,  13,  53,
+   89,  71, 161, 101, 119, 187,  17, 233,
+   59,  79,  91,  73, 133, 139, 163, 103,
+  149, 121, 203, 169, 191, 217,  19, 239,
+   43,  61, 109,  83, 157,  97, 181, 229,
+   77, 131, 137, 143, 199, 167, 211,  41,
+  107, 151, 179, 227, 127, 197, 209,  37,
+  173, 223, 193,  31, 221,  29,  23, 241
+};
+
+vector<DecodeKernel> getDecodeKernels()
+{
+  vector<DecodeKernel> kernels;
+
+#if defined(X86_KERNELS)
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx512f") &&
+      __builtin_cpu_supports("bmi") &&
+      __builtin_cpu_supports("popcnt"))
+    kernels.push_back({ "avx512", decodeAvx512 });
+
+  if (__builtin_cpu_supports("bmi") &&
+      __builtin_cpu_supports("popcnt"))
+    kernels.push_back({ "bmi", decodeBmi });
+#endif
+
+  kernels.push_back({ "default", decodeDefault });
+
+  return kernels;
+}
+
+size_t decodePrimes(const byte_t* sieve,
+                    uint64_t* sieveIdx,
+                    uint64_t sieveSize,
+                    uint64_t* low,
+                    uint64_t* primes,
+                    size_t maxSize)
+{
+  static const decodePrimes_t decode = getDecoder();
+  return decode(sieve, sieveIdx, sieveSize, low, primes, maxSize);
+}
+
+} // namespace
@@ -9,11 +9,14 @@
 ///
 
 #include <primesieve.h>
+#include <primesieve/config.hpp>
 #include <primesieve/IteratorHelper.hpp>
+#include <primesieve/PrevPrimeGenerator.hpp>
 #include <primesieve/PrimeGenerator.hpp>
 #include <primesieve/types.hpp>
 
 #include <stdint.h>
+#include <algorithm>
 #include <cerrno>
 #include <exception>
 #include <vector>
@@ -35,6 +38,28 @@ void clearPrimeGenerator(primesieve_iterator* it)
   it->primeGenerator = nullptr;
 }
 
+PrevPrimeGenerator* getPrevPrimeGenerator(primesieve_iterator* it)
+{
+  return (PrevPrimeGenerator*) it->prevPrimeGenerator;
+}
+
+void clearPrevPrimeGenerator(primesieve_iterator* it)
+{
+  delete getPrevPrimeGenerator(it);
+  it->prevPrimeGenerator = nullptr;
+}
+
+ChunkPolicy* getChunkPolicy(primesieve_iterator* it)
+{
+  return (ChunkPolicy*) it->chunkPolicy;
+}
+
+void clearChunkPolicy(primesieve_iterator* it)
+{
+  delete getChunkPolicy(it);
+  it->chunkPolicy = nullptr;
+}
+
 vector<uint64_t>& getPrimes(primesieve_iterator* it)
 {
   using T = vector<uint64_t>;
@@ -53,8 +78,12 @@ void primesieve_init(primesieve_iterator* it)
   it->i = 0;
   it->last_idx = 0;
   it->dist = 0;
+  it->skipto = 0;
+  it->mode = IteratorState::FRESH;
   it->vector = new vector<uint64_t>;
   it->primeGenerator = nullptr;
+  it->prevPrimeGenerator = nullptr;
+  it->chunkPolicy = nullptr;
   it->is_error = false;
 }
 
@@ -62,15 +91,148 @@ void primesieve_skipto(primesieve_iterator* it,
                        uint64_t start,
                        uint64_t stop_hint)
 {
-  it->start = start;
-  it->stop = start;
+  auto& primes = getPrimes(it);
+  size_t size = 0;
+
+  // number of buffered primes
+  if (it->skipto)
+    size = primes.size();
+  else if (!primes.empty())
+    size = it->last_idx + 1;
+
   it->stop_hint = stop_hint;
   it->i = 0;
   it->last_idx = 0;
+
+  // If start is inside the buffered primes or if the
+  // current PrimeGenerator can be moved forward up to
+  // start, the primes are generated from the current
+  // state once the direction (next or prev) is known.
+  if (size > 0 &&
+      primes[0] < start &&
+      (start < primes[size - 1] ||
+      (it->primeGenerator && IteratorHelper::isFastForward(primes[size - 1], start, it->stop))))
+  {
+    it->skipto = start;
+    primes.resize(size);
+    it->primes = &primes[0];
+    return;
+  }
+
+  // PrimeGenerator and PrevPrimeGenerator
+  // are kept, they reuse their memory.
+  it->skipto = 0;
+  it->mode = IteratorState::FRESH;
+  it->start = start;
+  it->stop = start;
   it->dist = 0;
+  primes.clear();
+}
+
+void primesieve_save_state(primesieve_iterator* it, uint8_t* bytes)
+{
+  auto& primes = getPrimes(it);
+  IteratorState::save(bytes, it->mode, it->start, it->stop, it->stop_hint,
+                      it->dist, it->skipto, primes.data(), it->i);
+}
+
+/// The primes of the current interval are regenerated
+/// starting from the saved position, the sieving primes
+/// and the interval distance are the same as before.
+///
+void primesieve_restore_state(primesieve_iterator* it, const uint8_t* bytes)
+{
   auto& primes = getPrimes(it);
+  IteratorState state;
+
+  try
+  {
+    state.load(bytes);
+  }
+  catch (exception&)
+  {
+    it->is_error = true;
+    errno = EDOM;
+    return;
+  }
+
+  uint64_t pos = state.position;
+  it->start = state.start;
+  it->stop = state.stop;
+  it->stop_hint = state.stopHint;
+  it->dist = state.dist;
+  it->skipto = 0;
+  it->mode = state.mode;
+  it->i = 0;
+  it->last_idx = 0;
   primes.clear();
-  clearPrimeGenerator(it);
+
+  if (state.mode == IteratorState::FRESH)
+    return;
+
+  // The saved position is the current prime
+  primes.resize(config::ITERATOR_BUFFER_SIZE);
+  primes[0] = pos;
+  it->primes = &primes[0];
+
+  try
+  {
+    if (state.mode == IteratorState::NEXT)
+    {
+      // Without PrimeGenerator the next interval
+      // starts at pos + 1
+      if (pos >= it->stop)
+        clearPrimeGenerator(it);
+      else if (it->primeGenerator)
+        getPrimeGenerator(it)->init(pos + 1, it->stop);
+      else
+        it->primeGenerator = new PrimeGenerator(pos + 1, it->stop);
+    }
+    else
+    {
+      clearPrimeGenerator(it);
+
+      if (!it->prevPrimeGenerator)
+        it->prevPrimeGenerator = new PrevPrimeGenerator;
+
+      // [1, 0] is an empty interval, the next
+      // interval is below it->start
+      if (pos > it->start)
+        getPrevPrimeGenerator(it)->init(it->start, pos - 1);
+      else
+        getPrevPrimeGenerator(it)->init(1, 0);
+    }
+  }
+  catch (exception&)
+  {
+    clearPrimeGenerator(it);
+    clearPrevPrimeGenerator(it);
+    primes[0] = PRIMESIEVE_ERROR;
+    it->is_error = true;
+    errno = EDOM;
+  }
+}
+
+void primesieve_iterator_set_max_memory(primesieve_iterator* it,
+                                        uint64_t max_memory)
+{
+  clearChunkPolicy(it);
+
+  if (max_memory)
+    it->chunkPolicy = new ChunkPolicy(max_memory);
+}
+
+uint64_t primesieve_iterator_memory_usage(primesieve_iterator* it)
+{
+  auto& primes = getPrimes(it);
+  uint64_t bytes = primes.capacity() * sizeof(uint64_t);
+
+  if (it->primeGenerator)
+    bytes += getPrimeGenerator(it)->getMemoryUsage();
+  if (it->prevPrimeGenerator)
+    bytes += getPrevPrimeGenerator(it)->getMemoryUsage();
+
+  return bytes;
 }
 
 /// C destructor
@@ -79,6 +241,8 @@ void primesieve_free_iterator(primesieve_iterator* it)
   if (it)
   {
     clearPrimeGenerator(it);
+    clearPrevPrimeGenerator(it);
+    clearChunkPolicy(it);
     auto* primes = &getPrimes(it);
     delete primes;
   }
@@ -87,77 +251,218 @@ void primesieve_free_iterator(primesieve_iterator* it)
 void primesieve_generate_next_primes(primesieve_iterator* it)
 {
   auto& primes = getPrimes(it);
-  auto primeGenerator = getPrimeGenerator(it);
+  uint64_t start = 0;
+  bool isNewInterval = primes.empty();
+  auto chunkPolicy = getChunkPolicy(it);
+  it->mode = IteratorState::NEXT;
+
+  if (chunkPolicy)
+    chunkPolicy->startSieve();
 
   try
   {
-    while (true)
+    if (it->skipto)
     {
-      if (!it->primeGenerator)
+      start = it->skipto;
+      it->skipto = 0;
+      size_t size = primes.size();
+      primes.resize(config::ITERATOR_BUFFER_SIZE);
+      it->primes = &primes[0];
+
+      // start is inside the buffered primes
+      if (start < primes[size - 1])
       {
-        IteratorHelper::next(&it->start, &it->stop, it->stop_hint, &it->dist);
-        it->primeGenerator = new PrimeGenerator(it->start, it->stop);
-        primeGenerator = getPrimeGenerator(it);
-        primes.resize(64);
+        auto first = primes.begin();
+        it->i = upper_bound(first, first + size, start) - first;
+        it->last_idx = size - 1;
+        return;
+      }
+
+      // the primes < start are not extracted
+      getPrimeGenerator(it)->skipto(start);
+    }
+    // switching from prev_prime() to next_prime(), the
+    // current block is only part of the interval.
+    else if (!it->primeGenerator && !isNewInterval)
+    {
+      it->stop = primes[it->last_idx];
+      isNewInterval = true;
+    }
+
+    do
+    {
+      if (isNewInterval)
+      {
+        if (chunkPolicy)
+          chunkPolicy->newInterval();
+
+        IteratorHelper::next(&it->start, &it->stop, it->stop_hint, &it->dist, chunkPolicy);
+
+        // reuse the sieve array and bucket memory
+        if (it->primeGenerator)
+          getPrimeGenerator(it)->init(it->start, it->stop);
+        else
+          it->primeGenerator = new PrimeGenerator(it->start, it->stop);
+
+        primes.resize(config::ITERATOR_BUFFER_SIZE);
         it->primes = &primes[0];
       }
 
+      auto primeGenerator = getPrimeGenerator(it);
+
       for (it->last_idx = 0; !it->last_idx;)
         primeGenerator->fill(primes, &it->last_idx);
 
-      if (primeGenerator->finished())
-        clearPrimeGenerator(it);
-      else
-        break;
+      isNewInterval = primeGenerator->finished();
     }
+    while (isNewInterval ||
+           primes[it->last_idx - 1] <= start);
   }
   catch (exception&)
   {
     clearPrimeGenerator(it);
     primes.resize(1);
     primes[0] = PRIMESIEVE_ERROR;
+    it->primes = &primes[0];
     it->last_idx = 1;
     it->is_error = true;
     errno = EDOM;
+    start = 0;
   }
 
   it->i = 0;
   it->last_idx--;
+
+  if (chunkPolicy)
+    chunkPolicy->stopSieve();
+
+  // skip the primes <= start
+  if (start)
+  {
+    auto first = primes.begin();
+    it->i = upper_bound(first, first + it->last_idx, start) - first;
+  }
 }
 
 void primesieve_generate_prev_primes(primesieve_iterator* it)
 {
   auto& primes = getPrimes(it);
+  size_t size = 0;
+  auto chunkPolicy = getChunkPolicy(it);
+  // A restored iterator at the stop number of its
+  // interval has no PrimeGenerator.
+  bool isNext = (it->mode == IteratorState::NEXT);
+  it->mode = IteratorState::PREV;
+
+  if (chunkPolicy)
+    chunkPolicy->startSieve();
 
   try
   {
-    if (it->primeGenerator)
-      it->start = primes.front();
+    if (it->skipto)
+    {
+      uint64_t start = it->skipto;
+      it->skipto = 0;
+      size = primes.size();
+      primes.resize(config::ITERATOR_BUFFER_SIZE);
+      it->primes = &primes[0];
 
-    primes.clear();
-    clearPrimeGenerator(it);
+      // start is inside the buffered primes
+      if (start < primes[size - 1])
+      {
+        auto first = primes.begin();
+        it->i = lower_bound(first, first + size, start) - first - 1;
+        it->last_idx = size - 1;
+        return;
+      }
 
-    while (primes.empty())
+      // PrimeGenerator cannot move backwards
+      it->start = start;
+      it->dist = 0;
+      primes.clear();
+      size = 0;
+    }
+
+    bool isNewInterval = primes.empty();
+
+    // switching from next_prime() to prev_prime()
+    if (isNext || it->primeGenerator)
     {
-      IteratorHelper::prev(&it->start, &it->stop, it->stop_hint, &it->dist);
-      it->primeGenerator = new PrimeGenerator(it->start, it->stop);
-      auto primeGenerator = getPrimeGenerator(it);
-      if (it->start <= 2)
-        primes.push_back(0);
-      primeGenerator->fill(primes);
+      if (!isNewInterval)
+        it->start = primes.front();
       clearPrimeGenerator(it);
+      isNewInterval = true;
+    }
+
+    // PrevPrimeGenerator keeps its sieving
+    // primes between the intervals
+    if (!it->prevPrimeGenerator)
+    {
+      it->prevPrimeGenerator = new PrevPrimeGenerator;
+      isNewInterval = true;
+    }
+
+    auto prevPrimeGenerator = getPrevPrimeGenerator(it);
+    primes.resize(config::ITERATOR_BUFFER_SIZE);
+
+    while (!size)
+    {
+      if (isNewInterval ||
+          prevPrimeGenerator->finished())
+      {
+        if (chunkPolicy)
+          chunkPolicy->newInterval();
+
+        IteratorHelper::prev(&it->start, &it->stop, it->stop_hint, &it->dist, chunkPolicy);
+        prevPrimeGenerator->init(it->start, it->stop);
+        isNewInterval = false;
+      }
+
+      prevPrimeGenerator->fill(primes, &size);
     }
   }
   catch (exception&)
   {
-    clearPrimeGenerator(it);
+    clearPrevPrimeGenerator(it);
     primes.resize(1);
     primes[0] = PRIMESIEVE_ERROR;
+    size = 1;
     it->is_error = true;
     errno = EDOM;
   }
 
   it->primes = &primes[0];
-  it->last_idx = primes.size() - 1;
+  it->last_idx = size - 1;
+  it->i = it->last_idx;
+
+  if (chunkPolicy)
+    chunkPolicy->stopSieve();
+}
+
+const uint64_t* primesieve_next_primes(primesieve_iterator* it, size_t* size)
+{
+  // all buffered primes have been returned
+  if (it->i == it->last_idx)
+    primesieve_generate_next_primes(it);
+  else
+    it->i++;
+
+  size_t first = it->i;
+  *size = it->last_idx - first + 1;
   it->i = it->last_idx;
+  return &it->primes[first];
+}
+
+const uint64_t* primesieve_prev_primes(primesieve_iterator* it, size_t* size)
+{
+  if (it->i == 0)
+  {
+    primesieve_generate_prev_primes(it);
+    *size = it->i + 1;
+  }
+  else
+    *size = it->i;
+
+  it->i = 0;
+  return &it->primes[0];
 }
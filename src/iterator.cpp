@@ -8,10 +8,15 @@
 ///
 
 #include <primesieve/iterator.hpp>
+#include <primesieve/config.hpp>
 #include <primesieve/IteratorHelper.hpp>
+#include <primesieve/PrevPrimeGenerator.hpp>
 #include <primesieve/PrimeGenerator.hpp>
+#include <primesieve/primesieve_error.hpp>
 
 #include <stdint.h>
+#include <algorithm>
+#include <cstddef>
 #include <vector>
 #include <memory>
 
@@ -34,7 +39,9 @@ iterator::iterator(iterator&&) noexcept = default;
 iterator& iterator::operator=(iterator&&) noexcept = default;
 
 iterator::iterator(uint64_t start,
-                   uint64_t stop_hint)
+                   uint64_t stop_hint) :
+  skipto_(0),
+  mode_(IteratorState::FRESH)
 {
   skipto(start, stop_hint);
 }
@@ -42,61 +49,306 @@ iterator::iterator(uint64_t start,
 void iterator::skipto(uint64_t start,
                       uint64_t stop_hint)
 {
-  start_ = start;
-  stop_ = start;
+  std::size_t size = 0;
+
+  // number of buffered primes
+  if (skipto_)
+    size = primes_.size();
+  else if (!primes_.empty())
+    size = last_idx_ + 1;
+
   stop_hint_ = stop_hint;
   i_ = 0;
   last_idx_ = 0;
+
+  // If start is inside the buffered primes or if the
+  // current PrimeGenerator can be moved forward up to
+  // start, the primes are generated from the current
+  // state once the direction (next or prev) is known.
+  if (size > 0 &&
+      primes_[0] < start &&
+      (start < primes_[size - 1] ||
+      (primeGenerator_ && IteratorHelper::isFastForward(primes_[size - 1], start, stop_))))
+  {
+    skipto_ = start;
+    primes_.resize(size);
+    return;
+  }
+
+  // PrimeGenerator and PrevPrimeGenerator
+  // are kept, they reuse their memory.
+  skipto_ = 0;
+  mode_ = IteratorState::FRESH;
+  start_ = start;
+  stop_ = start;
   dist_ = 0;
-  clear(primeGenerator_);
   primes_.clear();
 }
 
+std::vector<uint8_t> iterator::save_state() const
+{
+  std::vector<uint8_t> bytes(IteratorState::SIZE);
+  IteratorState::save(&bytes[0], mode_, start_, stop_, stop_hint_,
+                      dist_, skipto_, primes_.data(), i_);
+  return bytes;
+}
+
+/// The primes of the current interval are regenerated
+/// starting from the saved position, the sieving primes
+/// and the interval distance are the same as before.
+///
+void iterator::restore_state(const std::vector<uint8_t>& bytes)
+{
+  if (bytes.size() != IteratorState::SIZE)
+    throw primesieve_error("invalid iterator state");
+
+  IteratorState state;
+  state.load(&bytes[0]);
+  uint64_t pos = state.position;
+
+  start_ = state.start;
+  stop_ = state.stop;
+  stop_hint_ = state.stopHint;
+  dist_ = state.dist;
+  skipto_ = 0;
+  mode_ = state.mode;
+  i_ = 0;
+  last_idx_ = 0;
+  primes_.clear();
+
+  if (state.mode == IteratorState::FRESH)
+    return;
+
+  // The saved position is the current prime
+  primes_.resize(config::ITERATOR_BUFFER_SIZE);
+  primes_[0] = pos;
+
+  if (state.mode == IteratorState::NEXT)
+  {
+    // Without PrimeGenerator the next interval
+    // starts at pos + 1
+    if (pos >= stop_)
+      clear(primeGenerator_);
+    else if (primeGenerator_)
+      primeGenerator_->init(pos + 1, stop_);
+    else
+      primeGenerator_.reset(new PrimeGenerator(pos + 1, stop_));
+  }
+  else
+  {
+    clear(primeGenerator_);
+
+    if (!prevPrimeGenerator_)
+      prevPrimeGenerator_.reset(new PrevPrimeGenerator);
+
+    // [1, 0] is an empty interval, the next
+    // interval is below start_
+    if (pos > start_)
+      prevPrimeGenerator_->init(start_, pos - 1);
+    else
+      prevPrimeGenerator_->init(1, 0);
+  }
+}
+
+void iterator::set_max_memory(uint64_t max_memory)
+{
+  if (max_memory)
+    chunkPolicy_.reset(new ChunkPolicy(max_memory));
+  else
+    clear(chunkPolicy_);
+}
+
+uint64_t iterator::memory_usage() const
+{
+  uint64_t bytes = primes_.capacity() * sizeof(uint64_t);
+
+  if (primeGenerator_)
+    bytes += primeGenerator_->getMemoryUsage();
+  if (prevPrimeGenerator_)
+    bytes += prevPrimeGenerator_->getMemoryUsage();
+
+  return bytes;
+}
+
+const uint64_t* iterator::next_primes(std::size_t* size)
+{
+  // all buffered primes have been returned
+  if (i_ == last_idx_)
+    generate_next_primes();
+  else
+    i_++;
+
+  std::size_t first = i_;
+  *size = last_idx_ - first + 1;
+  i_ = last_idx_;
+  return &primes_[first];
+}
+
+const uint64_t* iterator::prev_primes(std::size_t* size)
+{
+  if (i_ == 0)
+  {
+    generate_prev_primes();
+    *size = i_ + 1;
+  }
+  else
+    *size = i_;
+
+  i_ = 0;
+  return &primes_[0];
+}
+
 void iterator::generate_next_primes()
 {
-  while (true)
+  uint64_t start = 0;
+  bool isNewInterval = primes_.empty();
+  mode_ = IteratorState::NEXT;
+
+  if (chunkPolicy_)
+    chunkPolicy_->startSieve();
+
+  if (skipto_)
   {
-    if (!primeGenerator_)
+    start = skipto_;
+    skipto_ = 0;
+    std::size_t size = primes_.size();
+    primes_.resize(config::ITERATOR_BUFFER_SIZE);
+
+    // start is inside the buffered primes
+    if (start < primes_[size - 1])
     {
-      IteratorHelper::next(&start_, &stop_, stop_hint_, &dist_);
-      auto p = new PrimeGenerator(start_, stop_);
-      primeGenerator_.reset(p);
-      primes_.resize(64);
+      auto first = primes_.begin();
+      i_ = upper_bound(first, first + size, start) - first;
+      last_idx_ = size - 1;
+      return;
+    }
+
+    // the primes < start are not extracted
+    primeGenerator_->skipto(start);
+  }
+  // switching from prev_prime() to next_prime(), the
+  // current block is only part of the interval.
+  else if (!primeGenerator_ && !isNewInterval)
+  {
+    stop_ = primes_[last_idx_];
+    isNewInterval = true;
+  }
+
+  do
+  {
+    if (isNewInterval)
+    {
+      if (chunkPolicy_)
+        chunkPolicy_->newInterval();
+
+      IteratorHelper::next(&start_, &stop_, stop_hint_, &dist_, chunkPolicy_.get());
+
+      // reuse the sieve array and bucket memory
+      if (primeGenerator_)
+        primeGenerator_->init(start_, stop_);
+      else
+        primeGenerator_.reset(new PrimeGenerator(start_, stop_));
+
+      primes_.resize(config::ITERATOR_BUFFER_SIZE);
     }
 
     for (last_idx_ = 0; !last_idx_;)
       primeGenerator_->fill(primes_, &last_idx_);
 
-    if (primeGenerator_->finished())
-      clear(primeGenerator_);
-    else
-      break;
+    isNewInterval = primeGenerator_->finished();
   }
+  while (isNewInterval ||
+         primes_[last_idx_ - 1] <= start);
 
   i_ = 0;
   last_idx_--;
+
+  if (chunkPolicy_)
+    chunkPolicy_->stopSieve();
+
+  // skip the primes <= start
+  if (start)
+  {
+    auto first = primes_.begin();
+    i_ = upper_bound(first, first + last_idx_, start) - first;
+  }
 }
 
 void iterator::generate_prev_primes()
 {
-  if (primeGenerator_)
-    start_ = primes_.front();
+  // A restored iterator at the stop number of its
+  // interval has no PrimeGenerator.
+  bool isNext = (mode_ == IteratorState::NEXT);
+  mode_ = IteratorState::PREV;
 
-  primes_.clear();
+  if (chunkPolicy_)
+    chunkPolicy_->startSieve();
+
+  if (skipto_)
+  {
+    uint64_t start = skipto_;
+    skipto_ = 0;
+    std::size_t size = primes_.size();
+    primes_.resize(config::ITERATOR_BUFFER_SIZE);
+
+    // start is inside the buffered primes
+    if (start < primes_[size - 1])
+    {
+      auto first = primes_.begin();
+      i_ = lower_bound(first, first + size, start) - first - 1;
+      last_idx_ = size - 1;
+      return;
+    }
+
+    // PrimeGenerator cannot move backwards
+    start_ = start;
+    dist_ = 0;
+    primes_.clear();
+  }
+
+  bool isNewInterval = primes_.empty();
 
-  while (primes_.empty())
+  // switching from next_prime() to prev_prime()
+  if (isNext || primeGenerator_)
   {
-    IteratorHelper::prev(&start_, &stop_, stop_hint_, &dist_);
-    if (start_ <= 2)
-      primes_.push_back(0);
-    auto p = new PrimeGenerator(start_, stop_);
-    primeGenerator_.reset(p);
-    primeGenerator_->fill(primes_);
+    if (!isNewInterval)
+      start_ = primes_.front();
     clear(primeGenerator_);
+    isNewInterval = true;
   }
 
-  last_idx_ = primes_.size() - 1;
+  // PrevPrimeGenerator keeps its sieving
+  // primes between the intervals
+  if (!prevPrimeGenerator_)
+  {
+    prevPrimeGenerator_.reset(new PrevPrimeGenerator);
+    isNewInterval = true;
+  }
+
+  primes_.resize(config::ITERATOR_BUFFER_SIZE);
+  std::size_t size = 0;
+
+  while (!size)
+  {
+    if (isNewInterval ||
+        prevPrimeGenerator_->finished())
+    {
+      if (chunkPolicy_)
+        chunkPolicy_->newInterval();
+
+      IteratorHelper::prev(&start_, &stop_, stop_hint_, &dist_, chunkPolicy_.get());
+      prevPrimeGenerator_->init(start_, stop_);
+      isNewInterval = false;
+    }
+
+    prevPrimeGenerator_->fill(primes_, &size);
+  }
+
+  last_idx_ = size - 1;
   i_ = last_idx_;
+
+  if (chunkPolicy_)
+    chunkPolicy_->stopSieve();
 }
 
 } // namespace
@@ -8,6 +8,7 @@
 ///
 
 #include <primesieve/iterator.hpp>
+#include <primesieve/PrimeBitmap.hpp>
 #include <primesieve/PrimeSieve.hpp>
 #include <primesieve/pmath.hpp>
 #include <primesieve/primesieve_error.hpp>
@@ -94,6 +95,37 @@ uint64_t nthPrimeDist(int64_t n, int64_t count, uint64_t start)
   return (uint64_t) dist;
 }
 
+/// Small nth primes are looked up in PrimeBitmap.
+/// @return false if the nth prime >= PrimeBitmap::MAX.
+///
+bool nthPrimeBitmap(int64_t n, uint64_t start, uint64_t* prime)
+{
+  int64_t maxN = (int64_t) PrimeBitmap::primePi(PrimeBitmap::MAX - 1);
+
+  if (start >= PrimeBitmap::MAX ||
+      n > maxN ||
+      n < -maxN)
+    return false;
+
+  int64_t i = 0;
+
+  // nth prime >= start
+  if (n == 0)
+    i = (start > 0) ? (int64_t) PrimeBitmap::primePi(start - 1) + 1 : 1;
+  // nth prime > start
+  else if (n > 0)
+    i = (int64_t) PrimeBitmap::primePi(start) + n;
+  // nth prime < start
+  else if (start > 0)
+    i = (int64_t) PrimeBitmap::primePi(start - 1) + n + 1;
+
+  if (i < 1 || i > maxN)
+    return false;
+
+  *prime = PrimeBitmap::nthPrime(i);
+  return true;
+}
+
 } // namespace
 
 namespace primesieve {
@@ -107,6 +139,15 @@ uint64_t PrimeSieve::nthPrime(int64_t n, uint64_t start)
 {
   setStart(start);
   auto t1 = chrono::system_clock::now();
+  uint64_t smallPrime = 0;
+
+  if (nthPrimeBitmap(n, start, &smallPrime))
+  {
+    auto t2 = chrono::system_clock::now();
+    chrono::duration<double> seconds = t2 - t1;
+    seconds_ = seconds.count();
+    return smallPrime;
+  }
 
   if (n == 0)
     n = 1; // like Mathematica
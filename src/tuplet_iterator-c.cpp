@@ -0,0 +1,152 @@
+///
+/// @file   tuplet_iterator-c.cpp
+/// @brief  C port of primesieve::tuplet_iterator.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.h>
+#include <primesieve/config.hpp>
+#include <primesieve/IteratorHelper.hpp>
+#include <primesieve/TupletGenerator.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cerrno>
+#include <exception>
+#include <limits>
+#include <vector>
+
+using namespace std;
+using namespace primesieve;
+
+namespace {
+
+TupletGenerator* getTupletGenerator(primesieve_tuplet_iterator* it)
+{
+  // tupletGenerator is a pimpl
+  return (TupletGenerator*) it->tupletGenerator;
+}
+
+void clearTupletGenerator(primesieve_tuplet_iterator* it)
+{
+  delete getTupletGenerator(it);
+  it->tupletGenerator = nullptr;
+}
+
+vector<uint64_t>& getTuplets(primesieve_tuplet_iterator* it)
+{
+  using T = vector<uint64_t>;
+  T* tuplets = (T*) it->vector;
+  return *tuplets;
+}
+
+} // namespace
+
+/// C constructor
+void primesieve_init_tuplet_iterator(primesieve_tuplet_iterator* it, int k)
+{
+  it->start = 0;
+  it->stop = 0;
+  it->stop_hint = primesieve_get_max_stop();
+  it->i = 0;
+  it->size = 0;
+  it->k = k;
+  it->dist = 0;
+  it->tuplets = nullptr;
+  it->vector = new vector<uint64_t>;
+  it->tupletGenerator = nullptr;
+  it->is_error = false;
+}
+
+/// TupletGenerator is kept, it reuses its memory
+void primesieve_skipto_tuplet(primesieve_tuplet_iterator* it,
+                              uint64_t start,
+                              uint64_t stop_hint)
+{
+  it->start = start;
+  it->stop = start;
+  it->stop_hint = stop_hint;
+  it->i = 0;
+  it->size = 0;
+  it->dist = 0;
+  getTuplets(it).clear();
+}
+
+/// C destructor
+void primesieve_free_tuplet_iterator(primesieve_tuplet_iterator* it)
+{
+  if (it)
+  {
+    clearTupletGenerator(it);
+    auto* tuplets = &getTuplets(it);
+    delete tuplets;
+  }
+}
+
+void primesieve_generate_next_tuplets(primesieve_tuplet_iterator* it)
+{
+  auto& tuplets = getTuplets(it);
+  uint64_t maxStop = numeric_limits<uint64_t>::max();
+
+  try
+  {
+    bool isNewInterval = tuplets.empty();
+    tuplets.resize(config::ITERATOR_BUFFER_SIZE * max(it->k, 1));
+    it->tuplets = &tuplets[0];
+
+    if (!it->tupletGenerator)
+      it->tupletGenerator = new TupletGenerator(it->k);
+
+    auto tupletGenerator = getTupletGenerator(it);
+
+    for (it->size = 0; !it->size;)
+    {
+      if (isNewInterval ||
+          tupletGenerator->finished())
+      {
+        // no more k-tuplets < 2^64
+        if (it->stop == maxStop && !isNewInterval)
+        {
+          fill_n(tuplets.begin(), it->k, maxStop);
+          it->size = it->k;
+          break;
+        }
+
+        IteratorHelper::next(&it->start, &it->stop, it->stop_hint, &it->dist);
+        it->stop = TupletGenerator::alignStop(it->stop);
+        tupletGenerator->init(it->start, it->stop);
+        isNewInterval = false;
+      }
+
+      tupletGenerator->fill(tuplets, &it->size);
+    }
+  }
+  catch (exception&)
+  {
+    clearTupletGenerator(it);
+    it->k = max(it->k, 1);
+    tuplets.assign(it->k, PRIMESIEVE_ERROR);
+    it->tuplets = &tuplets[0];
+    it->size = it->k;
+    it->is_error = true;
+    errno = EDOM;
+  }
+
+  it->i = 0;
+}
+
+const uint64_t* primesieve_next_tuplets(primesieve_tuplet_iterator* it, size_t* size)
+{
+  // all buffered k-tuplets have been returned
+  if (it->i == it->size)
+    primesieve_generate_next_tuplets(it);
+
+  size_t first = it->i;
+  *size = (it->size - first) / it->k;
+  it->i = it->size;
+  return &it->tuplets[first];
+}
@@ -0,0 +1,108 @@
+///
+/// @file  tuplet_iterator.cpp
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/tuplet_iterator.hpp>
+#include <primesieve/config.hpp>
+#include <primesieve/IteratorHelper.hpp>
+#include <primesieve/TupletGenerator.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <memory>
+
+namespace primesieve {
+
+template <int K>
+tuplet_iterator<K>::~tuplet_iterator() = default;
+
+template <int K>
+tuplet_iterator<K>::tuplet_iterator(tuplet_iterator&&) noexcept = default;
+
+template <int K>
+tuplet_iterator<K>& tuplet_iterator<K>::operator=(tuplet_iterator&&) noexcept = default;
+
+template <int K>
+tuplet_iterator<K>::tuplet_iterator(uint64_t start,
+                                    uint64_t stop_hint)
+{
+  skipto(start, stop_hint);
+}
+
+/// TupletGenerator is kept, it reuses its memory
+template <int K>
+void tuplet_iterator<K>::skipto(uint64_t start,
+                                uint64_t stop_hint)
+{
+  start_ = start;
+  stop_ = start;
+  stop_hint_ = stop_hint;
+  i_ = 0;
+  size_ = 0;
+  dist_ = 0;
+  tuplets_.clear();
+}
+
+template <int K>
+const uint64_t* tuplet_iterator<K>::next_tuplets(std::size_t* size)
+{
+  // all buffered k-tuplets have been returned
+  if (i_ == size_)
+    generate_next_tuplets();
+
+  std::size_t first = i_;
+  *size = (size_ - first) / K;
+  i_ = size_;
+  return &tuplets_[first];
+}
+
+template <int K>
+void tuplet_iterator<K>::generate_next_tuplets()
+{
+  bool isNewInterval = tuplets_.empty();
+  uint64_t maxStop = std::numeric_limits<uint64_t>::max();
+  tuplets_.resize(config::ITERATOR_BUFFER_SIZE * K);
+
+  if (!tupletGenerator_)
+    tupletGenerator_.reset(new TupletGenerator(K));
+
+  for (size_ = 0; !size_;)
+  {
+    if (isNewInterval ||
+        tupletGenerator_->finished())
+    {
+      // no more k-tuplets < 2^64
+      if (stop_ == maxStop && !isNewInterval)
+      {
+        std::fill_n(tuplets_.begin(), K, maxStop);
+        size_ = K;
+        break;
+      }
+
+      IteratorHelper::next(&start_, &stop_, stop_hint_, &dist_);
+      stop_ = TupletGenerator::alignStop(stop_);
+      tupletGenerator_->init(start_, stop_);
+      isNewInterval = false;
+    }
+
+    tupletGenerator_->fill(tuplets_, &size_);
+  }
+
+  i_ = 0;
+}
+
+template class tuplet_iterator<2>;
+template class tuplet_iterator<3>;
+template class tuplet_iterator<4>;
+template class tuplet_iterator<5>;
+template class tuplet_iterator<6>;
+
+} // namespace
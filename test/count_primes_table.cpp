@@ -0,0 +1,96 @@
+///
+/// @file   count_primes_table.cpp
+/// @brief  Test the cumulative prime and prime k-tuplet
+///         count tables.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+using count_t = uint64_t (*)(uint64_t, uint64_t);
+using table_t = vector<uint64_t> (*)(uint64_t, uint64_t, uint64_t);
+
+/// Compare the table against individual count calls
+void test(table_t countTable, count_t count, uint64_t start, uint64_t stop, uint64_t step)
+{
+  auto table = countTable(start, stop, step);
+  uint64_t x = ((start + step - 1) / step) * step;
+  x = max(x, step);
+  size_t i = 0;
+
+  for (; x <= stop; x += step, i++)
+  {
+    if (i >= table.size())
+      break;
+    if (table[i] != count(start, x))
+    {
+      cout << "count(" << start << ", " << x << ") = " << table[i];
+      check(false);
+    }
+  }
+
+  cout << "table(" << start << ", " << stop << ", " << step << ").size() = " << table.size();
+  check(table.size() == i);
+}
+
+int main()
+{
+  vector<table_t> tables =
+  {
+    primesieve::count_primes_table,
+    primesieve::count_twins_table,
+    primesieve::count_triplets_table,
+    primesieve::count_quadruplets_table,
+    primesieve::count_quintuplets_table,
+    primesieve::count_sextuplets_table
+  };
+
+  vector<count_t> counts =
+  {
+    primesieve::count_primes,
+    primesieve::count_twins,
+    primesieve::count_triplets,
+    primesieve::count_quadruplets,
+    primesieve::count_quintuplets,
+    primesieve::count_sextuplets
+  };
+
+  // small primes and k-tuplets
+  for (size_t k = 0; k < tables.size(); k++)
+    for (uint64_t start = 0; start < 20; start++)
+      for (uint64_t step = 1; step < 10; step++)
+        test(tables[k], counts[k], start, 100, step);
+
+  for (size_t k = 0; k < tables.size(); k++)
+    test(tables[k], counts[k], 1000, 100000, 997);
+
+  test(tables[0], counts[0], 0, (uint64_t) 1e8, (uint64_t) 1e7);
+  test(tables[1], counts[1], (uint64_t) 1e12, (uint64_t) 1e12 + (uint64_t) 1e8, 12345678);
+
+  auto pi = primesieve::count_primes_table(0, (uint64_t) 1e9, (uint64_t) 1e8);
+  cout << "PrimePi(10^9) = " << pi.back();
+  check(pi.size() == 10 && pi.back() == 50847534);
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,114 @@
+///
+/// @file   count_sophie_germain.cpp
+/// @brief  Count the Sophie Germain primes, the safe primes and
+///         the primes p for which a * p + b is also prime.
+///         Compare the results with a simple sieve.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+vector<char> isPrime;
+
+void initPrimes(uint64_t n)
+{
+  isPrime.resize(n + 1, true);
+  isPrime[0] = false;
+  isPrime[1] = false;
+
+  for (uint64_t i = 2; i * i <= n; i++)
+    if (isPrime[i])
+      for (uint64_t j = i * i; j <= n; j += i)
+        isPrime[j] = false;
+}
+
+uint64_t linearForm(uint64_t a, int64_t b, uint64_t p)
+{
+  int64_t q = (int64_t) (a * p) + b;
+  return (q > 0) ? q : 0;
+}
+
+void test(uint64_t a, int64_t b, uint64_t start, uint64_t stop)
+{
+  uint64_t count = 0;
+
+  for (uint64_t p = start; p <= stop; p++)
+    if (isPrime[p] && isPrime[linearForm(a, b, p)])
+      count++;
+
+  uint64_t res = primesieve::count_linear_primes(a, b, start, stop);
+  cout << "count_linear_primes(" << a << ", " << b << ", " << start << ", " << stop << ") = " << res;
+  check(res == count);
+}
+
+int main()
+{
+  uint64_t n = (uint64_t) 1e7;
+  initPrimes(6 * n + 1);
+
+  // small intervals
+  for (uint64_t start = 0; start < 40; start++)
+    for (uint64_t stop = start; stop < 100; stop += 7)
+    {
+      test(2, 1, start, stop);
+      test(2, -1, start, stop);
+      test(1, 2, start, stop);
+    }
+
+  test(2, 1, 0, n);
+  test(2, -1, 0, n);
+  test(1, 2, 0, n);
+  test(6, 1, 0, n);
+  test(6, 1, 123456, 7654321);
+  test(4, 3, 999, n - 999);
+
+  uint64_t count = primesieve::count_sophie_germain_primes(0, (uint64_t) 1e9);
+  cout << "count_sophie_germain_primes(1e9) = " << count;
+  check(count == 3308859);
+
+  // safe primes q = 2p + 1
+  for (uint64_t stop = 0; stop < 200; stop++)
+  {
+    count = 0;
+    for (uint64_t q = 5; q <= stop; q += 2)
+      if (isPrime[q] && isPrime[(q - 1) / 2])
+        count++;
+
+    cout << "count_safe_primes(" << stop << ") = " << primesieve::count_safe_primes(0, stop);
+    check(primesieve::count_safe_primes(0, stop) == count);
+  }
+
+  count = primesieve::count_safe_primes(1000, (uint64_t) 1e9);
+  cout << "count_safe_primes(1000, 1e9) = " << count;
+  check(count == primesieve::count_sophie_germain_primes(500, (uint64_t) 5e8 - 1));
+
+  // twin primes are (p, p + 2) pairs
+  uint64_t start = (uint64_t) 1e12;
+  uint64_t stop = start + (uint64_t) 1e8;
+  count = primesieve::count_linear_primes(1, 2, start, stop - 2);
+  cout << "count_linear_primes(1, 2, 1e12, 1e12+1e8-2) = " << count;
+  check(count == primesieve::count_twins(start, stop));
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+///
+/// @file   counts_cache1.cpp
+/// @brief  Test primesieve::set_counts_cache(). Counting with
+///         the counts cache must give the same results as
+///         counting without the cache.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+vector<uint64_t> count(uint64_t start, uint64_t stop)
+{
+  return { count_primes(start, stop),
+           count_twins(start, stop) };
+}
+
+int main()
+{
+  // overlapping windows, the block size is about 10^9
+  vector<pair<uint64_t, uint64_t>> windows =
+  {
+    { 0, 2100000000ull },
+    { 1006632962ull, 3019898883ull },
+    { 1006632963ull, 3019898882ull }
+  };
+
+  vector<vector<uint64_t>> expected;
+
+  for (auto& w : windows)
+    expected.push_back(count(w.first, w.second));
+
+  set_counts_cache(1 << 20);
+
+  for (size_t i = 0; i < windows.size(); i++)
+  {
+    auto& w = windows[i];
+    cout << "count_primes(" << w.first << ", " << w.second << ") = " << expected[i][0];
+    check(count(w.first, w.second) == expected[i]);
+  }
+
+  counts_cache_stats stats = get_counts_cache_stats();
+  cout << "hits = " << stats.hits << ", misses = " << stats.misses;
+  check(stats.hits > 0 && stats.misses > 0);
+  cout << "blocks = " << stats.blocks << ", memory_usage = " << stats.memory_usage;
+  check(stats.blocks == 3 && stats.memory_usage <= (1 << 20));
+
+  // The last window is cached completely
+  uint64_t hits = stats.hits;
+  uint64_t misses = stats.misses;
+  count_primes(1006632963ull, 3019898882ull);
+  stats = get_counts_cache_stats();
+  cout << "count_primes(1006632963, 3019898882) hits = " << stats.hits - hits;
+  check(stats.hits - hits == 2 && stats.misses == misses);
+
+  // Only 1 block fits into the cache
+  uint64_t blockMemory = stats.memory_usage / stats.blocks;
+  set_counts_cache(blockMemory);
+  stats = get_counts_cache_stats();
+  cout << "set_counts_cache(" << blockMemory << "), blocks = " << stats.blocks;
+  check(stats.blocks == 1);
+  clear_counts_cache();
+
+  for (size_t i = 0; i < windows.size(); i++)
+  {
+    auto& w = windows[i];
+    cout << "count_primes(" << w.first << ", " << w.second << ") = " << expected[i][0];
+    check(count(w.first, w.second) == expected[i]);
+  }
+
+  stats = get_counts_cache_stats();
+  cout << "evictions = " << stats.evictions << ", blocks = " << stats.blocks;
+  check(stats.evictions > 0 && stats.blocks == 1);
+
+  set_counts_cache(0);
+  stats = get_counts_cache_stats();
+  cout << "set_counts_cache(0), blocks = " << stats.blocks;
+  check(stats.blocks == 0);
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,63 @@
+///
+/// @file   counts_cache2.c
+/// @brief  Test primesieve_set_counts_cache() and
+///         primesieve_get_counts_cache_stats().
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void check(int OK)
+{
+  if (OK)
+    printf("   OK\n");
+  else
+  {
+    printf("   ERROR\n");
+    exit(1);
+  }
+}
+
+int main()
+{
+  uint64_t start = 5000000000ull;
+  uint64_t stop = 8000000000ull;
+  uint64_t count1 = primesieve_count_twins(start, stop);
+  uint64_t count2, count3;
+  primesieve_counts_cache_stats stats;
+
+  primesieve_set_counts_cache(1 << 20);
+  count2 = primesieve_count_twins(start, stop);
+  count3 = primesieve_count_twins(start, stop);
+
+  printf("primesieve_count_twins(%" PRIu64 ", %" PRIu64 ") = %" PRIu64, start, stop, count2);
+  check(count1 == count2 && count1 == count3);
+
+  stats = primesieve_get_counts_cache_stats();
+  printf("hits = %" PRIu64 ", misses = %" PRIu64, stats.hits, stats.misses);
+  check(stats.hits == stats.misses && stats.hits > 0);
+
+  printf("blocks = %" PRIu64 ", memory_usage = %" PRIu64, stats.blocks, stats.memory_usage);
+  check(stats.blocks == stats.misses && stats.memory_usage > 0);
+
+  primesieve_clear_counts_cache();
+  stats = primesieve_get_counts_cache_stats();
+  printf("primesieve_clear_counts_cache(), blocks = %" PRIu64, stats.blocks);
+  check(stats.blocks == 0 && stats.hits == 0);
+
+  primesieve_set_counts_cache(0);
+
+  printf("\n");
+  printf("All tests passed successfully!\n");
+
+  return 0;
+}
@@ -0,0 +1,136 @@
+///
+/// @file   decode_primes.cpp
+/// @brief  Test all decodePrimes() kernels supported by the
+///         CPU against a bit by bit reference implementation.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/decodePrimes.hpp>
+#include <primesieve/types.hpp>
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace primesieve;
+
+const uint64_t wheel[8] = { 7, 11, 13, 17, 19, 23, 29, 31 };
+const uint64_t guard = 12345;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+/// Decode the words [first, last[ bit by bit
+vector<uint64_t> reference(const vector<byte_t>& sieve,
+                           size_t first,
+                           size_t last,
+                           uint64_t low)
+{
+  vector<uint64_t> primes;
+
+  for (size_t i = first * 8; i < last * 8; i++)
+    for (int bit = 0; bit < 8; bit++)
+      if (sieve[i] & (1 << bit))
+        primes.push_back(low + (i - first * 8) * 30 + wheel[bit]);
+
+  return primes;
+}
+
+/// Decode the sieve array in blocks of at most
+/// maxSize + 64 primes and check that no primes are
+/// written past the end of the buffer.
+///
+void test(const DecodeKernel& kernel,
+          const vector<byte_t>& sieve,
+          uint64_t low,
+          size_t maxSize)
+{
+  size_t words = sieve.size() / 8;
+  uint64_t sieveIdx = 0;
+  uint64_t lowIdx = low;
+  bool ok = true;
+
+  while (sieveIdx < sieve.size())
+  {
+    size_t first = sieveIdx / 8;
+    vector<uint64_t> primes(maxSize + 64 + 8, guard);
+    size_t size = kernel.decode(&sieve[0], &sieveIdx, sieve.size(), &lowIdx, &primes[0], maxSize);
+    size_t last = sieveIdx / 8;
+
+    for (size_t i = maxSize + 64; i < primes.size(); i++)
+      ok &= primes[i] == guard;
+
+    auto expected = reference(sieve, first, last, low + first * 240);
+    primes.resize(size);
+    ok &= primes == expected;
+    ok &= lowIdx == low + last * 240;
+    ok &= size > maxSize || last == words;
+  }
+
+  cout << "decodePrimes<" << kernel.name << ">(low = " << low << ", maxSize = " << maxSize << ")";
+  check(ok);
+}
+
+void testGuard(const DecodeKernel& kernel)
+{
+  // all 64 bits set, the buffer has exactly 64 slots
+  vector<byte_t> sieve(8, 0xff);
+  vector<uint64_t> primes(64 + 1, guard);
+  uint64_t sieveIdx = 0;
+  uint64_t low = 0;
+  size_t size = kernel.decode(&sieve[0], &sieveIdx, sieve.size(), &low, &primes[0], 0);
+
+  cout << "decodePrimes<" << kernel.name << ">(0xff..ff) = " << size;
+  check(size == 64 &&
+        primes[0] == 7 &&
+        primes[63] == 7 * 30 + 31 &&
+        primes[64] == guard);
+}
+
+int main()
+{
+  auto kernels = getDecodeKernels();
+  uint64_t seed = 1;
+
+  // sieve arrays of increasing density
+  for (int density : { 0, 1, 8, 32, 64, 100 })
+  {
+    vector<byte_t> sieve(1 << 12);
+
+    for (auto& byte : sieve)
+    {
+      for (int bit = 0; bit < 8; bit++)
+      {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        if ((int) ((seed >> 33) % 100) < density)
+          byte |= (byte_t) (1 << bit);
+      }
+    }
+
+    for (auto& kernel : kernels)
+    {
+      test(kernel, sieve, 0, 0);
+      test(kernel, sieve, (uint64_t) 1e10 * 30, 100);
+      test(kernel, sieve, (uint64_t) 1e17 * 30, 1024 - 64);
+    }
+  }
+
+  for (auto& kernel : kernels)
+    testGuard(kernel);
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
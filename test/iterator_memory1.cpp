@@ -0,0 +1,109 @@
+///
+/// @file   iterator_memory1.cpp
+/// @brief  Test primesieve::iterator::set_max_memory() and
+///         memory_usage(). An iterator with a memory limit
+///         must generate the same primes as an iterator
+///         without limit.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+int main()
+{
+  uint64_t maxMemory = 8 << 20;
+
+  {
+    // stop_hint is much too large
+    primesieve::iterator it1(1000000000, 10000000000000000000ull);
+    primesieve::iterator it2(1000000000, 10000000000000000000ull);
+    it2.set_max_memory(maxMemory);
+    bool ok = true;
+
+    for (int i = 0; i < 1000000; i++)
+      ok &= it1.next_prime() == it2.next_prime();
+
+    cout << "next_prime() with max_memory";
+    check(ok);
+
+    cout << "memory_usage() = " << it2.memory_usage() << " <= " << maxMemory;
+    check(it2.memory_usage() <= maxMemory);
+
+    cout << "memory_usage() = " << it2.memory_usage() << " < " << it1.memory_usage();
+    check(it2.memory_usage() < it1.memory_usage());
+  }
+
+  {
+    maxMemory = 4 << 20;
+    primesieve::iterator it1(1000000000000);
+    primesieve::iterator it2(1000000000000);
+    it2.set_max_memory(maxMemory);
+    bool ok = true;
+
+    for (int i = 0; i < 3000000; i++)
+      ok &= it1.prev_prime() == it2.prev_prime();
+
+    cout << "prev_prime() with max_memory";
+    check(ok);
+
+    cout << "memory_usage() = " << it2.memory_usage() << " <= " << maxMemory;
+    check(it2.memory_usage() <= maxMemory);
+  }
+
+  {
+    // Switch directions and skipto() using a limit
+    // that is smaller than the memory of a segment
+    primesieve::iterator it1(1000000000);
+    primesieve::iterator it2(1000000000);
+    it2.set_max_memory(1);
+    bool ok = true;
+
+    for (int i = 0; i < 100000; i++)
+      ok &= it1.next_prime() == it2.next_prime();
+    for (int i = 0; i < 200000; i++)
+      ok &= it1.prev_prime() == it2.prev_prime();
+
+    it1.skipto(123456789012);
+    it2.skipto(123456789012);
+
+    for (int i = 0; i < 100000; i++)
+      ok &= it1.next_prime() == it2.next_prime();
+
+    cout << "skipto() with max_memory";
+    check(ok);
+
+    // The primes buffer, sieve array and sieving
+    // primes are always needed
+    cout << "memory_usage() = " << it2.memory_usage() << " > 0";
+    check(it2.memory_usage() > 0);
+  }
+
+  {
+    primesieve::iterator it;
+    cout << "memory_usage() = " << it.memory_usage() << " of new iterator";
+    check(it.memory_usage() == 0);
+  }
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
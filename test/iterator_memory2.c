@@ -0,0 +1,94 @@
+///
+/// @file   iterator_memory2.c
+/// @brief  Test primesieve_iterator_set_max_memory() and
+///         primesieve_iterator_memory_usage().
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void check(int OK)
+{
+  if (OK)
+    printf("   OK\n");
+  else
+  {
+    printf("   ERROR\n");
+    exit(1);
+  }
+}
+
+int main()
+{
+  primesieve_iterator it1;
+  primesieve_iterator it2;
+  uint64_t maxMemory = 8 << 20;
+  uint64_t stopHint = 10000000000000000000ull;
+  uint64_t mem1, mem2;
+  int ok = 1;
+  int i;
+
+  primesieve_init(&it1);
+  primesieve_init(&it2);
+  primesieve_iterator_set_max_memory(&it2, maxMemory);
+
+  printf("primesieve_iterator_memory_usage() = %" PRIu64 " of new iterator", primesieve_iterator_memory_usage(&it2));
+  check(primesieve_iterator_memory_usage(&it2) == 0);
+
+  // stop_hint is much too large
+  primesieve_skipto(&it1, 1000000000, stopHint);
+  primesieve_skipto(&it2, 1000000000, stopHint);
+
+  for (i = 0; i < 1000000; i++)
+    ok &= primesieve_next_prime(&it1) == primesieve_next_prime(&it2);
+
+  printf("primesieve_next_prime() with max_memory");
+  check(ok);
+
+  mem1 = primesieve_iterator_memory_usage(&it1);
+  mem2 = primesieve_iterator_memory_usage(&it2);
+
+  printf("primesieve_iterator_memory_usage() = %" PRIu64 " <= %" PRIu64, mem2, maxMemory);
+  check(mem2 <= maxMemory);
+
+  printf("primesieve_iterator_memory_usage() = %" PRIu64 " < %" PRIu64, mem2, mem1);
+  check(mem2 < mem1);
+
+  for (i = 0; i < 2000000; i++)
+    ok &= primesieve_prev_prime(&it1) == primesieve_prev_prime(&it2);
+
+  printf("primesieve_prev_prime() with max_memory");
+  check(ok);
+
+  mem2 = primesieve_iterator_memory_usage(&it2);
+  printf("primesieve_iterator_memory_usage() = %" PRIu64 " <= %" PRIu64, mem2, maxMemory);
+  check(mem2 <= maxMemory);
+
+  // remove the limit
+  primesieve_iterator_set_max_memory(&it2, 0);
+  primesieve_skipto(&it1, 0, stopHint);
+  primesieve_skipto(&it2, 0, stopHint);
+
+  for (i = 0; i < 1000000; i++)
+    ok &= primesieve_next_prime(&it1) == primesieve_next_prime(&it2);
+
+  printf("primesieve_next_prime() without max_memory");
+  check(ok);
+
+  primesieve_free_iterator(&it1);
+  primesieve_free_iterator(&it2);
+
+  printf("\n");
+  printf("All tests passed successfully!\n");
+
+  return 0;
+}
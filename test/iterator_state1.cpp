@@ -0,0 +1,186 @@
+///
+/// @file   iterator_state1.cpp
+/// @brief  Test primesieve::iterator::save_state() and
+///         restore_state(). The restored iterator must
+///         return the same primes and use the same
+///         intervals as the saved iterator.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+/// Generate n primes using next_prime() (n > 0)
+/// or prev_prime() (n < 0)
+///
+vector<uint64_t> generate(primesieve::iterator& it, int64_t n)
+{
+  vector<uint64_t> primes;
+
+  for (; n > 0; n--)
+    primes.push_back(it.next_prime());
+  for (; n < 0; n++)
+    primes.push_back(it.prev_prime());
+
+  return primes;
+}
+
+/// Direction of the previous test, 0 if unknown
+int64_t dir = 0;
+
+/// Save the state of it, continue with both it and a
+/// restored iterator and compare the primes. If the
+/// direction is kept both iterators must use the same
+/// intervals i.e. their states must be equal.
+///
+void test(primesieve::iterator& it, int64_t n, int64_t m)
+{
+  bool sameDir = (n > 0) == (m > 0) &&
+                 (dir == 0 || (n > 0) == (dir > 0));
+  dir = m;
+
+  auto state = it.save_state();
+  primesieve::iterator it2;
+  it2.restore_state(state);
+
+  auto primes1 = generate(it, n);
+  auto primes2 = generate(it2, n);
+  auto primes3 = generate(it, m);
+  auto primes4 = generate(it2, m);
+
+  cout << "restore_state() n = " << n << ", m = " << m;
+  check(primes1 == primes2 &&
+        primes3 == primes4 &&
+        (!sameDir || it.save_state() == it2.save_state()));
+}
+
+int main()
+{
+  primesieve::iterator it;
+  cout << "save_state().size() = " << it.save_state().size();
+  check(it.save_state().size() == 48);
+
+  // fresh iterator
+  test(it, 100, -10);
+  test(it, 10, 1000000);
+  test(it, 200000, -1000000);
+  test(it, 3000000, -20);
+
+  it.skipto((uint64_t) 1e12);
+  dir = 0;
+  test(it, 1, 100000);
+  test(it, 5000000, 100);
+  test(it, -100000, 2000);
+  test(it, -1000000, -300000);
+  test(it, 1, -1);
+  test(it, -1, 1);
+
+  // restore the state inside a skipto() that reuses
+  // the buffered primes or the PrimeGenerator
+  it.skipto((uint64_t) 1e15);
+  dir = 0;
+  generate(it, 1000);
+  it.skipto((uint64_t) 1e15 + 10000);
+  test(it, 100, 1000);
+  it.skipto((uint64_t) 1e15 + 2000000);
+  test(it, -100, 1000);
+
+  // next_primes() and prev_primes() blocks
+  it.skipto((uint64_t) 1e10);
+  size_t size;
+  it.next_primes(&size);
+  it.next_primes(&size);
+  test(it, 1000, -5000);
+  it.prev_primes(&size);
+  test(it, -1000, 5000);
+
+  // the primes near 0
+  it.skipto(20);
+  test(it, -10, 100);
+  it.skipto(5);
+  test(it, -3, 3);
+  it.skipto((uint64_t) 1e16);
+  test(it, 10, -100);
+
+  // the restored state contains the stop hint
+  uint64_t stop = (uint64_t) 1e9 + (uint64_t) 1e6;
+  it.skipto((uint64_t) 1e9, stop);
+  test(it, 1000, 10000);
+
+  // NEXT state whose position is the stop number of the
+  // interval, save -> restore -> save must round-trip
+  it.skipto((uint64_t) 1e11);
+  generate(it, 100);
+  vector<uint8_t> state = it.save_state();
+  copy_n(&state[16], 8, &state[40]);
+  uint64_t pos = 0;
+  for (int i = 0; i < 8; i++)
+    pos |= (uint64_t) state[40 + i] << (i * 8);
+  primesieve::iterator it3;
+  it3.restore_state(state);
+  cout << "save_state() after restore_state() at stop";
+  check(it3.save_state() == state);
+  it3.restore_state(it3.save_state());
+  primesieve::iterator it4(pos);
+  auto primes1 = generate(it3, 1000);
+  auto primes2 = generate(it4, 1000);
+  cout << "next_prime() after restore_state() at stop";
+  check(primes1 == primes2);
+
+  // prev_prime() after restoring a NEXT state at the
+  // end of an interval must not skip that interval
+  primesieve::iterator it5(11524690);
+  it5.next_prime();
+  it5.next_prime();
+  it5.skipto(11619564);
+  size_t n;
+  const uint64_t* block = it5.next_primes(&n);
+  pos = block[n - 1];
+  it5.restore_state(it5.save_state());
+  primesieve::iterator it6(pos);
+  primes1 = generate(it5, -1000);
+  primes2 = generate(it6, -1000);
+  cout << "prev_prime() after restore_state() at stop = " << primes1[0];
+  check(primes1 == primes2);
+
+  // restore_state() throws if the state is invalid
+  state = it.save_state();
+  state = it.save_state();
+  state[0] = 'X';
+  bool isError = false;
+  try { it.restore_state(state); }
+  catch (primesieve_error&) { isError = true; }
+  cout << "restore_state(invalid state) throws";
+  check(isError);
+
+  isError = false;
+  state.resize(10);
+  try { it.restore_state(state); }
+  catch (primesieve_error&) { isError = true; }
+  cout << "restore_state(short state) throws";
+  check(isError);
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
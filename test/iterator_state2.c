@@ -0,0 +1,182 @@
+///
+/// @file   iterator_state2.c
+/// @brief  Test primesieve_save_state() and
+///         primesieve_restore_state().
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void check(int OK)
+{
+  if (OK)
+    printf("   OK\n");
+  else
+  {
+    printf("   ERROR\n");
+    exit(1);
+  }
+}
+
+/// Direction of the previous test, 0 if unknown
+int64_t dir = 0;
+
+/// Save the state of it, continue with both it and a
+/// restored iterator and compare the primes.
+/// n > 0 uses primesieve_next_prime(),
+/// n < 0 uses primesieve_prev_prime().
+/// If the direction is kept both iterators must
+/// use the same intervals.
+///
+void test(primesieve_iterator* it, int64_t n)
+{
+  int sameDir = dir == 0 || (n > 0) == (dir > 0);
+  uint8_t state1[PRIMESIEVE_ITERATOR_STATE_SIZE];
+  uint8_t state2[PRIMESIEVE_ITERATOR_STATE_SIZE];
+  primesieve_iterator it2;
+  int64_t i;
+  int ok = 1;
+
+  primesieve_save_state(it, state1);
+  primesieve_init(&it2);
+  primesieve_restore_state(&it2, state1);
+
+  for (i = 0; i < n; i++)
+    ok &= primesieve_next_prime(it) == primesieve_next_prime(&it2);
+  for (i = 0; i > n; i--)
+    ok &= primesieve_prev_prime(it) == primesieve_prev_prime(&it2);
+
+  primesieve_save_state(it, state1);
+  primesieve_save_state(&it2, state2);
+  if (sameDir)
+    ok &= memcmp(state1, state2, sizeof(state1)) == 0;
+  dir = n;
+  primesieve_free_iterator(&it2);
+
+  printf("primesieve_restore_state() n = %" PRId64, n);
+  check(ok);
+}
+
+/// Restore a NEXT state at the stop number of its
+/// interval, the iterator must continue after stop.
+///
+void test_stop(primesieve_iterator* it)
+{
+  uint8_t state1[PRIMESIEVE_ITERATOR_STATE_SIZE];
+  uint8_t state2[PRIMESIEVE_ITERATOR_STATE_SIZE];
+  primesieve_iterator it2;
+  primesieve_iterator it3;
+  uint64_t pos = 0;
+  int i;
+  int ok = 1;
+
+  primesieve_next_prime(it);
+  primesieve_save_state(it, state1);
+  memcpy(&state1[40], &state1[16], 8);
+  for (i = 0; i < 8; i++)
+    pos |= (uint64_t) state1[40 + i] << (i * 8);
+
+  primesieve_init(&it2);
+  primesieve_restore_state(&it2, state1);
+  primesieve_save_state(&it2, state2);
+  ok &= memcmp(state1, state2, sizeof(state1)) == 0;
+  primesieve_restore_state(&it2, state2);
+
+  primesieve_init(&it3);
+  primesieve_skipto(&it3, pos, primesieve_get_max_stop());
+  for (i = 0; i < 1000; i++)
+    ok &= primesieve_next_prime(&it2) == primesieve_next_prime(&it3);
+
+  primesieve_free_iterator(&it2);
+  primesieve_free_iterator(&it3);
+
+  printf("primesieve_restore_state() at stop = %" PRIu64, pos);
+  check(ok);
+}
+
+/// prev_prime() after restoring a NEXT state at the
+/// end of an interval must not skip that interval.
+///
+void test_stop_prev()
+{
+  uint8_t state[PRIMESIEVE_ITERATOR_STATE_SIZE];
+  primesieve_iterator it;
+  primesieve_iterator it2;
+  const uint64_t* block;
+  uint64_t pos;
+  size_t size;
+  int i;
+  int ok = 1;
+
+  primesieve_init(&it);
+  primesieve_skipto(&it, 11524690, primesieve_get_max_stop());
+  primesieve_next_prime(&it);
+  primesieve_next_prime(&it);
+  primesieve_skipto(&it, 11619564, primesieve_get_max_stop());
+  block = primesieve_next_primes(&it, &size);
+  pos = block[size - 1];
+  primesieve_save_state(&it, state);
+  primesieve_restore_state(&it, state);
+
+  primesieve_init(&it2);
+  primesieve_skipto(&it2, pos, primesieve_get_max_stop());
+  for (i = 0; i < 1000; i++)
+    ok &= primesieve_prev_prime(&it) == primesieve_prev_prime(&it2);
+
+  primesieve_free_iterator(&it);
+  primesieve_free_iterator(&it2);
+
+  printf("primesieve_prev_prime() after restore at stop = %" PRIu64, pos);
+  check(ok);
+}
+
+int main()
+{
+  uint8_t state[PRIMESIEVE_ITERATOR_STATE_SIZE];
+  primesieve_iterator it;
+  primesieve_init(&it);
+
+  test(&it, 100);
+  test(&it, 1000000);
+  test(&it, -300000);
+  test(&it, 500000);
+
+  primesieve_skipto(&it, (uint64_t) 1e12, primesieve_get_max_stop());
+  dir = 0;
+  test(&it, -100000);
+  test(&it, 2000000);
+  test(&it, 1);
+  test(&it, -1);
+
+  primesieve_skipto(&it, (uint64_t) 1e12 + 1000, primesieve_get_max_stop());
+  dir = 0;
+  test(&it, 1000);
+
+  /* NEXT state whose position is the stop number of
+     the interval, save -> restore -> save must round-trip */
+  test_stop(&it);
+  test_stop_prev();
+
+  primesieve_save_state(&it, state);
+  state[5] = 9;
+  primesieve_restore_state(&it, state);
+  printf("primesieve_restore_state(invalid state) is_error = %d", it.is_error);
+  check(it.is_error == 1);
+
+  primesieve_free_iterator(&it);
+
+  printf("\n");
+  printf("All tests passed successfully!\n");
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+///
+/// @file   max_memory1.cpp
+/// @brief  Test primesieve::set_max_memory(). Counting must give
+///         the same results if the memory limit can be met and
+///         throw a primesieve_error if it cannot be met.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+int main()
+{
+  uint64_t start = 1000000000000000000ull;
+  uint64_t stop = start + 10000000;
+  uint64_t count = count_primes(start, stop);
+
+  cout << "get_max_memory() = " << get_max_memory();
+  check(get_max_memory() == 0);
+
+  set_max_memory(256 << 20);
+  cout << "get_max_memory() = " << get_max_memory();
+  check(get_max_memory() == 256 << 20);
+
+  uint64_t res = count_primes(start, stop);
+  cout << "count_primes(1e18, 1e18+1e7) = " << res;
+  check(res == count);
+
+  // requires a smaller sieve size
+  set_max_memory(1 << 20);
+  set_sieve_size(4096);
+  res = count_primes(0, 1000000000);
+  cout << "count_primes(0, 1e9) = " << res;
+  check(res == 50847534);
+  res = nth_prime(1000000);
+  cout << "nth_prime(1e6) = " << res;
+  check(res == 15485863);
+
+  bool error = false;
+
+  try
+  {
+    count_primes(start, stop);
+  }
+  catch (primesieve_error& e)
+  {
+    cout << e.what() << endl;
+    error = true;
+  }
+
+  cout << "count_primes(1e18, 1e18+1e7) with 1 MiB";
+  check(error);
+
+  // The lookup sieve of a * p + b over [1e18, 1e18+1e16]
+  // requires much more memory than sieving [1e9, 1e9+1e7].
+  set_max_memory(16 << 20);
+  res = count_primes(1000000000, 1010000000);
+  cout << "count_primes(1e9, 1e9+1e7) = " << res;
+  check(res == 482449);
+
+  error = false;
+
+  try
+  {
+    count_linear_primes(1000000000, 1, 1000000000, 1010000000);
+  }
+  catch (primesieve_error& e)
+  {
+    cout << e.what() << endl;
+    error = true;
+  }
+
+  cout << "count_linear_primes(1e9, 1, 1e9, 1e9+1e7) with 16 MiB";
+  check(error);
+
+  set_max_memory(0);
+  res = count_primes(start, stop);
+  cout << "count_primes(1e18, 1e18+1e7) = " << res;
+  check(res == count);
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,78 @@
+///
+/// @file   memory_pool_stats1.cpp
+/// @brief  Test primesieve::get_memory_pool_stats(). The memory
+///         of the sieving primes must be freed once it is no
+///         longer needed.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+int main()
+{
+  memory_pool_stats before = get_memory_pool_stats();
+  uint64_t big = 0;
+  uint64_t small = 0;
+
+  {
+    // prev_prime() reuses its sieving primes
+    // (and memory pools) between the intervals
+    primesieve::iterator it;
+    it.skipto(1000000000000000000ull);
+    uint64_t prime = it.prev_prime();
+    cout << "prev_prime(1e18) = " << prime;
+    check(prime == 999999999999999989ull);
+
+    memory_pool_stats stats = get_memory_pool_stats();
+    big = stats.bytes;
+    cout << "buckets_in_use = " << stats.buckets_in_use;
+    check(stats.buckets_in_use > 0);
+    cout << "allocations = " << stats.allocations;
+    check(stats.allocations > before.allocations);
+    cout << "bytes = " << stats.bytes;
+    check(stats.bytes > before.bytes);
+    cout << "peak_buckets_in_use = " << stats.peak_buckets_in_use;
+    check(stats.peak_buckets_in_use >= stats.buckets_in_use);
+
+    it.skipto(10000000000ull);
+    prime = it.prev_prime();
+    cout << "prev_prime(1e10) = " << prime;
+    check(prime == 9999999967ull);
+
+    stats = get_memory_pool_stats();
+    small = stats.bytes;
+    cout << "bytes = " << small;
+    check(small < big);
+  }
+
+  memory_pool_stats after = get_memory_pool_stats();
+  cout << "bytes = " << after.bytes;
+  check(after.bytes == before.bytes);
+  cout << "buckets_in_use = " << after.buckets_in_use;
+  check(after.buckets_in_use == before.buckets_in_use);
+  cout << "peak_bytes = " << after.peak_bytes;
+  check(after.peak_bytes >= big);
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
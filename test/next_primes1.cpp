@@ -0,0 +1,139 @@
+///
+/// @file   next_primes1.cpp
+/// @brief  Test next_primes() and prev_primes() of
+///         primesieve::iterator.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+int main()
+{
+  vector<uint64_t> primes;
+  primesieve::generate_primes(1000000, &primes);
+  primesieve::iterator it;
+  size_t size = 0;
+  size_t i = 0;
+
+  // iterate over the primes below 10^6 in blocks
+  while (i < primes.size())
+  {
+    const uint64_t* block = it.next_primes(&size);
+    for (size_t j = 0; j < size && i < primes.size(); j++, i++)
+      if (block[j] != primes[i])
+      {
+        cout << "next_primes() block[" << j << "] = " << block[j];
+        check(false);
+      }
+  }
+
+  cout << "next_primes() up to 10^6";
+  check(i == primes.size());
+
+  // mix next_prime() and next_primes()
+  it.skipto(primes[1000]);
+  uint64_t prime = it.next_prime();
+  cout << "next_prime(" << primes[1000] << ") = " << prime;
+  check(prime == primes[1001]);
+
+  const uint64_t* block = it.next_primes(&size);
+  cout << "next_primes()[0] = " << block[0];
+  check(size > 0 && block[0] == primes[1002]);
+
+  uint64_t last = block[size - 1];
+  prime = it.next_prime();
+  cout << "next_prime(" << last << ") = " << prime;
+  check(prime > last && primesieve::count_primes(last + 1, prime) == 1);
+
+  // sum of the primes below 10^9
+  it.skipto(0);
+  uint64_t sum = 0;
+  bool done = false;
+
+  while (!done)
+  {
+    block = it.next_primes(&size);
+    for (size_t j = 0; j < size; j++)
+    {
+      if (block[j] >= 1000000000)
+      {
+        done = true;
+        break;
+      }
+      sum += block[j];
+    }
+  }
+
+  cout << "Sum of the primes below 10^9 = " << sum;
+  check(sum == 24739512092254535ull);
+
+  // iterate backwards over the primes below 10^6
+  it.skipto(primes.back() + 1);
+  i = primes.size();
+  done = false;
+
+  while (!done)
+  {
+    block = it.prev_primes(&size);
+    for (size_t j = size; j-- > 0;)
+    {
+      if (block[j] == 0)
+      {
+        done = true;
+        break;
+      }
+      if (block[j] != primes[--i])
+      {
+        cout << "prev_primes() block[" << j << "] = " << block[j];
+        check(false);
+      }
+    }
+  }
+
+  cout << "prev_primes() below 10^6";
+  check(i == 0);
+
+  // mix prev_prime() and prev_primes()
+  it.skipto(primes[5000]);
+  prime = it.prev_prime();
+  cout << "prev_prime(" << primes[5000] << ") = " << prime;
+  check(prime == primes[4999]);
+
+  block = it.prev_primes(&size);
+  cout << "prev_primes()[size - 1] = " << block[size - 1];
+  check(block[size - 1] == primes[4998]);
+
+  uint64_t first = block[0];
+  prime = it.prev_prime();
+  cout << "prev_prime(" << first << ") = " << prime;
+  check(prime < first && primesieve::count_primes(prime, first - 1) == 1);
+
+  // next_prime() continues after prev_primes()
+  prime = it.next_prime();
+  cout << "next_prime(" << block[0] << ") = " << prime;
+  check(prime == first);
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,84 @@
+///
+/// @file   next_primes2.c
+/// @brief  Test primesieve_next_primes() and
+///         primesieve_prev_primes().
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void check(int OK)
+{
+  if (OK)
+    printf("   OK\n");
+  else
+  {
+    printf("   ERROR\n");
+    exit(1);
+  }
+}
+
+int main()
+{
+  size_t size = 0;
+  uint64_t* primes = (uint64_t*) primesieve_generate_primes(0, 1000000, &size, UINT64_PRIMES);
+  primesieve_iterator it;
+  primesieve_init(&it);
+
+  size_t i = 0;
+  size_t j;
+  size_t n;
+  const uint64_t* block;
+
+  while (i < size)
+  {
+    block = primesieve_next_primes(&it, &n);
+    for (j = 0; j < n && i < size; j++, i++)
+      if (block[j] != primes[i])
+      {
+        printf("primesieve_next_primes() block[%zu] = %" PRIu64, j, block[j]);
+        check(0);
+      }
+  }
+
+  printf("primesieve_next_primes() up to 10^6");
+  check(i == size);
+
+  uint64_t sum = 0;
+  primesieve_skipto(&it, primes[size - 1] + 1, 0);
+
+  for (;;)
+  {
+    block = primesieve_prev_primes(&it, &n);
+    for (j = n; j-- > 0 && block[j] != 0;)
+      sum += block[j];
+    if (block[0] == 0)
+      break;
+  }
+
+  printf("Sum of the primes below 10^6 = %" PRIu64, sum);
+  check(sum == 37550402023ull);
+
+  primesieve_skipto(&it, primes[100], primes[200]);
+  uint64_t prime = primesieve_next_prime(&it);
+  block = primesieve_next_primes(&it, &n);
+  printf("primesieve_next_primes()[0] = %" PRIu64, block[0]);
+  check(prime == primes[101] && block[0] == primes[102]);
+
+  primesieve_free(primes);
+  primesieve_free_iterator(&it);
+
+  printf("\n");
+  printf("All tests passed successfully!\n");
+
+  return 0;
+}
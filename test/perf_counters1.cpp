@@ -0,0 +1,122 @@
+///
+/// @file   perf_counters1.cpp
+/// @brief  Sieve with hardware performance counters enabled. If
+///         perf events are not available (not Linux, not
+///         permitted, no PMU) sieving must be unaffected,
+///         otherwise the cycles and instructions of each thread
+///         must be non-zero and the counters of the threads
+///         are summed over multiple sieve() calls.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/ParallelSieve.hpp>
+#include <primesieve/PerfCounters.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+/// Cycles and instructions must be non-zero
+/// if the events are available.
+///
+bool isValid(const PerfCounters::Values& values)
+{
+  for (int event : { PerfCounters::CYCLES, PerfCounters::INSTRUCTIONS })
+    if (values.available[event] && values.counts[event] == 0)
+      return false;
+
+  return true;
+}
+
+PerfCounters::Values sum(const vector<PerfCounters::Values>& threads)
+{
+  PerfCounters::Values total;
+  for (auto& values : threads)
+    total += values;
+  return total;
+}
+
+int main()
+{
+  // Values::operator+= sums the counts, an
+  // event is available if it is available
+  // in any of the threads.
+  PerfCounters::Values a, b;
+  a.counts[PerfCounters::CYCLES] = 100;
+  a.available[PerfCounters::CYCLES] = true;
+  b.counts[PerfCounters::CYCLES] = 50;
+  b.counts[PerfCounters::INSTRUCTIONS] = 7;
+  b.available[PerfCounters::INSTRUCTIONS] = true;
+  a += b;
+  cout << "Values += Values, cycles = " << a.counts[PerfCounters::CYCLES];
+  check(a.counts[PerfCounters::CYCLES] == 150 &&
+        a.counts[PerfCounters::INSTRUCTIONS] == 7 &&
+        a.available[PerfCounters::CYCLES] &&
+        a.available[PerfCounters::INSTRUCTIONS] &&
+        !a.available[PerfCounters::L1D_MISSES] &&
+        a.isAvailable());
+
+  cout << "Values().isAvailable() = " << PerfCounters::Values().isAvailable();
+  check(!PerfCounters::Values().isAvailable());
+
+  // Single-threaded and multi-threaded sieving
+  for (int threads : { 1, ParallelSieve::getMaxThreads() })
+  {
+    ParallelSieve ps;
+    ps.setNumThreads(threads);
+    ps.setPerfCounters(true);
+
+    uint64_t start = 10000000000ull;
+    uint64_t count = ps.countPrimes(start, start + 1000000000);
+    cout << "countPrimes(1e10, +1e9) = " << count << ", threads = " << threads;
+    check(count == 43336106);
+
+    auto values1 = sum(ps.getPerfValues());
+    cout << "Perf values of threads = " << ps.getPerfValues().size();
+    check(ps.getPerfValues().size() >= 1 &&
+          ps.getPerfValues().size() <= (size_t) threads);
+
+    if (!values1.isAvailable())
+    {
+      cout << "Perf events not available";
+      check(true);
+      continue;
+    }
+
+    for (auto& values : ps.getPerfValues())
+    {
+      cout << "Thread cycles = " << values.counts[PerfCounters::CYCLES]
+           << ", instructions = " << values.counts[PerfCounters::INSTRUCTIONS];
+      check(isValid(values));
+    }
+
+    // The counters are summed over all sieve() calls
+    ps.countPrimes(start, start + 1000000000);
+    auto values2 = sum(ps.getPerfValues());
+    cout << "Cycles after 2nd sieve() = " << values2.counts[PerfCounters::CYCLES];
+    check(isValid(values2) &&
+          values2.counts[PerfCounters::CYCLES] >= values1.counts[PerfCounters::CYCLES] &&
+          values2.counts[PerfCounters::INSTRUCTIONS] > values1.counts[PerfCounters::INSTRUCTIONS] * 3 / 2);
+  }
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,85 @@
+///
+/// @file   prev_prime3.cpp
+/// @brief  Test prev_prime() of primesieve::iterator across
+///         many intervals and mixed with next_prime().
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+int main()
+{
+  uint64_t stop = (uint64_t) 1e12;
+  uint64_t start = stop - (uint64_t) 5e7;
+  vector<uint64_t> primes;
+  primesieve::generate_primes(start, stop, &primes);
+
+  // iterate backwards over many intervals
+  primesieve::iterator it(stop);
+  size_t i = primes.size();
+
+  while (i > 0)
+  {
+    uint64_t prime = it.prev_prime();
+    if (prime != primes[--i])
+    {
+      cout << "prev_prime() = " << prime;
+      check(false);
+    }
+  }
+
+  cout << "prev_prime() inside [1e12 - 5e7, 1e12]";
+  check(i == 0);
+
+  // change direction at pseudo random positions
+  it.skipto(stop);
+  i = primes.size();
+  uint64_t seed = 1;
+
+  for (int j = 0; j < 100; j++)
+  {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    uint64_t steps = (seed >> 33) % 5000;
+    bool backwards = (j % 2 == 0);
+
+    for (uint64_t k = 0; k < steps; k++)
+    {
+      if (backwards && i > 1)
+      {
+        if (it.prev_prime() != primes[--i])
+          check(false);
+      }
+      else if (!backwards && i + 1 < primes.size())
+      {
+        if (it.next_prime() != primes[++i])
+          check(false);
+      }
+    }
+  }
+
+  cout << "prev_prime() and next_prime() mixed";
+  check(true);
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,148 @@
+///
+/// @file   prime_bitmap1.cpp
+/// @brief  The numbers < 2^20 are answered using PrimeBitmap.
+///         Compare is_prime(), count_primes(), count_twins(),
+///         nth_prime() and primesieve::iterator with a simple
+///         sieve of Eratosthenes.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+int main()
+{
+  uint64_t max = 1 << 20;
+  uint64_t limit = max + 10000;
+  vector<char> isPrime(limit + 1, 1);
+  isPrime[0] = isPrime[1] = 0;
+
+  for (uint64_t i = 2; i * i <= limit; i++)
+    if (isPrime[i])
+      for (uint64_t j = i * i; j <= limit; j += i)
+        isPrime[j] = 0;
+
+  vector<uint64_t> primes;
+  for (uint64_t n = 0; n <= limit; n++)
+    if (isPrime[n])
+      primes.push_back(n);
+
+  bool OK = true;
+  for (uint64_t n = 0; n <= limit; n++)
+    OK &= (is_prime(n) == (isPrime[n] != 0));
+
+  cout << "is_prime(n) for n <= " << limit;
+  check(OK);
+
+  OK = true;
+  uint64_t count = 0;
+  for (uint64_t n = 0; n <= limit; n++)
+  {
+    count += isPrime[n];
+    if (n % 997 == 0 || (n + 10 >= max && n < max + 10))
+      OK &= (count_primes(0, n) == count);
+  }
+
+  cout << "count_primes(0, n) for n <= " << limit;
+  check(OK);
+
+  OK = true;
+  for (uint64_t start = 0; start < max; start += 9973)
+  {
+    for (uint64_t dist : { 0, 1, 30, 31, 1000, 100000, 1000000 })
+    {
+      uint64_t stop = start + dist;
+      if (stop > limit)
+        continue;
+
+      uint64_t res = 0;
+      for (uint64_t n = start; n <= stop; n++)
+        res += isPrime[n];
+
+      OK &= (count_primes(start, stop) == res);
+    }
+  }
+
+  cout << "count_primes(start, stop) for stop <= " << limit;
+  check(OK);
+
+  OK = true;
+  for (uint64_t start = 0; start < max; start += 99991)
+  {
+    uint64_t stop = max - 1;
+    uint64_t res = 0;
+    for (uint64_t n = start; n + 2 <= stop; n++)
+      res += isPrime[n] && isPrime[n + 2];
+
+    OK &= (count_twins(start, stop) == res);
+  }
+
+  cout << "count_twins(start, 2^20 - 1)";
+  check(OK);
+
+  OK = true;
+  for (size_t i = 0; i < primes.size(); i++)
+    OK &= (nth_prime(i + 1) == primes[i]);
+
+  cout << "nth_prime(n) for n <= " << primes.size();
+  check(OK);
+
+  OK = true;
+  for (uint64_t start = 0; start < max; start += 12345)
+  {
+    // first prime > start, >= start and < start
+    size_t i = 0;
+    while (primes[i] <= start)
+      i++;
+
+    OK &= (nth_prime(1, start) == primes[i]);
+    OK &= (nth_prime(100, start) == primes[i + 99]);
+    OK &= (nth_prime(0, start) == (isPrime[start] ? start : primes[i]));
+
+    if (i >= 100 && !isPrime[start])
+      OK &= (nth_prime(-100, start) == primes[i - 100]);
+  }
+
+  cout << "nth_prime(n, start) for start < 2^20";
+  check(OK);
+
+  OK = true;
+  primesieve::iterator it;
+  for (uint64_t prime : primes)
+    OK &= (it.next_prime() == prime);
+
+  it.skipto(max - 1000);
+  for (uint64_t prime : primes)
+    if (prime > max - 1000)
+      OK &= (it.next_prime() == prime);
+
+  it.skipto(limit);
+  for (size_t i = primes.size(); i-- > 0;)
+    OK &= (it.prev_prime() == primes[i]);
+
+  cout << "iterator next_prime() and prev_prime() <= " << limit;
+  check(OK);
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,85 @@
+///
+/// @file   prime_count_approx1.cpp
+/// @brief  Test prime_count_approx(start, stop), it must be an
+///         upper bound for the number of primes inside
+///         [start, stop] that is at most 2% (+ 200) too large.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+void check(uint64_t start, uint64_t stop, uint64_t count)
+{
+  uint64_t approx = prime_count_approx(start, stop);
+  cout << "prime_count_approx(" << start << ", " << stop << ") = " << approx;
+  // Small counts use the cheap bound
+  uint64_t maxError = (approx < (1 << 12)) ? count / 4 + 10 : count / 50 + 200;
+  check(approx >= count &&
+        approx <= count + maxError);
+}
+
+int main()
+{
+  // pi(10^k)
+  vector<uint64_t> pix =
+  {
+    4, 25, 168, 1229, 9592, 78498, 664579, 5761455, 50847534,
+    455052511, 4118054813ull, 37607912018ull, 346065536839ull,
+    3204941750802ull, 29844570422669ull, 279238341033925ull,
+    2623557157654233ull, 24739954287740860ull,
+    234057667276344607ull
+  };
+
+  uint64_t x = 10;
+  for (size_t i = 0; i < pix.size(); i++, x *= 10)
+    check(0, x, pix[i]);
+
+  // small intervals
+  for (uint64_t start = 1; start <= 100000; start = start * 3 + 7)
+    for (uint64_t dist = 0; dist < 1000000; dist = dist * 5 + 11)
+      check(start, start + dist, count_primes(start, start + dist));
+
+  // intervals near 2^64
+  uint64_t max = get_max_stop();
+  check(max - 10000000, max, count_primes(max - 10000000, max));
+  check(1000000000000000000ull, 1000000000010000000ull,
+        count_primes(1000000000000000000ull, 1000000000010000000ull));
+
+  set_exact_reserve(true);
+  cout << "is_exact_reserve() = " << is_exact_reserve();
+  check(is_exact_reserve());
+
+  vector<uint64_t> primes;
+  generate_primes(1000000000, 1100000000, &primes);
+  cout << "primes.capacity() = " << primes.capacity();
+  check(primes.size() == count_primes(1000000000, 1100000000) &&
+        primes.capacity() == primes.size());
+
+  set_exact_reserve(false);
+  cout << "is_exact_reserve() = " << is_exact_reserve();
+  check(!is_exact_reserve());
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,64 @@
+///
+/// @file   primes_range1.cpp
+/// @brief  Test primesieve::primes(start, stop) using a
+///         range-based for loop and STL algorithms.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+void test(uint64_t start, uint64_t stop)
+{
+  vector<uint64_t> primes1;
+  vector<uint64_t> primes2;
+  generate_primes(start, stop, &primes1);
+
+  for (uint64_t prime : primes(start, stop))
+    primes2.push_back(prime);
+
+  cout << "primes(" << start << ", " << stop << ") = " << primes2.size();
+  check(primes1 == primes2);
+}
+
+int main()
+{
+  test(0, 0);
+  test(0, 1);
+  test(0, 2);
+  test(2, 2);
+  test(3, 100);
+  test(100, 3);
+  test(0, 100000000);
+  test(1000000000000ull, 1000000000000ull + 10000000);
+  test(get_max_stop() - 1000, get_max_stop());
+
+  auto range = primes(0, 1000000);
+  uint64_t sum = accumulate(range.begin(), range.end(), (uint64_t) 0);
+  cout << "Sum of the primes <= 10^6 = " << sum;
+  check(sum == 37550402023ull);
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
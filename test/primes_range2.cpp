@@ -0,0 +1,112 @@
+///
+/// @file   primes_range2.cpp
+/// @brief  Test primesieve::primes(start, stop) in C++20
+///         ranges pipelines and primesieve::segments().
+///         This test is compiled using C++20 if the
+///         compiler supports it.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#if defined(__has_include)
+  #if __has_include(<version>)
+    #include <version>
+  #endif
+#endif
+
+#if defined(__cpp_lib_ranges)
+  #include <ranges>
+#endif
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+int main()
+{
+  uint64_t start = (uint64_t) 1e10;
+  uint64_t stop = start + (uint64_t) 1e8;
+
+#if defined(__cpp_lib_ranges)
+  static_assert(std::ranges::input_range<primes_range>);
+
+  vector<uint64_t> primes1;
+  vector<uint64_t> primes2;
+  generate_primes(start, stop, &primes1);
+
+  auto mod4 = primes(start, stop)
+            | std::views::filter([](uint64_t p) { return p % 4 == 1; })
+            | std::views::transform([](uint64_t p) { return p * 2; });
+
+  for (uint64_t n : mod4)
+    primes2.push_back(n / 2);
+
+  uint64_t count = 0;
+  for (uint64_t p : primes1)
+    count += (p % 4 == 1);
+
+  cout << "primes(" << start << ", " << stop << ") | filter | transform = " << primes2.size();
+  check(primes2.size() == count &&
+        std::ranges::all_of(primes2, [](uint64_t p) { return p % 4 == 1; }));
+
+  vector<uint64_t> primes3;
+  for (uint64_t p : primes(start, stop) | std::views::take(10))
+    primes3.push_back(p);
+
+  cout << "primes(" << start << ", " << stop << ") | take(10)";
+  check(equal(primes3.begin(), primes3.end(), primes1.begin()) && primes3.size() == 10);
+#else
+  cout << "C++20 ranges not supported, skipping ranges tests" << endl;
+#endif
+
+#if defined(PRIMESIEVE_COROUTINES)
+  uint64_t blocks = 0;
+  uint64_t count2 = 0;
+  uint64_t sum1 = 0;
+  uint64_t sum2 = 0;
+
+  for (auto span : segments(start, stop))
+  {
+    blocks++;
+    count2 += span.size();
+    for (uint64_t p : span)
+      sum2 += p;
+  }
+
+  for (uint64_t p : primes(start, stop))
+    sum1 += p;
+
+  cout << "segments(" << start << ", " << stop << ") blocks = " << blocks;
+  check(count2 == count_primes(start, stop) && sum1 == sum2);
+
+  count2 = 0;
+  for (auto span : segments(0, 10))
+    count2 += span.size();
+
+  cout << "segments(0, 10) count = " << count2;
+  check(count2 == 4);
+#else
+  cout << "C++20 coroutines not supported, skipping segments() tests" << endl;
+#endif
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
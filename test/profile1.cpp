@@ -0,0 +1,133 @@
+///
+/// @file   profile1.cpp
+/// @brief  Test primesieve::set_profile(). Sieving using the
+///         settings of a tuning profile must generate the
+///         same results as sieving using the defaults.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+/// Small, medium and large sieving primes
+vector<uint64_t> sieve()
+{
+  vector<uint64_t> res;
+  vector<uint64_t> starts = { 10000000000ull, 100000000000000ull, 1000000000000000000ull };
+
+  for (uint64_t start : starts)
+  {
+    res.push_back(count_primes(start, start + 100000000));
+    res.push_back(count_twins(start, start + 100000000));
+    res.push_back(nth_prime(1000, start));
+  }
+
+  return res;
+}
+
+void writeProfile(const string& filename, const string& text)
+{
+  ofstream file(filename);
+  file << text;
+}
+
+bool isInvalid(const string& filename)
+{
+  try
+  {
+    set_profile(filename);
+    return false;
+  }
+  catch (exception&)
+  {
+    return true;
+  }
+}
+
+int main()
+{
+  string filename = "profile1.tmp";
+
+  set_profile("");
+  vector<uint64_t> res1 = sieve();
+
+  writeProfile(filename,
+    "# comment\n"
+    "sieve_size = 64\n"
+    "threads = 1\n"
+    "bucket_bytes = 2048\n"
+    "factor_erat_small = 0.2\n"
+    "factor_erat_medium = 2 # comment\n"
+    "unknown_setting = 1\n");
+
+  set_profile(filename);
+  cout << "get_sieve_size() = " << get_sieve_size();
+  check(get_sieve_size() == 64);
+  cout << "get_num_threads() = " << get_num_threads();
+  check(get_num_threads() == 1);
+
+  vector<uint64_t> res2 = sieve();
+  cout << "Results using profile 1 = defaults";
+  check(res1 == res2);
+
+  // Extreme settings
+  writeProfile(filename,
+    "sieve_size = 8\n"
+    "bucket_bytes = 1024\n"
+    "factor_erat_small = 3\n"
+    "factor_erat_medium = 9\n");
+
+  set_profile(filename);
+  cout << "get_sieve_size() = " << get_sieve_size();
+  check(get_sieve_size() == 8);
+
+  res2 = sieve();
+  cout << "Results using profile 2 = defaults";
+  check(res1 == res2);
+
+  // The API settings take precedence
+  set_sieve_size(128);
+  cout << "set_sieve_size(128), get_sieve_size() = " << get_sieve_size();
+  check(get_sieve_size() == 128);
+
+  writeProfile(filename, "sieve_size = abc\n");
+  cout << "Invalid profile";
+  check(isInvalid(filename));
+
+  writeProfile(filename, "sieve_size\n");
+  cout << "Invalid profile";
+  check(isInvalid(filename));
+
+  remove(filename.c_str());
+  cout << "Missing profile";
+  check(isInvalid(filename));
+
+  set_profile("");
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,85 @@
+///
+/// @file   profile2.cpp
+/// @brief  An invalid default profile must not break sieving,
+///         libprimesieve falls back to the built-in defaults.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+void setEnv(const string& name, const string& value)
+{
+#if defined(_WIN32)
+  _putenv_s(name.c_str(), value.c_str());
+#else
+  setenv(name.c_str(), value.c_str(), 1);
+#endif
+}
+
+int main()
+{
+  string filename = "profile2.tmp";
+
+  {
+    ofstream file(filename);
+    file << "sieve_size = abc\n";
+  }
+
+  // Must be set before libprimesieve
+  // reads the profile on first use.
+  setEnv("PRIMESIEVE_PROFILE", filename);
+
+  for (int i = 0; i < 2; i++)
+  {
+    try
+    {
+      uint64_t count = count_primes(0, 100000000);
+      cout << "count_primes(0, 1e8) using invalid profile = " << count;
+      check(count == 5761455);
+    }
+    catch (exception& e)
+    {
+      cout << "count_primes(0, 1e8) using invalid profile: " << e.what();
+      check(false);
+    }
+  }
+
+  cout << "get_num_threads() = " << get_num_threads();
+  check(get_num_threads() >= 1);
+
+  // The explicit set_profile() still throws
+  bool isError = false;
+  try { set_profile(filename); }
+  catch (primesieve_error&) { isError = true; }
+  cout << "set_profile(invalid profile) throws";
+  check(isError);
+
+  remove(filename.c_str());
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
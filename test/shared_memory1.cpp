@@ -0,0 +1,104 @@
+///
+/// @file   shared_memory1.cpp
+/// @brief  Test primesieve::set_shared_memory(). The first process
+///         creates the shared memory segments, the other processes
+///         map them. Both must generate the same primes as
+///         sieving using private memory.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#if !defined(_WIN32)
+  #include <sys/wait.h>
+  #include <unistd.h>
+#endif
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+struct Result
+{
+  uint64_t count;
+  uint64_t nthPrime;
+  vector<uint64_t> prevPrimes;
+};
+
+Result sieve(uint64_t start)
+{
+  Result res;
+  res.count = count_primes(start, start + 100000000);
+  res.nthPrime = nth_prime(1000, start);
+
+  primesieve::iterator it(start);
+  for (int i = 0; i < 10000; i++)
+    res.prevPrimes.push_back(it.prev_prime());
+
+  return res;
+}
+
+bool operator==(const Result& a, const Result& b)
+{
+  return a.count == b.count &&
+         a.nthPrime == b.nthPrime &&
+         a.prevPrimes == b.prevPrimes;
+}
+
+int main()
+{
+  vector<uint64_t> starts = { 1000000, 10000000000000ull, 1000000000000000ull };
+  remove_shared_memory();
+
+#if !defined(_WIN32)
+  // The child process creates the shared memory segments
+  pid_t pid = fork();
+
+  if (pid == 0)
+  {
+    set_shared_memory(true);
+    for (uint64_t start : starts)
+      sieve(start);
+    _exit(0);
+  }
+
+  int status = 1;
+  waitpid(pid, &status, 0);
+  cout << "Create shared memory in child process";
+  check(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+#endif
+
+  for (uint64_t start : starts)
+  {
+    set_shared_memory(false);
+    Result res1 = sieve(start);
+    set_shared_memory(true);
+    Result res2 = sieve(start);
+
+    cout << "count_primes(" << start << ", " << start + 100000000 << ") = " << res2.count;
+    check(res1 == res2);
+  }
+
+  set_shared_memory(false);
+  remove_shared_memory();
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
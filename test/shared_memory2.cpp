@@ -0,0 +1,120 @@
+///
+/// @file   shared_memory2.cpp
+/// @brief  Test that a shared memory segment whose creator died
+///         before setting its size or its pid is deleted, so
+///         that the next run can recreate the segment.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/ShmSegment.hpp>
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#if !defined(_WIN32)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+const string name = "test-stale";
+const size_t maxSize = 1000;
+
+/// Counts the calls
+int fills = 0;
+
+size_t fillData(uint8_t* data, size_t)
+{
+  fills++;
+  for (size_t i = 0; i < maxSize; i++)
+    data[i] = (uint8_t) i;
+  return maxSize;
+}
+
+bool isFilled(const shared_ptr<const ShmSegment>& shm)
+{
+  if (!shm || shm->getSize() != maxSize)
+    return false;
+
+  const uint8_t* data = shm->getData();
+  for (size_t i = 0; i < maxSize; i++)
+    if (data[i] != (uint8_t) i)
+      return false;
+
+  return true;
+}
+
+/// Segment of a creator that died after shm_open(),
+/// @size: Size set using ftruncate() (0 = none)
+///
+void createStale(off_t size)
+{
+#if !defined(_WIN32)
+  string shmName = "/primesieve-v1-" + name;
+  int fd = shm_open(shmName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd != -1)
+  {
+    if (size)
+      (void) ftruncate(fd, size);
+    close(fd);
+  }
+#else
+  (void) size;
+#endif
+}
+
+int main()
+{
+#if !defined(_WIN32)
+  ShmSegment::enable(true);
+  ShmSegment::remove(name);
+
+  // Creator died before ftruncate()
+  createStale(0);
+  auto shm = ShmSegment::get(name, maxSize, fillData);
+  cout << "ShmSegment::get() of segment without size = nullptr";
+  check(!shm && fills == 0);
+
+  shm = ShmSegment::get(name, maxSize, fillData);
+  cout << "ShmSegment::get() recreates the segment";
+  check(isFilled(shm) && fills == 1);
+  shm.reset();
+  ShmSegment::remove(name);
+
+  // Creator died before writing its pid
+  createStale(64 + maxSize);
+  shm = ShmSegment::get(name, maxSize, fillData);
+  cout << "ShmSegment::get() of segment without pid = nullptr";
+  check(!shm && fills == 1);
+
+  shm = ShmSegment::get(name, maxSize, fillData);
+  cout << "ShmSegment::get() recreates the segment";
+  check(isFilled(shm) && fills == 2);
+  shm.reset();
+  ShmSegment::remove(name);
+
+  ShmSegment::enable(false);
+#endif
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
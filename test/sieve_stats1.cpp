@@ -0,0 +1,86 @@
+///
+/// @file   sieve_stats1.cpp
+/// @brief  Test primesieve::get_sieve_stats(). If primesieve
+///         has been built without -DENABLE_STATS=ON all
+///         statistics must be 0.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+double total(const sieve_stats& stats)
+{
+  return stats.pre_sieve +
+         stats.erat_small +
+         stats.erat_medium +
+         stats.erat_big +
+         stats.sieving_primes +
+         stats.count +
+         stats.print;
+}
+
+int main()
+{
+  bool enabled = is_sieve_stats_enabled();
+  cout << "is_sieve_stats_enabled() = " << enabled << endl;
+
+  reset_sieve_stats();
+  sieve_stats stats = get_sieve_stats();
+  cout << "reset_sieve_stats() segments = " << stats.segments;
+  check(stats.segments == 0 && total(stats) == 0);
+
+  set_num_threads(2);
+  uint64_t count = count_primes(1e12, 1e12 + 1e9);
+  cout << "count_primes(1e12, 1e12 + 1e9) = " << count;
+  check(count == 36190991);
+
+  stats = get_sieve_stats();
+  cout << "segments = " << stats.segments;
+  check(enabled ? stats.segments > 0 : stats.segments == 0);
+
+  cout << "erat_small = " << stats.erat_small;
+  check(enabled ? stats.erat_small > 0 : stats.erat_small == 0);
+
+  cout << "erat_medium = " << stats.erat_medium;
+  check(enabled ? stats.erat_medium > 0 : stats.erat_medium == 0);
+
+  cout << "count = " << stats.count;
+  check(enabled ? stats.count > 0 : stats.count == 0);
+
+  cout << "print = " << stats.print;
+  check(stats.print == 0);
+
+  uint64_t segments = stats.segments;
+  count_twins(1e9, 2e9);
+  stats = get_sieve_stats();
+  cout << "count_twins(1e9, 2e9) segments = " << stats.segments;
+  check(enabled ? stats.segments > segments : stats.segments == 0);
+
+  reset_sieve_stats();
+  stats = get_sieve_stats();
+  cout << "reset_sieve_stats() segments = " << stats.segments;
+  check(stats.segments == 0 && total(stats) == 0);
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,121 @@
+///
+/// @file   sieving_primes_cache1.cpp
+/// @brief  Test primesieve::build_sieving_primes_cache() and
+///         set_sieving_primes_cache(). Sieving with the cache
+///         file must generate the same primes as sieving
+///         without the cache file.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+struct Result
+{
+  uint64_t count;
+  uint64_t nthPrime;
+  vector<uint64_t> primes;
+  vector<uint64_t> prevPrimes;
+};
+
+Result sieve(uint64_t start)
+{
+  Result res;
+  res.count = count_primes(start, start + 100000000);
+  res.nthPrime = nth_prime(1000, start);
+  generate_n_primes(10000, start, &res.primes);
+
+  primesieve::iterator it(start);
+  for (int i = 0; i < 10000; i++)
+    res.prevPrimes.push_back(it.prev_prime());
+
+  return res;
+}
+
+bool operator==(const Result& a, const Result& b)
+{
+  return a.count == b.count &&
+         a.nthPrime == b.nthPrime &&
+         a.primes == b.primes &&
+         a.prevPrimes == b.prevPrimes;
+}
+
+int main()
+{
+  string filename = "sieving_primes_cache1.tmp";
+  build_sieving_primes_cache(filename, 10000000);
+
+  // sqrt(10^13) <= 10^7 uses the cache,
+  // sqrt(10^15) > 10^7 does not use the cache
+  vector<uint64_t> starts = { 10000000000000ull, 99999000000000ull, 1000000000000000ull };
+
+  for (uint64_t start : starts)
+  {
+    set_sieving_primes_cache("");
+    Result res1 = sieve(start);
+    set_sieving_primes_cache(filename);
+    Result res2 = sieve(start);
+
+    cout << "count_primes(" << start << ", " << start + 100000000 << ") = " << res2.count;
+    check(res1 == res2);
+  }
+
+  set_sieving_primes_cache("");
+
+  {
+    ofstream file(filename, ios::binary | ios::trunc);
+    file << "invalid sieving primes cache";
+  }
+
+  try
+  {
+    set_sieving_primes_cache(filename);
+    cout << "set_sieving_primes_cache(invalid file)";
+    check(false);
+  }
+  catch (primesieve_error& e)
+  {
+    cout << "set_sieving_primes_cache(invalid file): " << e.what();
+    check(true);
+  }
+
+  remove(filename.c_str());
+
+  try
+  {
+    set_sieving_primes_cache(filename);
+    cout << "set_sieving_primes_cache(missing file)";
+    check(false);
+  }
+  catch (primesieve_error& e)
+  {
+    cout << "set_sieving_primes_cache(missing file): " << e.what();
+    check(true);
+  }
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,168 @@
+///
+/// @file   skipto1.cpp
+/// @brief  Test skipto() of primesieve::iterator to numbers
+///         inside the buffered primes, slightly ahead of them
+///         and far away, followed by next_prime(), prev_prime(),
+///         next_primes() and prev_primes().
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+vector<uint64_t> primes;
+
+/// Index of the first prime > n
+size_t nextIdx(uint64_t n)
+{
+  return upper_bound(primes.begin(), primes.end(), n) - primes.begin();
+}
+
+/// Index of the first prime >= n
+size_t prevIdx(uint64_t n)
+{
+  return lower_bound(primes.begin(), primes.end(), n) - primes.begin();
+}
+
+void checkNext(primesieve::iterator& it, uint64_t n, uint64_t steps)
+{
+  size_t i = nextIdx(n);
+
+  for (uint64_t k = 0; k < steps; k++, i++)
+    if (it.next_prime() != primes[i])
+    {
+      cout << "skipto(" << n << ") next_prime()";
+      check(false);
+    }
+}
+
+void checkPrev(primesieve::iterator& it, uint64_t n, uint64_t steps)
+{
+  size_t i = prevIdx(n);
+
+  for (uint64_t k = 0; k < steps; k++)
+    if (it.prev_prime() != primes[--i])
+    {
+      cout << "skipto(" << n << ") prev_prime()";
+      check(false);
+    }
+}
+
+int main()
+{
+  uint64_t low = (uint64_t) 1e10;
+  uint64_t high = low + (uint64_t) 3e7;
+  primesieve::generate_primes(low, high, &primes);
+
+  primesieve::iterator it;
+
+  // small numbers
+  for (uint64_t n = 0; n < 1000; n++)
+  {
+    it.skipto(n);
+    uint64_t prime = it.next_prime();
+    it.skipto(n + 1);
+    uint64_t prime2 = it.prev_prime();
+    it.skipto(n + 1);
+    uint64_t prime3 = it.prev_prime();
+    it.skipto(n);
+
+    if (prime != primesieve::nth_prime(1, n) ||
+        prime2 != prime3 ||
+        it.next_prime() != prime)
+    {
+      cout << "skipto(" << n << ")";
+      check(false);
+    }
+  }
+
+  cout << "skipto(n) with n < 1000";
+  check(true);
+
+  uint64_t n = low + (uint64_t) 1e7;
+  uint64_t seed = 1;
+
+  for (int j = 0; j < 20000; j++)
+  {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    uint64_t r = seed >> 33;
+    int64_t dist;
+
+    // mostly nearby numbers, sometimes far away
+    switch (r % 8)
+    {
+      case 0:  dist = (int64_t) ((r >> 3) % 20000000); break;
+      case 1:  dist = (int64_t) ((r >> 3) % 1000000); break;
+      case 2:  dist = -(int64_t) ((r >> 3) % 100000); break;
+      case 3:  dist = -(int64_t) ((r >> 3) % 1000); break;
+      default: dist = (int64_t) ((r >> 3) % 10000); break;
+    }
+
+    n += dist;
+    if (n < low + 1000000 || n > high - 1000000)
+      n = low + 1000000 + (r % (high - low - 2000000));
+
+    // the sieve array uses 30 numbers per byte
+    if ((r >> 10) % 2)
+      n -= n % 30;
+
+    it.skipto(n);
+    uint64_t steps = (r >> 20) % 200;
+
+    switch ((r >> 30) % 4)
+    {
+      case 0: checkNext(it, n, steps); break;
+      case 1: checkPrev(it, n, steps); break;
+      case 2:
+      {
+        size_t size;
+        const uint64_t* block = it.next_primes(&size);
+        size_t i = nextIdx(n);
+        for (size_t k = 0; k < size; k++)
+          if (block[k] != primes[i + k])
+            check(false);
+        if (it.next_prime() != primes[i + size])
+          check(false);
+        break;
+      }
+      default:
+      {
+        size_t size;
+        const uint64_t* block = it.prev_primes(&size);
+        size_t i = prevIdx(n) - size;
+        for (size_t k = 0; k < size; k++)
+          if (block[k] != primes[i + k])
+            check(false);
+        if (it.prev_prime() != primes[i - 1])
+          check(false);
+        break;
+      }
+    }
+  }
+
+  cout << "skipto() to random nearby numbers";
+  check(true);
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,121 @@
+///
+/// @file   skipto2.c
+/// @brief  Test primesieve_skipto() to numbers inside the
+///         buffered primes, slightly ahead of them and far
+///         away, followed by primesieve_next_prime() and
+///         primesieve_prev_prime().
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void check(int OK)
+{
+  if (OK)
+    printf("   OK\n");
+  else
+  {
+    printf("   ERROR\n");
+    exit(1);
+  }
+}
+
+uint64_t* primes;
+size_t size;
+
+/// Index of the first prime > n
+size_t nextIdx(uint64_t n)
+{
+  size_t first = 0;
+  size_t last = size;
+
+  while (first < last)
+  {
+    size_t mid = first + (last - first) / 2;
+    if (primes[mid] <= n)
+      first = mid + 1;
+    else
+      last = mid;
+  }
+
+  return first;
+}
+
+int main()
+{
+  uint64_t low = (uint64_t) 1e10;
+  uint64_t high = low + (uint64_t) 1e7;
+  uint64_t n = low + (uint64_t) 5e6;
+  uint64_t seed = 1;
+  int j;
+
+  primes = (uint64_t*) primesieve_generate_primes(low, high, &size, UINT64_PRIMES);
+  primesieve_iterator it;
+  primesieve_init(&it);
+
+  for (j = 0; j < 5000; j++)
+  {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    uint64_t r = seed >> 33;
+    uint64_t steps = (r >> 20) % 100;
+    uint64_t k;
+
+    // walk forward and backward by small distances
+    if (r % 4 == 0)
+      n -= (r >> 3) % 1000;
+    else
+      n += (r >> 3) % 10000;
+
+    if (n < low + 1000000 || n > high - 1000000)
+      n = low + 1000000 + r % (high - low - 2000000);
+
+    if ((r >> 10) % 2)
+      n -= n % 30;
+
+    primesieve_skipto(&it, n, high);
+    size_t i = nextIdx(n);
+
+    if ((r >> 30) % 2)
+    {
+      for (k = 0; k < steps; k++, i++)
+        if (primesieve_next_prime(&it) != primes[i])
+        {
+          printf("primesieve_skipto(%" PRIu64 ") next_prime", n);
+          check(0);
+        }
+    }
+    else
+    {
+      // first prime >= n
+      if (i > 0 && primes[i - 1] == n)
+        i--;
+
+      for (k = 0; k < steps; k++)
+        if (primesieve_prev_prime(&it) != primes[--i])
+        {
+          printf("primesieve_skipto(%" PRIu64 ") prev_prime", n);
+          check(0);
+        }
+    }
+  }
+
+  printf("primesieve_skipto() to random nearby numbers");
+  check(1);
+
+  primesieve_free_iterator(&it);
+  primesieve_free(primes);
+
+  printf("\n");
+  printf("All tests passed successfully!\n");
+
+  return 0;
+}
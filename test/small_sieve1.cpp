@@ -0,0 +1,126 @@
+///
+/// @file   small_sieve1.cpp
+/// @brief  Counting inside small intervals < 2^32 uses SmallSieve.
+///         Compare its counts with the counts of large intervals
+///         (sieved using Erat), check that it does no heap
+///         allocation and print its latency per query.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+using namespace std;
+using namespace primesieve;
+
+uint64_t allocations = 0;
+
+void* operator new(size_t size)
+{
+  allocations++;
+  void* ptr = malloc(size ? size : 1);
+  if (!ptr)
+    throw bad_alloc();
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+  free(ptr);
+}
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+uint64_t count(int i, uint64_t start, uint64_t stop)
+{
+  switch (i)
+  {
+    case 0:  return count_primes(start, stop);
+    case 1:  return count_twins(start, stop);
+    case 2:  return count_triplets(start, stop);
+    case 3:  return count_quadruplets(start, stop);
+    case 4:  return count_quintuplets(start, stop);
+    default: return count_sextuplets(start, stop);
+  }
+}
+
+int main()
+{
+  // Larger than SmallSieve
+  uint64_t large = 3000000;
+  uint64_t starts[] = { 0, 1, 5, 7, 8, 31, 1000, 123456789, 4294967296ull - 2000000 };
+  uint64_t dists[] = { 0, 1, 29, 30, 31, 1000, 100000, 122000, 123000 };
+
+  for (uint64_t start : starts)
+  {
+    for (uint64_t dist : dists)
+    {
+      uint64_t stop = start + dist;
+
+      for (int i = 0; i < 6; i++)
+      {
+        // Prime k-tuplets cannot be split at n % 30 == 2
+        if (i > 0)
+          stop = start + dist - (start + dist) % 30 + 2;
+        if (stop < start)
+          continue;
+
+        uint64_t res1 = count(i, start, stop);
+        uint64_t res2 = count(i, start, stop + large) -
+                        count(i, stop + 1, stop + large);
+
+        cout << "count(" << i << ", " << start << ", " << stop << ") = " << res1;
+        check(res1 == res2);
+      }
+    }
+  }
+
+  // warm up using a query like those below (stop >= 2^20), the
+  // prime bitmap and SmallSieve's pre-sieved pattern are
+  // generated on first use.
+  count_primes(4000000000ull, 4000000000ull + 100000);
+  uint64_t old = allocations;
+  uint64_t sum = 0;
+  int queries = 1000;
+  auto t1 = chrono::steady_clock::now();
+
+  for (int i = 0; i < queries; i++)
+    sum += count_primes(4000000000ull + i * 100000ull, 4000000000ull + i * 100000ull + 100000);
+
+  auto t2 = chrono::steady_clock::now();
+  chrono::duration<double> secs = t2 - t1;
+  uint64_t queryAllocations = allocations - old;
+
+  cout << "Latency per query (dist = 10^5): " << secs.count() / queries * 1e6 << " us" << endl;
+  cout << "Sum = " << sum;
+  check(sum == count_primes(4000000000ull, 4000000000ull + queries * 100000ull));
+
+#if !defined(_WIN32)
+  cout << "Heap allocations = " << queryAllocations;
+  check(queryAllocations == 0);
+#endif
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,125 @@
+///
+/// @file   trace1.cpp
+/// @brief  Test the Chrome trace export of primesieve::Trace.
+///         The trace must contain the chunks, segments and
+///         sieving primes events of count_primes() and no
+///         events if tracing is disabled.
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/Trace.hpp>
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+string readFile(const string& filename)
+{
+  ifstream file(filename);
+  stringstream text;
+  text << file.rdbuf();
+  return text.str();
+}
+
+uint64_t countEvents(const string& text, const string& name)
+{
+  string pattern = "{\"name\": \"" + name + "\"";
+  uint64_t count = 0;
+
+  for (size_t pos = text.find(pattern); pos != string::npos;
+       pos = text.find(pattern, pos + 1))
+    count++;
+
+  return count;
+}
+
+int main()
+{
+  string filename = "trace1.tmp";
+
+  cout << "Trace::isEnabled() = " << Trace::isEnabled();
+  check(!Trace::isEnabled());
+
+  Trace::start();
+  cout << "Trace::start(), Trace::isEnabled() = " << Trace::isEnabled();
+  check(Trace::isEnabled());
+
+  // 1 MiB sieve size = 31457280 numbers per segment
+  set_sieve_size(1024);
+  uint64_t count = count_primes(0, 1000000000);
+  cout << "count_primes(0, 1e9) = " << count;
+  check(count == 50847534);
+
+  Trace::stop();
+  cout << "Trace::stop(), Trace::isEnabled() = " << Trace::isEnabled();
+  check(!Trace::isEnabled());
+
+  // Not recorded
+  count_primes(0, 1000000000);
+
+  Trace::write(filename);
+  string text = readFile(filename);
+
+  cout << "Trace starts with {\"displayTimeUnit\"";
+  check(text.find("{\"displayTimeUnit\"") == 0);
+
+  cout << "Trace ends with ]}";
+  check(text.rfind("]}") == text.size() - 3);
+
+  uint64_t segments = countEvents(text, "segment");
+  cout << "segment events = " << segments;
+  // Each thread chunk starts a new segment
+  check(segments >= 1000000000 / 31457280 + 1);
+
+  uint64_t sievingPrimes = countEvents(text, "sieving_primes");
+  cout << "sieving_primes events = " << sievingPrimes;
+  check(sievingPrimes == segments);
+
+  uint64_t chunks = countEvents(text, "chunk");
+  cout << "chunk events = " << chunks;
+  check(chunks >= 1);
+
+  uint64_t sieves = countEvents(text, "sieve");
+  cout << "sieve events = " << sieves;
+  check(sieves == 1);
+
+  cout << "main thread name";
+  check(text.find("\"args\": {\"name\": \"main\"}") != string::npos);
+
+  cout << "Trace::getDropped() = " << Trace::getDropped();
+  check(Trace::getDropped() == 0);
+
+  // Trace::start() discards the old events
+  Trace::start();
+  Trace::stop();
+  Trace::write(filename);
+  text = readFile(filename);
+  cout << "Trace::start(), segment events = " << countEvents(text, "segment");
+  check(countEvents(text, "segment") == 0);
+
+  remove(filename.c_str());
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,165 @@
+///
+/// @file   tuplet_iterator1.cpp
+/// @brief  Test primesieve::tuplet_iterator<k> against
+///         count_twins(), ..., count_sextuplets() and
+///         against the consecutive primes of
+///         generate_primes().
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace primesieve;
+
+void check(bool OK)
+{
+  cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    exit(1);
+}
+
+uint64_t count_tuplets(int k, uint64_t start, uint64_t stop)
+{
+  switch (k)
+  {
+    case 2: return count_twins(start, stop);
+    case 3: return count_triplets(start, stop);
+    case 4: return count_quadruplets(start, stop);
+    case 5: return count_quintuplets(start, stop);
+    default: return count_sextuplets(start, stop);
+  }
+}
+
+/// Count the k-tuplets inside ]start, stop] and check
+/// that the primes of each k-tuplet are consecutive
+/// primes whose span is the k-tuplet's diameter.
+///
+template <int K>
+void test(uint64_t start, uint64_t stop)
+{
+  const uint64_t diameter[] = { 0, 0, 2, 6, 8, 12, 16 };
+
+  vector<uint64_t> primes;
+  generate_primes(start + 1, stop, &primes);
+
+  tuplet_iterator<K> it(start, stop);
+  auto t = it.next_tuplet();
+  uint64_t count = 0;
+  bool ok = true;
+
+  for (; t[K - 1] <= stop; t = it.next_tuplet())
+  {
+    auto p = lower_bound(primes.begin(), primes.end(), t[0]);
+    ok &= p + K <= primes.end();
+    ok &= t[0] > start;
+    ok &= t[K - 1] - t[0] == diameter[K];
+    for (int j = 0; ok && j < K; j++)
+      ok &= p[j] == t[j];
+    count++;
+  }
+
+  cout << "tuplet_iterator<" << K << ">(" << start << ", " << stop << ") = " << count;
+  check(ok && count == count_tuplets(K, start + 1, stop));
+}
+
+/// next_tuplets() must return the same
+/// k-tuplets as next_tuplet().
+///
+template <int K>
+void testBlocks(uint64_t start, uint64_t n)
+{
+  tuplet_iterator<K> it1(start);
+  tuplet_iterator<K> it2(start);
+  vector<uint64_t> tuplets;
+
+  while (tuplets.size() < n * K)
+  {
+    size_t size = 0;
+    const uint64_t* t = it1.next_tuplets(&size);
+    tuplets.insert(tuplets.end(), t, t + size * K);
+  }
+
+  bool ok = true;
+  for (size_t i = 0; i < tuplets.size(); i += K)
+  {
+    auto t = it2.next_tuplet();
+    for (int j = 0; j < K; j++)
+      ok &= t[j] == tuplets[i + j];
+  }
+
+  cout << "next_tuplets<" << K << ">(" << start << ") size = " << tuplets.size() / K;
+  check(ok);
+}
+
+int main()
+{
+  for (uint64_t start : { 0ull, 1ull, 3ull, 4ull, 5ull, 6ull, 10ull })
+  {
+    test<2>(start, 100000);
+    test<3>(start, 100000);
+    test<4>(start, 100000);
+    test<5>(start, 100000);
+    test<6>(start, 100000);
+  }
+
+  // No stop hint, the k-tuplets are generated
+  // in several intervals of increasing size.
+  for (uint64_t start : { 1000000000ull, 999999929ull, 1000000007ull })
+  {
+    uint64_t stop = start + (uint64_t) 1e8;
+    uint64_t count = 0;
+    twin_iterator it(start);
+    for (auto t = it.next_tuplet(); t[1] <= stop; t = it.next_tuplet())
+      count++;
+
+    cout << "twin_iterator(" << start << ") count = " << count;
+    check(count == count_twins(start + 1, stop));
+  }
+
+  test<2>((uint64_t) 1e12, (uint64_t) 1e12 + (uint64_t) 1e7);
+  test<3>((uint64_t) 1e15, (uint64_t) 1e15 + (uint64_t) 1e7);
+  test<4>((uint64_t) 1e18, (uint64_t) 1e18 + (uint64_t) 1e7);
+
+  testBlocks<2>(0, 100000);
+  testBlocks<3>((uint64_t) 1e10, 10000);
+  testBlocks<6>(0, 1000);
+
+  // skipto() reuses the k-tuplet generator
+  twin_iterator it;
+  for (uint64_t n : { 1000ull, 10ull, 4ull, 3ull, 1000000000000ull, 29ull })
+  {
+    it.skipto(n);
+    auto t = it.next_tuplet();
+    vector<uint64_t> primes;
+    generate_n_primes(1000, n + 1, &primes);
+    auto p = primes.begin();
+    while (p[1] - p[0] != 2)
+      p++;
+
+    cout << "skipto(" << n << ") next_tuplet = (" << t[0] << ", " << t[1] << ")";
+    check(t[0] == p[0] && t[1] == p[1]);
+  }
+
+  // Sextuplets near 2^64 (there are none)
+  tuplet_iterator<6> it6(get_max_stop() - (uint64_t) 1e7);
+  auto t6 = it6.next_tuplet();
+  cout << "tuplet_iterator<6>(2^64 - 1e7) = " << t6[0];
+  check(t6[0] == get_max_stop() && t6[5] == get_max_stop());
+
+  cout << endl;
+  cout << "All tests passed successfully!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,94 @@
+///
+/// @file   tuplet_iterator2.c
+/// @brief  Test primesieve_next_tuplet() and
+///         primesieve_next_tuplets() against
+///         primesieve_count_twins(), ...
+///
+/// Copyright (C) 2019 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void check(int OK)
+{
+  if (OK)
+    printf("   OK\n");
+  else
+  {
+    printf("   ERROR\n");
+    exit(1);
+  }
+}
+
+uint64_t count_tuplets(int k, uint64_t start, uint64_t stop)
+{
+  switch (k)
+  {
+    case 2: return primesieve_count_twins(start, stop);
+    case 3: return primesieve_count_triplets(start, stop);
+    case 4: return primesieve_count_quadruplets(start, stop);
+    case 5: return primesieve_count_quintuplets(start, stop);
+    default: return primesieve_count_sextuplets(start, stop);
+  }
+}
+
+int main()
+{
+  uint64_t start = (uint64_t) 1e9;
+  uint64_t stop = start + (uint64_t) 1e8;
+  int k;
+
+  primesieve_tuplet_iterator it;
+
+  for (k = 2; k <= 6; k++)
+  {
+    uint64_t count = 0;
+    const uint64_t* t;
+
+    primesieve_init_tuplet_iterator(&it, k);
+    primesieve_skipto_tuplet(&it, start, stop);
+
+    for (t = primesieve_next_tuplet(&it); t[k - 1] <= stop; t = primesieve_next_tuplet(&it))
+      count++;
+
+    printf("primesieve_next_tuplet(k = %d) count = %" PRIu64, k, count);
+    check(count == count_tuplets(k, start + 1, stop));
+
+    count = 0;
+    primesieve_skipto_tuplet(&it, start, stop);
+
+    while (1)
+    {
+      size_t i, size;
+      t = primesieve_next_tuplets(&it, &size);
+      for (i = 0; i < size && t[i * k + k - 1] <= stop; i++)
+        count++;
+      if (i < size)
+        break;
+    }
+
+    printf("primesieve_next_tuplets(k = %d) count = %" PRIu64, k, count);
+    check(count == count_tuplets(k, start + 1, stop));
+
+    primesieve_free_tuplet_iterator(&it);
+  }
+
+  // k = 7 is an error
+  primesieve_init_tuplet_iterator(&it, 7);
+  printf("primesieve_next_tuplet(k = 7) = %" PRIu64, primesieve_next_tuplet(&it)[0]);
+  check(primesieve_next_tuplet(&it)[0] == PRIMESIEVE_ERROR && it.is_error);
+  primesieve_free_tuplet_iterator(&it);
+
+  printf("\n");
+  printf("All tests passed successfully!\n");
+
+  return 0;
+}